@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 #include <wut.h>
 
@@ -15,16 +16,37 @@ typedef enum NotificationModuleStatus {
     NOTIFICATION_MODULE_RESULT_UNSUPPORTED_TYPE      = -0x11,
     NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED     = -0x12,
     NOTIFICATION_MODULE_RESULT_INVALID_HANDLE        = -0x13,
+    NOTIFICATION_MODULE_RESULT_QUOTA_EXCEEDED        = -0x14,
     NOTIFICATION_MODULE_RESULT_UNKNOWN_ERROR         = -0x1000,
 } NotificationModuleStatus;
 
 typedef uint32_t NotificationModuleAPIVersion;
 typedef uint32_t NotificationModuleHandle;
+typedef uint32_t NotificationModuleTextId;
+typedef uint32_t NotificationModuleTemplateId;
+typedef struct _NMCatalog *NotificationModuleCatalogHandle;
+typedef struct _NMGroup *NotificationModuleGroupHandle;
+typedef uint32_t NotificationModuleTag;
+typedef uint32_t NMScheduleHandle;
+typedef struct _NMContext *NotificationModuleContextHandle;
+typedef struct _NMProgressChannel *NotificationModuleProgressChannel;
 
 
 typedef void (*NotificationModuleNotificationFinishedCallback)(NotificationModuleHandle, void *);
+typedef double (*NotificationModuleLiveSampleCallback)(void *);
 
-#define NOTIFICATION_MODULE_API_VERSION_ERROR 0xFFFFFFFF
+#define NOTIFICATION_MODULE_API_VERSION_ERROR   0xFFFFFFFF
+#define NOTIFICATION_MODULE_TEXT_ID_INVALID     0
+#define NOTIFICATION_MODULE_TEMPLATE_ID_INVALID 0
+#define NOTIFICATION_MODULE_TAG_NONE            0
+#define NM_SCHEDULE_HANDLE_INVALID              0
+#define NM_SCHEDULE_MAX_DELAY_IN_US             (365ULL * 24 * 60 * 60 * 1000000) /* One year */
+
+#if defined(__GNUC__)
+#define NM_FORMAT_PRINTF(fmt, args) __attribute__((__format__(__printf__, fmt, args)))
+#else
+#define NM_FORMAT_PRINTF(fmt, args)
+#endif
 
 typedef struct _NMColor {
     uint8_t r, g, b, a;
@@ -48,4 +70,108 @@ typedef enum NotificationModuleNotificationOption {
     NOTIFICATION_MODULE_DEFAULT_OPTION_FINISH_FUNCTION,          /* Function that will be called when the Notification starts to fade out. Type: NotificationModuleNotificationFinishedCallback*/
     NOTIFICATION_MODULE_DEFAULT_OPTION_FINISH_FUNCTION_CONTEXT,  /* Context that will be passed to the NOTIFICATION_MODULE_DEFAULT_TYPE_FINISH_FUNCTION callback. Type: void* */
     NOTIFICATION_MODULE_DEFAULT_OPTION_KEEP_UNTIL_SHOWN,         /* Keeps the notification in memory until it was actually shown */
+    NOTIFICATION_MODULE_DEFAULT_OPTION_INACTIVITY_TIMEOUT,       /* Dynamic notifications that haven't been updated for this time (in seconds) are finished with a shake. 0 disables the timeout. Type: float */
+    NOTIFICATION_MODULE_DEFAULT_OPTION_INACTIVITY_TIMEOUT_TEXT,  /* Text that is shown when a dynamic notification is finished by the inactivity timeout. NULL keeps the last text. Type: const char* */
 } NotificationModuleNotificationOption;
+
+
+typedef enum NotificationModuleDynamicUpdateField {
+    NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_TEXT             = 1 << 0, /* NMDynamicUpdate::text will be applied */
+    NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_TEXT_COLOR       = 1 << 1, /* NMDynamicUpdate::textColor will be applied */
+    NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_BACKGROUND_COLOR = 1 << 2, /* NMDynamicUpdate::backgroundColor will be applied */
+} NotificationModuleDynamicUpdateField;
+
+#define NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_ALL (NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_TEXT | NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_TEXT_COLOR | NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_BACKGROUND_COLOR)
+
+typedef struct _NMDynamicUpdate {
+    const char *text;
+    NMColor textColor;
+    NMColor backgroundColor;
+} NMDynamicUpdate;
+
+typedef enum NotificationModuleEasing {
+    NOTIFICATION_MODULE_EASING_LINEAR      = 0, /* Constant speed */
+    NOTIFICATION_MODULE_EASING_EASE_IN     = 1, /* Starts slow, ends fast */
+    NOTIFICATION_MODULE_EASING_EASE_OUT    = 2, /* Starts fast, ends slow */
+    NOTIFICATION_MODULE_EASING_EASE_IN_OUT = 3, /* Starts and ends slow */
+    NOTIFICATION_MODULE_EASING_PULSE       = 4, /* Goes from "from" to "to" and back within the duration, repeats until stopped */
+} NotificationModuleEasing;
+
+typedef enum NotificationModuleTemplateArgType {
+    NOTIFICATION_MODULE_TEMPLATE_ARG_TYPE_INT    = 0, /* Used by %d and %i. Value: i32 */
+    NOTIFICATION_MODULE_TEMPLATE_ARG_TYPE_UINT   = 1, /* Used by %u, %x and %X. Value: u32 */
+    NOTIFICATION_MODULE_TEMPLATE_ARG_TYPE_FLOAT  = 2, /* Used by %f and %.Nf (N <= 9). Value: f */
+    NOTIFICATION_MODULE_TEMPLATE_ARG_TYPE_STRING = 3, /* Used by %s. Value: str */
+} NotificationModuleTemplateArgType;
+
+typedef struct _NMTemplateArg {
+    NotificationModuleTemplateArgType type;
+    union {
+        int32_t i32;
+        uint32_t u32;
+        float f;
+        const char *str;
+    } value;
+} NMTemplateArg;
+
+/**
+ * Describes a notification. Use NotificationModule_InitNotificationDesc() to fill it with the default values of a type.
+ */
+typedef struct _NMNotificationDesc {
+    uint32_t size;                                           /* At least NM_NOTIFICATION_DESC_SIZE_V1, set by NotificationModule_InitNotificationDesc() */
+    NotificationModuleNotificationType type;                 /* Type of the notification */
+    const char *text;                                        /* Content of the notification */
+    float durationBeforeFadeOutInSeconds;                    /* Time in seconds before the notification will fade out */
+    float shakeDurationInSeconds;                            /* Shake duration in seconds, only used for NOTIFICATION_MODULE_NOTIFICATION_TYPE_ERROR */
+    NMColor textColor;                                       /* Text color of the notification */
+    NMColor backgroundColor;                                 /* Background color of the notification */
+    NotificationModuleNotificationFinishedCallback callback; /* Function that will be called when the notification fades out, may be NULL */
+    void *callbackContext;                                   /* Context that will be passed to the callback */
+    bool keepUntilShown;                                     /* Keeps the notification in memory until it was actually shown */
+} NMNotificationDesc;
+
+/**
+ * Size of the first version of NMNotificationDesc (up to and including keepUntilShown). Descriptions that have been
+ * compiled against an older header stay valid when fields are appended: any size of at least this is accepted and
+ * fields beyond `size` take the default values of the type.
+ */
+#define NM_NOTIFICATION_DESC_SIZE_V1 (offsetof(NMNotificationDesc, keepUntilShown) + sizeof(bool))
+
+/**
+ * Limits of a notification context, see NotificationModule_CreateContext(). 0 disables a limit.
+ */
+typedef struct _NMContextQuota {
+    uint32_t maxInFlight; /* Maximum number of notifications of the context that are on the screen (or queued) at the same time */
+    float ratePerSecond;  /* Average number of notifications per second (token bucket refill rate, up to 1000) */
+    uint32_t burst;       /* Number of notifications that can be added at once before the rate limit kicks in (token bucket size) */
+} NMContextQuota;
+
+/**
+ * Fill level of the overlay, see NotificationModule_GetQueueInfo().
+ */
+typedef struct _NMQueueInfo {
+    uint32_t pending;         /* Notifications that are waiting to be shown, e.g. because the overlay is not ready */
+    uint32_t visible;         /* Notifications that are currently shown (including fading out) */
+    uint32_t bytesUsed;       /* Memory used by all pending and visible notifications */
+    uint32_t capacityInBytes; /* Memory available for notifications, adding more fails with NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED */
+    bool isEstimate;          /* true if the loaded module doesn't report its queue and the values have been estimated by the library */
+} NMQueueInfo;
+
+/**
+ * State of the frame budget, see NotificationModule_GetFrameBudgetInfo().
+ */
+typedef struct _NMFrameBudgetInfo {
+    uint32_t queued;    /* Operations that are currently waiting for a later frame */
+    uint32_t deferred;  /* Operations that have been deferred to a later frame since the library has been initialized */
+    uint32_t coalesced; /* Deferred updates that have been merged into an earlier queued update of the same notification */
+} NMFrameBudgetInfo;
+
+/**
+ * Retry policy for adding notifications, see NotificationModule_SetRetryPolicy().
+ */
+typedef struct _NMRetryPolicy {
+    uint32_t maxAttempts;      /* Number of attempts including the first one. 0 or 1 disables retries */
+    uint32_t initialDelayInMs; /* Delay before the first retry, doubles with every further retry */
+    uint32_t maxDelayInMs;     /* Upper limit of the delay between two attempts (up to 60000) */
+    float jitter;              /* Random part of each delay (0.0 - 1.0). 0.5 means a delay is between 50% and 100% of the backoff */
+} NMRetryPolicy;
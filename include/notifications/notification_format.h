@@ -0,0 +1,333 @@
+#pragma once
+
+#if defined(__cplusplus) && __cplusplus >= 202002L
+
+#include "notifications.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * Compile time checked format strings for C++20. <br>
+ * <br>
+ * The format string is parsed at compile time: every placeholder is checked against the type of its argument, the
+ * literal parts are split into segments and the maximum length of the text (without %s arguments) is calculated.
+ * The text is rendered into a stack buffer of NOTIFICATION_MODULE_FORMAT_MAX_TEXT_LENGTH bytes without measuring first,
+ * only strings are truncated if they don't fit. <br>
+ * <br>
+ * Supported placeholders (same as the templates, see NotificationModuleTemplateArgType):
+ * - **%d, %i**: Any integer.
+ * - **%u, %x, %X**: Any integer, negative values are shown as unsigned like printf.
+ * - **%f, %.Nf** (N <= 9): float or double.
+ * - **%s**: const char*, std::string_view or anything convertible to it.
+ * - **%%**: A single '%'.
+ *
+ * Example:
+ * \code
+ * NotificationModule_AddInfoNotificationFormatted("Copied %u of %u files (%.1f MB/s)", copied, total, speed);
+ * \endcode
+ * Mistakes fail to compile with a call to one of the NotificationModuleFormat::Error_* functions in the error message.
+ */
+
+#define NOTIFICATION_MODULE_FORMAT_MAX_TEXT_LENGTH 256
+
+namespace NotificationModuleFormat {
+    // Never defined. Calling them from the consteval constructor of FormatString makes the compilation fail with their name in the error.
+    void Error_MissingArgument();
+    void Error_UnusedArgument();
+    void Error_UnsupportedPlaceholder();
+    void Error_ArgumentTypeMismatch();
+    void Error_TextTooLong();
+
+    enum class ArgCategory : uint8_t {
+        Invalid,
+        Integer,
+        Float,
+        String,
+    };
+
+    struct ArgInfo {
+        ArgCategory category;
+        // Maximum number of characters for %d/%u and %x
+        uint8_t decimalLength;
+        uint8_t hexLength;
+    };
+
+    template<typename T>
+    consteval ArgInfo GetArgInfo() {
+        using U = std::remove_cvref_t<T>;
+        if constexpr (std::is_same_v<U, bool>) {
+            return {ArgCategory::Invalid, 0, 0};
+        } else if constexpr (std::is_integral_v<U>) {
+            // digits10 is one less than the maximum number of digits, one more for the sign
+            return {ArgCategory::Integer, (uint8_t) (std::numeric_limits<U>::digits10 + 2), (uint8_t) (sizeof(U) * 2)};
+        } else if constexpr (std::is_floating_point_v<U>) {
+            return {ArgCategory::Float, 0, 0};
+        } else if constexpr (std::is_convertible_v<const U &, std::string_view>) {
+            return {ArgCategory::String, 0, 0};
+        } else {
+            return {ArgCategory::Invalid, 0, 0};
+        }
+    }
+
+    // Floats with an absolute value >= FLOAT_MAX_FIXED are shown with an exponent, so they never need more than FLOAT_MAX_LENGTH(precision) characters.
+    inline constexpr double FLOAT_MAX_FIXED = 1e10;
+
+    constexpr uint32_t FLOAT_MAX_LENGTH(uint32_t precision) {
+        // sign + 11 digits (in case of rounding up) + '.' + precision, the exponent form "-1.<precision>e+308" is shorter
+        return 1 + 11 + 1 + precision;
+    }
+
+    struct Segment {
+        uint16_t offset;
+        uint16_t length;
+        // Number of "%%" in the segment, each of them is shown as a single '%'.
+        uint16_t escapes;
+    };
+
+    struct Placeholder {
+        char conversion;
+        uint8_t precision;
+        uint16_t maxLength;
+    };
+
+    template<typename... Args>
+    class FormatString {
+    public:
+        static constexpr uint32_t NUM_ARGS = sizeof...(Args);
+
+        consteval FormatString(const char *format) : mFormat(format) { // NOLINT(google-explicit-constructor)
+            constexpr ArgInfo argInfos[] = {GetArgInfo<Args>()..., ArgInfo{ArgCategory::Invalid, 0, 0}};
+
+            uint32_t numArgs      = 0;
+            uint32_t segmentStart = 0;
+            uint32_t escapes      = 0;
+            uint32_t i            = 0;
+            mMaxLength            = 0;
+            while (format[i] != '\0') {
+                if (format[i] != '%') {
+                    i++;
+                    continue;
+                }
+                if (format[i + 1] == '%') {
+                    escapes++;
+                    i += 2;
+                    continue;
+                }
+                if (numArgs == NUM_ARGS) {
+                    Error_MissingArgument();
+                }
+                mSegments[numArgs] = {(uint16_t) segmentStart, (uint16_t) (i - segmentStart), (uint16_t) escapes};
+                mMaxLength += i - segmentStart - escapes;
+
+                uint32_t end      = i + 1;
+                uint8_t precision = 6;
+                // Only "%.Nf" takes a precision.
+                if (format[end] == '.') {
+                    if (format[end + 1] < '0' || format[end + 1] > '9' || format[end + 2] != 'f') {
+                        Error_UnsupportedPlaceholder();
+                    }
+                    precision = format[end + 1] - '0';
+                    end += 2;
+                }
+                char conversion  = format[end];
+                const auto &info = argInfos[numArgs];
+                uint32_t maxLength;
+                switch (conversion) {
+                    case 'd':
+                    case 'i':
+                    case 'u':
+                    case 'x':
+                    case 'X':
+                        if (info.category != ArgCategory::Integer) {
+                            Error_ArgumentTypeMismatch();
+                        }
+                        maxLength = (conversion == 'x' || conversion == 'X') ? info.hexLength : info.decimalLength;
+                        break;
+                    case 'f':
+                        if (info.category != ArgCategory::Float) {
+                            Error_ArgumentTypeMismatch();
+                        }
+                        maxLength = FLOAT_MAX_LENGTH(precision);
+                        break;
+                    case 's':
+                        if (info.category != ArgCategory::String) {
+                            Error_ArgumentTypeMismatch();
+                        }
+                        // Strings use whatever space is left at runtime.
+                        maxLength = 0;
+                        break;
+                    default:
+                        Error_UnsupportedPlaceholder();
+                        maxLength = 0;
+                        break;
+                }
+                mPlaceholders[numArgs] = {conversion, precision, (uint16_t) maxLength};
+                mMaxLength += maxLength;
+                numArgs++;
+
+                i            = end + 1;
+                segmentStart = i;
+                escapes      = 0;
+            }
+            if (numArgs != NUM_ARGS) {
+                Error_UnusedArgument();
+            }
+            mSegments[numArgs] = {(uint16_t) segmentStart, (uint16_t) (i - segmentStart), (uint16_t) escapes};
+            mMaxLength += i - segmentStart - escapes;
+            if (mMaxLength >= NOTIFICATION_MODULE_FORMAT_MAX_TEXT_LENGTH) {
+                Error_TextTooLong();
+            }
+        }
+
+        const char *mFormat;
+        Segment mSegments[NUM_ARGS + 1]                        = {};
+        Placeholder mPlaceholders[NUM_ARGS > 0 ? NUM_ARGS : 1] = {};
+        // Maximum length of the rendered text without the %s arguments.
+        uint32_t mMaxLength;
+    };
+
+    /**
+     * Writes the output of a FormatString into a buffer of NOTIFICATION_MODULE_FORMAT_MAX_TEXT_LENGTH bytes.
+     * `reserved` is the space that is still needed for the rest of the fixed length parts, strings only get what's left.
+     */
+    class Renderer {
+    public:
+        Renderer(char *buffer, uint32_t reserved) : mBuffer(buffer), mReserved(reserved) {
+        }
+
+        void WriteSegment(const char *format, const Segment &segment) {
+            const char *src = format + segment.offset;
+            if (segment.escapes == 0) {
+                memcpy(mBuffer + mPos, src, segment.length);
+                mPos += segment.length;
+            } else {
+                for (uint32_t i = 0; i < segment.length; i++) {
+                    mBuffer[mPos++] = src[i];
+                    if (src[i] == '%') {
+                        i++;
+                    }
+                }
+            }
+            mReserved -= segment.length - segment.escapes;
+        }
+
+        template<typename T>
+        void WriteArg(const Placeholder &placeholder, const T &value) {
+            using U = std::remove_cvref_t<T>;
+            if constexpr (std::is_integral_v<U>) {
+                using Unsigned = std::make_unsigned_t<U>;
+                bool negative = false;
+                if constexpr (std::is_signed_v<U>) {
+                    negative = value < 0 && (placeholder.conversion == 'd' || placeholder.conversion == 'i');
+                }
+                if (placeholder.conversion == 'x' || placeholder.conversion == 'X') {
+                    WriteUnsigned((Unsigned) value, 16, placeholder.conversion == 'X');
+                } else if (negative) {
+                    mBuffer[mPos++] = '-';
+                    // Negate as unsigned, so the minimum value doesn't overflow.
+                    WriteUnsigned((Unsigned) (Unsigned(0) - (Unsigned) value), 10, false);
+                } else {
+                    WriteUnsigned((Unsigned) value, 10, false);
+                }
+            } else if constexpr (std::is_floating_point_v<U>) {
+                double d = (double) value;
+                int res  = snprintf(mBuffer + mPos,
+                                    placeholder.maxLength + 1,
+                                    (d < FLOAT_MAX_FIXED && d > -FLOAT_MAX_FIXED) ? "%.*f" : "%.*e",
+                                    (int) placeholder.precision,
+                                    d);
+                if (res > 0) {
+                    mPos += (uint32_t) res < placeholder.maxLength ? (uint32_t) res : placeholder.maxLength;
+                }
+            } else {
+                std::string_view str;
+                if constexpr (std::is_pointer_v<U>) {
+                    str = value != nullptr ? std::string_view(value) : std::string_view("(null)");
+                } else {
+                    str = std::string_view(value);
+                }
+                uint32_t space  = NOTIFICATION_MODULE_FORMAT_MAX_TEXT_LENGTH - 1 - mPos - mReserved;
+                uint32_t length = str.size() < space ? (uint32_t) str.size() : space;
+                memcpy(mBuffer + mPos, str.data(), length);
+                mPos += length;
+            }
+            mReserved -= placeholder.maxLength;
+        }
+
+        void Finish() {
+            mBuffer[mPos] = '\0';
+        }
+
+    private:
+        template<typename Unsigned>
+        void WriteUnsigned(Unsigned value, uint32_t base, bool upperCase) {
+            const char *digits = upperCase ? "0123456789ABCDEF" : "0123456789abcdef";
+            char tmp[std::numeric_limits<Unsigned>::digits10 + 1];
+            uint32_t length = 0;
+            do {
+                tmp[length++] = digits[value % base];
+                value /= base;
+            } while (value != 0);
+            while (length > 0) {
+                mBuffer[mPos++] = tmp[--length];
+            }
+        }
+
+        char *mBuffer;
+        uint32_t mPos = 0;
+        uint32_t mReserved;
+    };
+
+    template<typename... Args>
+    void Render(char *buffer, const FormatString<Args...> &format, const Args &...args) {
+        Renderer renderer(buffer, format.mMaxLength);
+        uint32_t index = 0;
+        (void) index;
+        renderer.WriteSegment(format.mFormat, format.mSegments[0]);
+        ((renderer.WriteArg(format.mPlaceholders[index], args), renderer.WriteSegment(format.mFormat, format.mSegments[++index])), ...);
+        renderer.Finish();
+    }
+} // namespace NotificationModuleFormat
+
+/**
+ * Same as NotificationModule_AddInfoNotification(), but the text is created from a format string that is checked at
+ * compile time. See notification_format.h for the supported placeholders.
+ */
+template<typename... Args>
+NotificationModuleStatus NotificationModule_AddInfoNotificationFormatted(NotificationModuleFormat::FormatString<std::type_identity_t<Args>...> format,
+                                                                         const Args &...args) {
+    char text[NOTIFICATION_MODULE_FORMAT_MAX_TEXT_LENGTH];
+    NotificationModuleFormat::Render(text, format, args...);
+    return NotificationModule_AddInfoNotification(text);
+}
+
+/**
+ * Same as NotificationModule_AddErrorNotification(), but the text is created from a format string that is checked at
+ * compile time. See notification_format.h for the supported placeholders.
+ */
+template<typename... Args>
+NotificationModuleStatus NotificationModule_AddErrorNotificationFormatted(NotificationModuleFormat::FormatString<std::type_identity_t<Args>...> format,
+                                                                          const Args &...args) {
+    char text[NOTIFICATION_MODULE_FORMAT_MAX_TEXT_LENGTH];
+    NotificationModuleFormat::Render(text, format, args...);
+    return NotificationModule_AddErrorNotification(text);
+}
+
+/**
+ * Same as NotificationModule_UpdateDynamicNotificationText(), but the text is created from a format string that is
+ * checked at compile time. See notification_format.h for the supported placeholders.
+ */
+template<typename... Args>
+NotificationModuleStatus NotificationModule_UpdateDynamicNotificationTextFormatted(NotificationModuleHandle handle,
+                                                                                   NotificationModuleFormat::FormatString<std::type_identity_t<Args>...> format,
+                                                                                   const Args &...args) {
+    char text[NOTIFICATION_MODULE_FORMAT_MAX_TEXT_LENGTH];
+    NotificationModuleFormat::Render(text, format, args...);
+    return NotificationModule_UpdateDynamicNotificationText(handle, text);
+}
+
+#endif
@@ -31,7 +31,12 @@ const char *NotificationModule_GetStatusStr(NotificationModuleStatus status);
 NotificationModuleStatus NotificationModule_InitLibrary();
 
 /**
- * Deinitializes the NotificationModule lib and releases resources.
+ * Deinitializes the NotificationModule lib and releases resources. <br>
+ * <br>
+ * Dynamic notifications created through this library that are still open are finished immediately. Their finish
+ * callbacks won't be called anymore, so this should be called before the plugin is unloaded. <br>
+ * Static notifications that are still shown stay on the screen, but their finish callbacks (including the default
+ * NOTIFICATION_MODULE_DEFAULT_OPTION_FINISH_FUNCTION) aren't called anymore either.
  *
  * @return The status of the deinitialization.
  * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The library was deinitialized successfully.
@@ -89,6 +94,8 @@ NotificationModuleStatus NotificationModule_IsOverlayReady(bool *outIsReady);
  * - **FINISH_FUNCTION**: Expects `NotificationModuleNotificationFinishedCallback`.
  * - **FINISH_FUNCTION_CONTEXT**: Expects `void*`.
  * - **KEEP_UNTIL_SHOWN**: Expects `bool`.
+ * - **INACTIVITY_TIMEOUT**: Expects `double`.
+ * - **INACTIVITY_TIMEOUT_TEXT**: Expects `const char*`.
  *
  * @return The status of the operation.
  * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The default value has been set.
@@ -225,6 +232,8 @@ NotificationModuleStatus NotificationModule_AddErrorNotificationWithCallback(con
  * Displays a Notification that can be updated and stays on the screen until `NotificationModule_FinishDynamicNotification*` has been called. <br>
  * <br>
  * This functions give you a NotificationHandle which is needed to finish or update this notification. <br>
+ * Handles of finished notifications are rejected by the library without calling into the module, a handle value is
+ * only reused after its internal slot has been recycled 65535 times. <br>
  * <br>
  * Use the `NotificationModule_UpdateDynamicNotificationText*` functions to update the notification after creating it. <br>
  * <br>
@@ -337,6 +346,28 @@ NotificationModuleStatus NotificationModule_UpdateDynamicNotificationBackgroundC
 NotificationModuleStatus NotificationModule_UpdateDynamicNotificationTextColor(NotificationModuleHandle handle,
                                                                                NMColor textColor);
 
+/**
+ * Updates multiple attributes of a dynamic notification at once. <br>
+ * <br>
+ * If the loaded module supports it, all attributes are applied in a single step so the notification is never rendered with
+ * a mix of old and new attributes. Otherwise this falls back to calling the single attribute update functions one after another. <br>
+ * <br>
+ * Requires NotificationModule API version 1 or higher. <br>
+ * <br>
+ * @param[in] handle Handle of the notification.
+ * @param[in] update New values. Only the fields selected by `fieldMask` are read.
+ * @param[in] fieldMask Combination of NotificationModuleDynamicUpdateField values.
+ * @return The status of the operation.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The notification has been updated.
+ * @retval NOTIFICATION_MODULE_RESULT_UNSUPPORTED_COMMAND     The loaded module version doesn't support this function.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT        handle or update was NULL, fieldMask was 0 or contained unknown fields, or the text was NULL while being selected.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_HANDLE          handle was not found.
+ * @retval NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED       The library is not initialized.
+ */
+NotificationModuleStatus NotificationModule_UpdateDynamicNotification(NotificationModuleHandle handle,
+                                                                      const NMDynamicUpdate *update,
+                                                                      uint32_t fieldMask);
+
 /**
  * Fades out a existing dynamic notification.
  *
@@ -380,6 +411,815 @@ NotificationModuleStatus NotificationModule_FinishDynamicNotificationWithShake(N
                                                                                float durationBeforeFadeOutInSeconds,
                                                                                float shakeDuration);
 
+/**
+ * Sets the maximum length of notification texts. <br>
+ * <br>
+ * All texts are validated before they are passed to the NotificationModule. Invalid UTF-8 sequences are replaced with U+FFFD. <br>
+ * Texts that are longer than the given length are truncated on a code point boundary and end with "...". <br>
+ * Texts that are valid and short enough are passed through without being copied. <br>
+ * <br>
+ * Can be called before NotificationModule_InitLibrary(). <br>
+ *
+ * @param[in] maxLengthInCodePoints Maximum number of code points (including the "..."), 0 disables truncation. Default is 0.
+ * @return The status of the operation.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The max length has been set.
+ */
+NotificationModuleStatus NotificationModule_SetMaxTextLength(uint32_t maxLengthInCodePoints);
+
+/**
+ * Stores a copy of a text inside the library and returns a compact id for it. <br>
+ * Interning the same text again returns the same id, so this can be called with fixed strings like "Saved" without keeping track of the id. <br>
+ * <br>
+ * The text is validated/truncated (see NotificationModule_SetMaxTextLength()) before it's stored. <br>
+ * Interned texts are never freed and stay valid until the process exits. This allows the NotificationModule to reference them
+ * instead of copying them on every call (if supported by the loaded module). <br>
+ * Only intern a limited set of fixed texts, do not intern user data. <br>
+ * <br>
+ * Can be called before NotificationModule_InitLibrary(). <br>
+ *
+ * @param[in] text Text that should be interned.
+ * @param[out] outId Pointer where the resulting id will be stored.
+ * @return The status of the operation.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The id has been stored in outId.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT        text or outId was NULL.
+ * @retval NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED       Allocating memory for the text failed or too many texts have been interned.
+ */
+NotificationModuleStatus NotificationModule_InternText(const char *text, NotificationModuleTextId *outId);
+
+/**
+ * Same as NotificationModule_AddInfoNotification(), but takes the id of an interned text. <br>
+ *
+ * @param[in] textId Id returned by NotificationModule_InternText().
+ * @return See NotificationModule_AddInfoNotificationEx() for return values.
+ *         NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT is also returned for unknown ids.
+ * @see NotificationModule_InternText
+ */
+NotificationModuleStatus NotificationModule_AddInfoNotificationInterned(NotificationModuleTextId textId);
+
+/**
+ * Same as NotificationModule_AddErrorNotification(), but takes the id of an interned text. <br>
+ *
+ * @param[in] textId Id returned by NotificationModule_InternText().
+ * @return See NotificationModule_AddErrorNotificationEx() for return values.
+ *         NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT is also returned for unknown ids.
+ * @see NotificationModule_InternText
+ */
+NotificationModuleStatus NotificationModule_AddErrorNotificationInterned(NotificationModuleTextId textId);
+
+/**
+ * Same as NotificationModule_AddDynamicNotification(), but takes the id of an interned text. <br>
+ *
+ * @param[in] textId Id returned by NotificationModule_InternText().
+ * @param[out] outHandle Pointer where the resulting handle will be stored.
+ * @return See NotificationModule_AddDynamicNotificationEx() for return values.
+ *         NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT is also returned for unknown ids.
+ * @see NotificationModule_InternText
+ */
+NotificationModuleStatus NotificationModule_AddDynamicNotificationInterned(NotificationModuleTextId textId,
+                                                                           NotificationModuleHandle *outHandle);
+
+/**
+ * Same as NotificationModule_UpdateDynamicNotificationText(), but takes the id of an interned text. <br>
+ *
+ * @param[in] handle Handle of the notification.
+ * @param[in] textId Id returned by NotificationModule_InternText().
+ * @return See NotificationModule_UpdateDynamicNotificationText() for return values.
+ *         NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT is also returned for unknown ids.
+ * @see NotificationModule_InternText
+ */
+NotificationModuleStatus NotificationModule_UpdateDynamicNotificationTextInterned(NotificationModuleHandle handle,
+                                                                                  NotificationModuleTextId textId);
+
+/**
+ * Registers a format string that can be used with NotificationModule_AddTemplateNotification()
+ * and NotificationModule_UpdateDynamicNotificationTextFromTemplate(). <br>
+ * The format string is parsed once on registration, rendering a template later only copies the literal parts and the arguments. <br>
+ * <br>
+ * Supported placeholders: `%d`/`%i` (INT), `%u`/`%x`/`%X` (UINT), `%f`/`%.Nf` with N <= 9 (FLOAT), `%s` (STRING) and `%%`. <br>
+ * Width, flags and length modifiers are not supported. <br>
+ * Rendered texts are truncated to 255 bytes. <br>
+ * <br>
+ * Templates can not be unregistered. Can be called before NotificationModule_InitLibrary(). <br>
+ *
+ * @param[in] format Format string of the template.
+ * @param[in] profile Type of Notification whose default values will be used when adding a notification from this template.
+ * @param[out] outId Pointer where the resulting id will be stored.
+ * @return The status of the operation.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The id has been stored in outId.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT        format or outId was NULL, the profile was invalid or the format string contains an unsupported placeholder.
+ */
+NotificationModuleStatus NotificationModule_RegisterTemplate(const char *format,
+                                                             NotificationModuleNotificationType profile,
+                                                             NotificationModuleTemplateId *outId);
+
+/**
+ * Renders a template and displays it as a static notification. <br>
+ * Uses the default values of the template profile (see NotificationModule_SetDefaultValue()). <br>
+ *
+ * @param[in] templateId Id returned by NotificationModule_RegisterTemplate().
+ * @param[in] args Arguments for the placeholders of the template, in order. The types have to match the placeholders.
+ * @param[in] numArgs Number of arguments. Has to match the number of placeholders of the template.
+ * @return See NotificationModule_AddInfoNotificationEx() for return values.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT        Unknown template id or the arguments don't match the template.
+ * @retval NOTIFICATION_MODULE_RESULT_UNSUPPORTED_TYPE        The template has been registered with the NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC profile.
+ */
+NotificationModuleStatus NotificationModule_AddTemplateNotification(NotificationModuleTemplateId templateId,
+                                                                    const NMTemplateArg *args,
+                                                                    uint32_t numArgs);
+
+/**
+ * Renders a template and sets it as the text of a dynamic notification. <br>
+ * The profile of the template is ignored. <br>
+ *
+ * @param[in] handle Handle of the notification.
+ * @param[in] templateId Id returned by NotificationModule_RegisterTemplate().
+ * @param[in] args Arguments for the placeholders of the template, in order. The types have to match the placeholders.
+ * @param[in] numArgs Number of arguments. Has to match the number of placeholders of the template.
+ * @return See NotificationModule_UpdateDynamicNotificationText() for return values.
+ *         NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT is also returned for unknown template ids or arguments that don't match the template.
+ */
+NotificationModuleStatus NotificationModule_UpdateDynamicNotificationTextFromTemplate(NotificationModuleHandle handle,
+                                                                                      NotificationModuleTemplateId templateId,
+                                                                                      const NMTemplateArg *args,
+                                                                                      uint32_t numArgs);
+
+/**
+ * Opens a binary message catalog. <br>
+ * Catalogs can be created with `tools/nmcatalog.py` and map numeric ids to (e.g. localized) texts. <br>
+ * The file is read with a single read and used in place, no parsing is done when looking up texts. <br>
+ * <br>
+ * Can be called before NotificationModule_InitLibrary(). <br>
+ *
+ * @param[in] path Path to the catalog file.
+ * @param[out] outCatalog Pointer where the resulting catalog handle will be stored.
+ * @return The status of the operation.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The catalog has been opened.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT        path or outCatalog was NULL, the file could not be read or is not a valid catalog.
+ * @retval NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED       Allocating memory for the catalog failed.
+ * @see NotificationModule_CloseCatalog
+ */
+NotificationModuleStatus NotificationModule_OpenCatalog(const char *path, NotificationModuleCatalogHandle *outCatalog);
+
+/**
+ * Closes a catalog opened with NotificationModule_OpenCatalog(). <br>
+ * Texts returned by NotificationModule_GetCatalogText() are invalid afterwards. <br>
+ *
+ * @param[in] catalog Catalog to close.
+ * @return The status of the operation.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The catalog has been closed.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT        catalog was NULL.
+ */
+NotificationModuleStatus NotificationModule_CloseCatalog(NotificationModuleCatalogHandle catalog);
+
+/**
+ * Looks up a text in a catalog (O(log n)). <br>
+ *
+ * @param[in] catalog Catalog returned by NotificationModule_OpenCatalog().
+ * @param[in] textId Id of the text.
+ * @param[out] outText Pointer where a pointer to the text will be stored. Valid until the catalog is closed.
+ * @return The status of the operation.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The text has been stored in outText.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT        catalog or outText was NULL or the catalog doesn't contain the id.
+ */
+NotificationModuleStatus NotificationModule_GetCatalogText(NotificationModuleCatalogHandle catalog, uint32_t textId, const char **outText);
+
+/**
+ * Same as NotificationModule_AddInfoNotification(), but takes the text from a catalog. <br>
+ *
+ * @param[in] catalog Catalog returned by NotificationModule_OpenCatalog().
+ * @param[in] textId Id of the text.
+ * @return See NotificationModule_AddInfoNotificationEx() for return values.
+ *         NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT is also returned if the catalog doesn't contain the id.
+ */
+NotificationModuleStatus NotificationModule_AddInfoNotificationById(NotificationModuleCatalogHandle catalog, uint32_t textId);
+
+/**
+ * Same as NotificationModule_AddErrorNotification(), but takes the text from a catalog. <br>
+ *
+ * @param[in] catalog Catalog returned by NotificationModule_OpenCatalog().
+ * @param[in] textId Id of the text.
+ * @return See NotificationModule_AddErrorNotificationEx() for return values.
+ *         NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT is also returned if the catalog doesn't contain the id.
+ */
+NotificationModuleStatus NotificationModule_AddErrorNotificationById(NotificationModuleCatalogHandle catalog, uint32_t textId);
+
+/**
+ * Animates the background color of a dynamic notification. <br>
+ * <br>
+ * All animations are driven by a single library thread which updates the colors at most 30 times per second
+ * and only calls the module if the color actually changed. <br>
+ * Starting a new background color animation replaces the current one of this handle. <br>
+ * Animations are stopped when the notification is finished (NotificationModule_FinishDynamicNotification*) or the handle becomes invalid. <br>
+ * <br>
+ * Requires NotificationModule API version 1 or higher. <br>
+ *
+ * @param[in] handle Handle of the notification.
+ * @param[in] from Background color at the start of the animation.
+ * @param[in] to Background color at the end of the animation.
+ * @param[in] durationInSeconds Duration of the animation (or of one cycle for NOTIFICATION_MODULE_EASING_PULSE).
+ * @param[in] easing Easing curve of the animation.
+ * @return The status of the operation.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The animation has been started.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT        handle was NULL, duration was not positive or easing was invalid.
+ * @retval NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED       The library is not initialized.
+ * @see NotificationModule_StopDynamicNotificationAnimations
+ */
+NotificationModuleStatus NotificationModule_AnimateDynamicNotificationBackgroundColor(NotificationModuleHandle handle,
+                                                                                      NMColor from,
+                                                                                      NMColor to,
+                                                                                      float durationInSeconds,
+                                                                                      NotificationModuleEasing easing);
+
+/**
+ * Animates the text color of a dynamic notification. <br>
+ * See NotificationModule_AnimateDynamicNotificationBackgroundColor() for details.
+ *
+ * @param[in] handle Handle of the notification.
+ * @param[in] from Text color at the start of the animation.
+ * @param[in] to Text color at the end of the animation.
+ * @param[in] durationInSeconds Duration of the animation (or of one cycle for NOTIFICATION_MODULE_EASING_PULSE).
+ * @param[in] easing Easing curve of the animation.
+ * @return See NotificationModule_AnimateDynamicNotificationBackgroundColor() for return values.
+ * @see NotificationModule_StopDynamicNotificationAnimations
+ */
+NotificationModuleStatus NotificationModule_AnimateDynamicNotificationTextColor(NotificationModuleHandle handle,
+                                                                                NMColor from,
+                                                                                NMColor to,
+                                                                                float durationInSeconds,
+                                                                                NotificationModuleEasing easing);
+
+/**
+ * Stops all color animations of a dynamic notification. The colors stay at their current value. <br>
+ *
+ * @param[in] handle Handle of the notification.
+ * @return The status of the operation.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The animations have been stopped.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT        handle was NULL.
+ */
+NotificationModuleStatus NotificationModule_StopDynamicNotificationAnimations(NotificationModuleHandle handle);
+
+/**
+ * Creates a notification group. <br>
+ * <br>
+ * All messages added to a group are merged into a single dynamic notification which shows the latest message and
+ * the number of messages, e.g. "Failed to copy file.txt (x12)". <br>
+ * The notification fades out once no message has been added for `durationBeforeFadeOutInSeconds` (see NotificationModule_SetDefaultValue()),
+ * the next message creates a new one. <br>
+ * <br>
+ * Can be called before NotificationModule_InitLibrary(). <br>
+ *
+ * @param[in] type NOTIFICATION_MODULE_NOTIFICATION_TYPE_INFO or NOTIFICATION_MODULE_NOTIFICATION_TYPE_ERROR. The default values (colors and duration) of this type will be used.
+ * @param[out] outGroup Pointer where the resulting group handle will be stored.
+ * @return The status of the operation.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The group has been created.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT        outGroup was NULL or type was invalid.
+ * @retval NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED       Allocating the group failed.
+ * @see NotificationModule_DestroyGroup
+ */
+NotificationModuleStatus NotificationModule_CreateGroup(NotificationModuleNotificationType type, NotificationModuleGroupHandle *outGroup);
+
+/**
+ * Destroys a notification group. The notification of the group (if any) fades out. <br>
+ *
+ * @param[in] group Group returned by NotificationModule_CreateGroup().
+ * @return The status of the operation.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The group has been destroyed.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT        group was NULL or unknown.
+ */
+NotificationModuleStatus NotificationModule_DestroyGroup(NotificationModuleGroupHandle group);
+
+/**
+ * Adds a message to a notification group. <br>
+ * Creates the dynamic notification of the group if needed, otherwise updates its text. <br>
+ * The notification fades out once no message has been added for the durationBeforeFadeOutInSeconds default value of
+ * the type of the group, at most ~71 minutes. <br>
+ * <br>
+ * Requires NotificationModule API version 1 or higher. <br>
+ *
+ * @param[in] group Group returned by NotificationModule_CreateGroup().
+ * @param[in] text Content of the message.
+ * @return See NotificationModule_AddDynamicNotificationEx() and NotificationModule_UpdateDynamicNotificationText() for return values.
+ * @retval NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED       The fade out couldn't be scheduled, the notification has been finished.
+ */
+NotificationModuleStatus NotificationModule_AddNotificationToGroup(NotificationModuleGroupHandle group, const char *text);
+
+/**
+ * Assigns a tag to a dynamic notification. <br>
+ * Tags can be used to finish or recolor all dynamic notifications with the same tag with a single call,
+ * see NotificationModule_FinishAllWithTag() and NotificationModule_UpdateColorsWithTag(). <br>
+ * Every dynamic notification starts with NOTIFICATION_MODULE_TAG_NONE, a handle can only have one tag at a time. <br>
+ * Handles of deferred notifications (see NotificationModule_SetFrameBudget()) can be tagged right away. <br>
+ *
+ * @param[in] handle Handle of a dynamic notification created by this library.
+ * @param[in] tag Application defined tag. NOTIFICATION_MODULE_TAG_NONE removes the tag.
+ * @return The status of the operation.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The tag has been assigned.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT        handle was 0.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_HANDLE          The handle is unknown or the notification has already been finished.
+ */
+NotificationModuleStatus NotificationModule_TagHandle(NotificationModuleHandle handle, NotificationModuleTag tag);
+
+/**
+ * Fades out all dynamic notifications with the given tag. <br>
+ * Uses a single module call if the loaded module supports it and no operations are deferred by
+ * NotificationModule_SetFrameBudget() or NotificationModule_SetRetryPolicy(). Otherwise the notifications are finished
+ * one by one like NotificationModule_FinishDynamicNotification(), after their deferred operations. <br>
+ * Notifications that could not be finished keep their handle. <br>
+ * <br>
+ * Requires NotificationModule API version 1 or higher. <br>
+ *
+ * @param[in] tag Tag that has been assigned with NotificationModule_TagHandle().
+ * @param[in] durationBeforeFadeOutInSeconds Delay before the notifications will start fading out.
+ * @return The status of the operation. If finishing failed, the first error of the module is returned.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 All notifications with the tag have been finished (or there were none).
+ * @retval NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED       The library is not initialized.
+ * @retval NOTIFICATION_MODULE_RESULT_UNSUPPORTED_COMMAND     The command is not supported by the loaded module.
+ */
+NotificationModuleStatus NotificationModule_FinishAllWithTag(NotificationModuleTag tag, float durationBeforeFadeOutInSeconds);
+
+/**
+ * Updates the text and background color of all dynamic notifications with the given tag. <br>
+ * Uses a single module call if the loaded module supports it and no operations are deferred by
+ * NotificationModule_SetFrameBudget() or NotificationModule_SetRetryPolicy(). Otherwise the notifications are updated
+ * one by one like NotificationModule_UpdateDynamicNotification(), after their deferred operations. <br>
+ * <br>
+ * Requires NotificationModule API version 1 or higher. <br>
+ *
+ * @param[in] tag Tag that has been assigned with NotificationModule_TagHandle().
+ * @param[in] textColor New text color.
+ * @param[in] backgroundColor New background color.
+ * @return The status of the operation. If updating failed, the first error of the module is returned.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 All notifications with the tag have been updated (or there were none).
+ * @retval NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED       The library is not initialized.
+ * @retval NOTIFICATION_MODULE_RESULT_UNSUPPORTED_COMMAND     The command is not supported by the loaded module.
+ */
+NotificationModuleStatus NotificationModule_UpdateColorsWithTag(NotificationModuleTag tag, NMColor textColor, NMColor backgroundColor);
+
+/**
+ * Sets the inactivity timeout of a dynamic notification, overriding NOTIFICATION_MODULE_DEFAULT_OPTION_INACTIVITY_TIMEOUT. <br>
+ * If the notification isn't updated (text or color) for `timeoutInSeconds`, it's finished with a shake. If
+ * NOTIFICATION_MODULE_DEFAULT_OPTION_INACTIVITY_TIMEOUT_TEXT is set, that text is shown first. <br>
+ * This catches notifications that would stay on the screen forever because the thread that updates them has died. <br>
+ * The timeout restarts now and on every successful update. <br>
+ *
+ * @param[in] handle Handle of the dynamic notification.
+ * @param[in] timeoutInSeconds Timeout in seconds, 0 disables the timeout for this notification.
+ * @return The status of the operation.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The timeout has been set.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT        handle was 0.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_HANDLE          The handle is unknown or the notification has already been finished.
+ * @retval NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED       The library is not initialized.
+ */
+NotificationModuleStatus NotificationModule_SetDynamicNotificationInactivityTimeout(NotificationModuleHandle handle, float timeoutInSeconds);
+
+/**
+ * Fills a NMNotificationDesc with the current default values of a type (see NotificationModule_SetDefaultValue()). <br>
+ * `text` is set to NULL and has to be set by the caller. <br>
+ *
+ * @param[in] type Type of the notification.
+ * @param[out] outDesc Description that will be filled.
+ * @return The status of the operation.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The description has been filled.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT        outDesc was NULL or type was invalid.
+ */
+NotificationModuleStatus NotificationModule_InitNotificationDesc(NotificationModuleNotificationType type, NMNotificationDesc *outDesc);
+
+/**
+ * Shows a notification after a delay unless it's cancelled before. <br>
+ * The description (including the text) is copied, it doesn't need to stay valid. <br>
+ * All scheduled notifications share one library thread which doesn't wake up while nothing is scheduled.
+ * Scheduling and cancelling are O(1). Pending notifications are dropped by NotificationModule_DeInitLibrary(). <br>
+ * <br>
+ * Requires NotificationModule API version 1 or higher. <br>
+ *
+ * @param[in] desc Description of the notification, only NOTIFICATION_MODULE_NOTIFICATION_TYPE_INFO and NOTIFICATION_MODULE_NOTIFICATION_TYPE_ERROR are supported.
+ * @param[in] delayInUs Delay in microseconds (rounded up to 10ms), at most NM_SCHEDULE_MAX_DELAY_IN_US.
+ * @param[out] outHandle Pointer where the handle for NotificationModule_CancelScheduled() will be stored, may be NULL.
+ * @return The status of the operation.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The notification has been scheduled.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT        desc or desc->text was NULL, desc->size was smaller than NM_NOTIFICATION_DESC_SIZE_V1
+ *                                                            or delayInUs was larger than NM_SCHEDULE_MAX_DELAY_IN_US.
+ * @retval NOTIFICATION_MODULE_RESULT_UNSUPPORTED_TYPE        desc->type was NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC.
+ * @retval NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED       Too many notifications are scheduled.
+ * @retval NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED       The library is not initialized.
+ * @see NotificationModule_InitNotificationDesc
+ */
+NotificationModuleStatus NotificationModule_ScheduleNotification(const NMNotificationDesc *desc, uint64_t delayInUs, NMScheduleHandle *outHandle);
+
+/**
+ * Cancels a notification that has been scheduled with NotificationModule_ScheduleNotification(). <br>
+ *
+ * @param[in] handle Handle returned by NotificationModule_ScheduleNotification().
+ * @return The status of the operation.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The notification has been cancelled and won't be shown.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT        handle was NM_SCHEDULE_HANDLE_INVALID.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_HANDLE          The notification has already been shown or cancelled.
+ */
+NotificationModuleStatus NotificationModule_CancelScheduled(NMScheduleHandle handle);
+
+/**
+ * Creates a notification context. A context has its own default values and can limit how many notifications
+ * it adds, so a noisy plugin can't flood the screen of other plugins. <br>
+ * The default values are copied from the current global default values (see NotificationModule_SetDefaultValue()). <br>
+ * Functions without a context use a shared context without any limits. <br>
+ * <br>
+ * Requires NotificationModule API version 1 or higher. <br>
+ *
+ * @param[in] name Name of the context, used for logging. Truncated to 31 characters.
+ * @param[in] quota Limits of the context, may be NULL for no limits.
+ * @param[out] outContext Pointer where the context will be stored.
+ * @return The status of the operation.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The context has been created.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT        name or outContext was NULL.
+ * @retval NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED       Allocation of the context has failed.
+ * @see NotificationModule_DestroyContext
+ */
+NotificationModuleStatus NotificationModule_CreateContext(const char *name, const NMContextQuota *quota, NotificationModuleContextHandle *outContext);
+
+/**
+ * Destroys a context created by NotificationModule_CreateContext(). <br>
+ * Notifications of the context that are still shown are not affected. <br>
+ *
+ * @param[in] context Context to destroy.
+ * @return The status of the operation.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The context has been destroyed.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT        context was NULL.
+ */
+NotificationModuleStatus NotificationModule_DestroyContext(NotificationModuleContextHandle context);
+
+/**
+ * Same as NotificationModule_SetDefaultValue(), but only changes the default values of a context. <br>
+ *
+ * @param[in] context Context for which the default value will be set.
+ * @param[in] type Type of Notification for which the default value will be set.
+ * @param[in] optionType Defines which option will be set.
+ * @param[in] ... Expected to be a single value matching the `optionType`, see NotificationModule_SetDefaultValue().
+ * @return The status of the operation.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The default value has been set.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT        The context, notification or option type was invalid.
+ */
+NotificationModuleStatus NotificationModule_SetContextDefaultValue(NotificationModuleContextHandle context,
+                                                                   NotificationModuleNotificationType type,
+                                                                   NotificationModuleNotificationOption optionType,
+                                                                   ...);
+
+/**
+ * Same as NotificationModule_AddInfoNotification(), but uses the default values and limits of a context. <br>
+ * <br>
+ * Requires NotificationModule API version 1 or higher. <br>
+ *
+ * @param[in] context Context of the notification.
+ * @param[in] text Content of the notification.
+ * @return The status of the operation.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The notification was successfully added or queued.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT        context or text was NULL.
+ * @retval NOTIFICATION_MODULE_RESULT_QUOTA_EXCEEDED          The context has too many notifications in flight or exceeded its rate limit.
+ * @retval NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED       Allocation of the Notification has failed.
+ * @retval NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED       The library is not initialized.
+ */
+NotificationModuleStatus NotificationModule_AddInfoNotificationInContext(NotificationModuleContextHandle context, const char *text);
+
+/**
+ * Same as NotificationModule_AddErrorNotification(), but uses the default values and limits of a context. <br>
+ * <br>
+ * Requires NotificationModule API version 1 or higher. <br>
+ *
+ * @param[in] context Context of the notification.
+ * @param[in] text Content of the notification.
+ * @return The status of the operation.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The notification was successfully added or queued.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT        context or text was NULL.
+ * @retval NOTIFICATION_MODULE_RESULT_QUOTA_EXCEEDED          The context has too many notifications in flight or exceeded its rate limit.
+ * @retval NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED       Allocation of the Notification has failed.
+ * @retval NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED       The library is not initialized.
+ */
+NotificationModuleStatus NotificationModule_AddErrorNotificationInContext(NotificationModuleContextHandle context, const char *text);
+
+/**
+ * Same as NotificationModule_AddDynamicNotification(), but uses the default values and limits of a context. <br>
+ * The notification counts against the in-flight limit until it has been finished. <br>
+ * <br>
+ * Requires NotificationModule API version 1 or higher. <br>
+ *
+ * @param[in] context Context of the notification.
+ * @param[in] text Content of the notification.
+ * @param[out] outHandle Pointer where the handle of the notification will be stored.
+ * @return The status of the operation.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The notification was successfully added.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT        context, text or outHandle was NULL.
+ * @retval NOTIFICATION_MODULE_RESULT_QUOTA_EXCEEDED          The context has too many notifications in flight or exceeded its rate limit.
+ * @retval NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED       Allocation of the Notification has failed.
+ * @retval NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED       The library is not initialized.
+ */
+NotificationModuleStatus NotificationModule_AddDynamicNotificationInContext(NotificationModuleContextHandle context,
+                                                                            const char *text,
+                                                                            NotificationModuleHandle *outHandle);
+
+/**
+ * Returns how full the overlay is, so callers can slow down before adding notifications fails with
+ * NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED. <br>
+ * If the loaded module doesn't report its queue, the values are estimated from the notifications added through
+ * this library (in this application) and `isEstimate` is set. <br>
+ * <br>
+ * Requires NotificationModule API version 1 or higher. <br>
+ *
+ * @param[out] outInfo Pointer where the queue info will be stored.
+ * @return The status of the operation.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The queue info has been stored in outInfo.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT        outInfo was NULL.
+ * @retval NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED       The library is not initialized.
+ * @see NotificationModule_GetThrottleDelay
+ */
+NotificationModuleStatus NotificationModule_GetQueueInfo(NMQueueInfo *outInfo);
+
+/**
+ * Returns how long a caller should wait before adding the next notification, based on NotificationModule_GetQueueInfo(). <br>
+ * The delay is 0 while the overlay is at most half full and grows up to 1000ms when it's full or many notifications
+ * are waiting to be shown. <br>
+ * <br>
+ * Requires NotificationModule API version 1 or higher. <br>
+ *
+ * @param[out] outDelayInMs Pointer where the suggested delay in milliseconds will be stored.
+ * @return The status of the operation.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The delay has been stored in outDelayInMs.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT        outDelayInMs was NULL.
+ * @retval NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED       The library is not initialized.
+ */
+NotificationModuleStatus NotificationModule_GetThrottleDelay(uint32_t *outDelayInMs);
+
+/**
+ * Opens a progress channel for a dynamic notification, so a worker thread can report its progress without calling
+ * into the module itself. <br>
+ * The worker publishes values with NotificationModule_PublishProgress(). The library picks up the latest value once
+ * per frame and updates the text of the notification, values that are published in between are skipped. <br>
+ * Each channel must only be used by one producer thread. <br>
+ * <br>
+ * Requires NotificationModule API version 1 or higher. <br>
+ *
+ * @param[in] handle Dynamic notification that shows the progress.
+ * @param[in] templateId Template that is rendered with the value as single NOTIFICATION_MODULE_TEMPLATE_ARG_TYPE_UINT
+ *                       argument, e.g. "Downloading... %u%%". NOTIFICATION_MODULE_TEMPLATE_ID_INVALID shows the value as percentage.
+ * @param[out] outChannel Pointer where the channel will be stored.
+ * @return The status of the operation.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The channel has been opened.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT        outChannel was NULL.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_HANDLE          handle is not a dynamic notification or has already been finished.
+ * @retval NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED       Allocating the channel failed.
+ * @retval NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED       The library is not initialized.
+ * @see NotificationModule_CloseProgressChannel
+ */
+NotificationModuleStatus NotificationModule_OpenProgressChannel(NotificationModuleHandle handle,
+                                                                NotificationModuleTemplateId templateId,
+                                                                NotificationModuleProgressChannel *outChannel);
+
+/**
+ * Publishes the latest progress of a channel. This is a single atomic store, it never blocks or allocates. <br>
+ *
+ * @param[in] channel Channel returned by NotificationModule_OpenProgressChannel().
+ * @param[in] value New value, 0xFFFFFFFF is reserved.
+ * @return The status of the operation.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The value has been published.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT        channel was NULL or value was 0xFFFFFFFF.
+ */
+NotificationModuleStatus NotificationModule_PublishProgress(NotificationModuleProgressChannel channel, uint32_t value);
+
+/**
+ * Closes a progress channel. The last published value is still shown, the notification itself is not finished. <br>
+ * The channel must not be used afterwards. <br>
+ *
+ * @param[in] channel Channel returned by NotificationModule_OpenProgressChannel().
+ * @return The status of the operation.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The channel has been closed.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT        channel was NULL.
+ */
+NotificationModuleStatus NotificationModule_CloseProgressChannel(NotificationModuleProgressChannel channel);
+
+/**
+ * Displays a Notification like NotificationModule_AddInfoNotification(), but with a printf-style format. <br>
+ * Only the format pointer and the raw argument values are stored (strings are copied), the text is formatted when
+ * the notification is actually passed to the module, once per frame. Notifications that are dropped are never
+ * formatted: <br>
+ * - An identical notification (same format pointer and arguments) is still queued. <br>
+ * - All 64 records are in use, e.g. because the overlay is busy (see NotificationModule_GetThrottleDelay()). <br>
+ * <br>
+ * The format must be a string literal or otherwise stay valid until the notification has been shown. Formats are
+ * parsed once and cached by their address, so the contents of a format must never change while the library is
+ * initialized (e.g. don't pass a buffer that is reused for different formats). <br>
+ * Formats with "*" width/precision or more than 8 arguments are formatted right away. <br>
+ * <br>
+ * Requires NotificationModule API version 1 or higher. <br>
+ *
+ * @param[in] format printf-style format of the content.
+ * @return The status of the operation.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The notification has been queued.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT        format was NULL.
+ * @retval NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED       All records are in use, the notification has been dropped.
+ * @retval NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED       The library is not initialized.
+ */
+NotificationModuleStatus NotificationModule_AddInfoNotificationDeferred(const char *format, ...) NM_FORMAT_PRINTF(1, 2);
+
+/**
+ * Same as NotificationModule_AddInfoNotificationDeferred(), but displays an error notification like
+ * NotificationModule_AddErrorNotification(). <br>
+ *
+ * @param[in] format printf-style format of the content.
+ * @return The status of the operation.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The notification has been queued.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT        format was NULL.
+ * @retval NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED       All records are in use, the notification has been dropped.
+ * @retval NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED       The library is not initialized.
+ */
+NotificationModuleStatus NotificationModule_AddErrorNotificationDeferred(const char *format, ...) NM_FORMAT_PRINTF(1, 2);
+
+/**
+ * Starts to periodically append statistics of this library to a file. <br>
+ * Every `intervalInMs` a record with the number of calls into the module, the number of calls per result,
+ * a latency histogram and the number of suppressed (e.g. by a context quota) and coalesced (e.g. by a group)
+ * notifications is collected. Records are buffered in memory and written in chunks of about 4 KiB from a
+ * background thread. The counters are cumulative since the library has been initialized. <br>
+ * Use `tools/nmstats2csv.py` to convert the file to CSV. <br>
+ * <br>
+ * An already running export is stopped first. The export is stopped and all buffered records are written by
+ * NotificationModule_StopStatsExport() and NotificationModule_DeInitLibrary(). <br>
+ *
+ * @param path Path of the file the records will be appended to. The file is created if it doesn't exist.
+ * @param intervalInMs Time between two records in milliseconds, at least 100.
+ * @return The status of the operation.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The export has been started.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT        path was NULL or empty, or intervalInMs was less than 100.
+ * @retval NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED       Failed to start the export.
+ * @retval NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED       The library is not initialized.
+ * @see NotificationModule_StopStatsExport
+ */
+NotificationModuleStatus NotificationModule_StartStatsExport(const char *path, uint32_t intervalInMs);
+
+/**
+ * Stops the export started by NotificationModule_StartStatsExport(). A final record is collected and all buffered
+ * records are written to the file. Does nothing if no export is running. <br>
+ *
+ * @return The status of the operation.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The export has been stopped.
+ */
+NotificationModuleStatus NotificationModule_StopStatsExport();
+
+/**
+ * Limits the calls into the module per frame (1/60 second), to avoid frame time spikes when many notifications are
+ * added or updated at once. <br>
+ * Adding, updating and finishing notifications that exceed the budget is deferred: the functions return
+ * NOTIFICATION_MODULE_RESULT_SUCCESS right away and the operation is sent to the module from a background thread in
+ * a later frame. Operations on the same notification (and static notifications) keep their order, consecutive
+ * deferred updates of a notification are merged. <br>
+ * Handles returned for deferred dynamic notifications can be used right away (including tags, inactivity timeouts
+ * and progress channels), their operations are sent after the notification has been created. Errors of deferred
+ * operations are not reported to the caller, but a deferred notification that can't be added calls its finish
+ * callback right away. <br>
+ * Up to 256 operations can be deferred, after that adding or updating notifications fails with
+ * NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED. <br>
+ * <br>
+ * Requires NotificationModule API version 1 or higher. <br>
+ *
+ * @param maxCallsPerFrame Maximum number of module calls per frame (up to 1000). 0 disables the limit.
+ * @param maxTimePerFrameInUs Maximum time in microseconds spent in the module per frame (up to 16667). 0 disables the limit.
+ * If both limits are 0 the budget is removed and deferred operations are sent right away.
+ * @return The status of the operation.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The budget has been set.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT        A limit was out of range.
+ * @retval NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED       The library is not initialized.
+ * @see NotificationModule_GetFrameBudgetInfo
+ */
+NotificationModuleStatus NotificationModule_SetFrameBudget(uint32_t maxCallsPerFrame, uint32_t maxTimePerFrameInUs);
+
+/**
+ * Returns how many operations have been deferred because of the budget set by NotificationModule_SetFrameBudget(). <br>
+ *
+ * @param[out] outInfo Pointer where the info will be stored.
+ * @return The status of the operation.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The info has been stored in outInfo.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT        outInfo was NULL.
+ * @retval NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED       The library is not initialized.
+ */
+NotificationModuleStatus NotificationModule_GetFrameBudgetInfo(NMFrameBudgetInfo *outInfo);
+
+/**
+ * Sets a policy for retrying notifications that could not be added because of a transient error
+ * (NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED or NOTIFICATION_MODULE_RESULT_OVERLAY_NOT_READY). <br>
+ * The first attempt is still made on the caller's thread. If it fails with a transient error, the function returns
+ * NOTIFICATION_MODULE_RESULT_SUCCESS and the notification is added from a background thread after an exponential
+ * backoff with jitter. Handles of dynamic notifications can be used right away; updating and finishing them is
+ * queued until the notification has been created. If the last attempt fails, the notification is dropped and its
+ * finish callback is called right away, as if it had faded out. <br>
+ * Applies to NotificationModule_AddInfoNotification(), NotificationModule_AddErrorNotification(),
+ * NotificationModule_AddDynamicNotification() and their variants. <br>
+ * <br>
+ * Requires NotificationModule API version 1 or higher. <br>
+ *
+ * @param[in] policy The policy that will be used for new failures, NULL disables retries. Notifications that are
+ * already waiting for a retry are kept.
+ * @return The status of the operation.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The policy has been set.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT        maxAttempts was above 1 and initialDelayInMs was 0, maxDelayInMs was smaller
+ *                                                            than initialDelayInMs or above 60000, or jitter was not between 0.0 and 1.0.
+ * @retval NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED       The library is not initialized.
+ */
+NotificationModuleStatus NotificationModule_SetRetryPolicy(const NMRetryPolicy *policy);
+
+/**
+ * Adds a notification of any type from a description. <br>
+ * NotificationModule_AddInfoNotificationEx(), NotificationModule_AddErrorNotificationEx() and
+ * NotificationModule_AddDynamicNotificationEx() are wrappers around this function. If the loaded module exports
+ * NMAddNotification, the description is passed to it as is, otherwise the arguments are passed one by one. <br>
+ * Use NotificationModule_InitNotificationDesc() to fill the description with the default values of a type. <br>
+ * <br>
+ * Requires NotificationModule API version 1 or higher. <br>
+ *
+ * @param[in] desc Description of the notification. The text is copied, it doesn't need to stay valid.
+ * @param[out] outHandle Pointer where the handle will be stored. Required for NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC,
+ * ignored for the other types.
+ * @return The status of the operation.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The notification was successfully created.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT        desc or desc->text was NULL, desc->size was smaller than NM_NOTIFICATION_DESC_SIZE_V1 or outHandle was NULL for a dynamic notification.
+ * @retval NOTIFICATION_MODULE_RESULT_UNSUPPORTED_TYPE        desc->type was invalid.
+ * @retval NOTIFICATION_MODULE_RESULT_UNSUPPORTED_COMMAND     The loaded module version doesn't not support this function.
+ * @retval NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED       Allocation of the Notification has failed.
+ * @retval NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED       The library is not initialized.
+ * @see NotificationModule_InitNotificationDesc
+ */
+NotificationModuleStatus NotificationModule_AddNotification(const NMNotificationDesc *desc, NotificationModuleHandle *outHandle);
+
+/**
+ * Shows a dynamic notification for a key or updates the one that is already shown for it. <br>
+ * Meant for status notifications ("Battery low", "Connected to server") that would otherwise need a handle which is
+ * checked and either updated or recreated. If the notification of the key is still shown, only the fields that
+ * differ from the last upsert are updated; an upsert with unchanged content doesn't call into the module.
+ * If it's gone (e.g. after an application switch), a new one is created. <br>
+ * The callback of `desc` is only used when a new notification is created. Keys are interned, so the number of
+ * different keys should be small. <br>
+ * <br>
+ * Requires NotificationModule API version 1 or higher. <br>
+ *
+ * @param[in] key Key of the notification.
+ * @param[in] desc Description of the notification, has to be of type NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC.
+ * @return The status of the operation.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The notification is shown with the given content.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT        key, desc or desc->text was NULL, or desc->size was smaller than NM_NOTIFICATION_DESC_SIZE_V1.
+ * @retval NOTIFICATION_MODULE_RESULT_UNSUPPORTED_TYPE        desc->type was not NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC.
+ * @retval NOTIFICATION_MODULE_RESULT_UNSUPPORTED_COMMAND     The loaded module version doesn't not support dynamic notifications.
+ * @retval NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED       Allocation of the notification or the key has failed.
+ * @retval NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED       The library is not initialized.
+ * @see NotificationModule_InitNotificationDesc
+ * @see NotificationModule_Remove
+ */
+NotificationModuleStatus NotificationModule_Upsert(const char *key, const NMNotificationDesc *desc);
+
+/**
+ * Fades out the notification of a key that has been shown with NotificationModule_Upsert(). <br>
+ *
+ * @param[in] key Key of the notification.
+ * @return The status of the operation.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The notification has been finished or there was none for this key.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT        key was NULL.
+ * @retval NOTIFICATION_MODULE_RESULT_UNSUPPORTED_COMMAND     The loaded module version doesn't not support dynamic notifications.
+ * @retval NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED       The library is not initialized.
+ */
+NotificationModuleStatus NotificationModule_Remove(const char *key);
+
+/**
+ * Displays a dynamic notification that shows a value which is sampled periodically, e.g. a transfer speed or FPS. <br>
+ * `sampleFn` is called every `periodInMs` milliseconds on the background thread of the library, the value is
+ * formatted with `format` and the text is only updated if it has changed. All live notifications share one thread
+ * and one timer, so they don't need a refresh thread of their own. <br>
+ * The first sample is taken on the calling thread before the notification is added. <br>
+ * <br>
+ * Sampling stops when the notification is finished with NotificationModule_FinishDynamicNotification() (or the
+ * module drops it). Once that function has returned, `sampleFn` is not called anymore and `context` can be freed.
+ * `sampleFn` must not block, it delays all other live notifications. <br>
+ * Every sample counts as an update for NOTIFICATION_MODULE_DEFAULT_OPTION_INACTIVITY_TIMEOUT, even if the text didn't
+ * change, so the notification is only finished by the timeout if sampling stalls for longer than it. <br>
+ * <br>
+ * Requires NotificationModule API version 1 or higher. <br>
+ *
+ * @param[in] sampleFn Function that returns the current value.
+ * @param[in] context Context that will be passed to sampleFn.
+ * @param[in] periodInMs Time between two samples in milliseconds, between 1 and 3600000. Periods shorter than one frame
+ *                       (16 ms) are rounded up.
+ * @param[in] format printf-style format with exactly one floating point conversion, e.g. "%.1f FPS" or "%.2f MiB/s".
+ *                   The format is copied.
+ * @param[out] outHandle Pointer where the handle will be stored.
+ * @return The status of the operation.
+ * @retval NOTIFICATION_MODULE_RESULT_SUCCESS                 The notification was successfully created.
+ * @retval NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT        sampleFn, format or outHandle was NULL, periodInMs was out of range
+ *                                                            or format doesn't contain exactly one floating point conversion.
+ * @retval NOTIFICATION_MODULE_RESULT_UNSUPPORTED_COMMAND     The loaded module version doesn't not support dynamic notifications.
+ * @retval NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED       Allocation of the notification has failed.
+ * @retval NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED       The library is not initialized.
+ * @see NotificationModule_FinishDynamicNotification
+ */
+NotificationModuleStatus NotificationModule_AddLiveNotification(NotificationModuleLiveSampleCallback sampleFn,
+                                                                void *context,
+                                                                uint32_t periodInMs,
+                                                                const char *format,
+                                                                NotificationModuleHandle *outHandle);
+
 #ifdef __cplusplus
 }
 #endif
@@ -394,6 +1234,7 @@ NotificationModuleStatus NotificationModule_FinishDynamicNotificationWithShake(N
        only done to make sure application authors pass exactly three arguments
        to these functions. */
 
-#define NotificationModule_SetDefaultValue(type, valueType, param) NotificationModule_SetDefaultValue(type, valueType, param)
+#define NotificationModule_SetDefaultValue(type, valueType, param)                        NotificationModule_SetDefaultValue(type, valueType, param)
+#define NotificationModule_SetContextDefaultValue(context, type, valueType, param) NotificationModule_SetContextDefaultValue(context, type, valueType, param)
 #endif /* __STDC__ >= 1 */
 #endif /* gcc >= 4.3 */
\ No newline at end of file
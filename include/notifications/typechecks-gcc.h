@@ -24,6 +24,7 @@ _NM_WARNING(_nm_warn_float, "NotificationModule_SetDefaultValue expects 'float'
 _NM_WARNING(_nm_warn_callback, "NotificationModule_SetDefaultValue expects 'NotificationModuleNotificationFinishedCallback' for this option.")
 _NM_WARNING(_nm_warn_context, "NotificationModule_SetDefaultValue expects 'void*' for this option.")
 _NM_WARNING(_nm_warn_bool, "NotificationModule_SetDefaultValue expects 'bool' (or 'int') for this option.")
+_NM_WARNING(_nm_warn_string, "NotificationModule_SetDefaultValue expects 'const char*' for this option.")
 
 #ifdef __cplusplus
 }
@@ -80,6 +81,14 @@ namespace NM_Check {
     inline bool check_context(std::nullptr_t) { return true; }
     template<typename T>
     inline bool check_context(T) { return false; }
+
+    /* String Checker */
+    inline bool check_string(const char *) { return true; }
+    inline bool check_string(int i) { return i == 0; }
+    inline bool check_string(long i) { return i == 0; }
+    inline bool check_string(std::nullptr_t) { return true; }
+    template<typename T>
+    inline bool check_string(T) { return false; }
 } // namespace NM_Check
 
 /* Macros mapping to C++ namespace calls */
@@ -88,6 +97,7 @@ namespace NM_Check {
 #define _nm_is_bool(x)     NM_Check::check_bool(x)
 #define _nm_is_callback(x) NM_Check::check_callback(x)
 #define _nm_is_context(x)  NM_Check::check_context(x)
+#define _nm_is_string(x)   NM_Check::check_string(x)
 
 #else
 /* ==========================================
@@ -99,6 +109,7 @@ namespace NM_Check {
 #define _nm_is_bool(x)     (1)
 #define _nm_is_callback(x) (1)
 #define _nm_is_context(x)  (1)
+#define _nm_is_string(x)   (1)
 #endif
 
 #elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
@@ -130,6 +141,12 @@ namespace NM_Check {
                                    void * : 1, \
                                    default : 0)
 
+#define _nm_is_string(x) _Generic((x),              \
+                                  char * : 1,       \
+                                  const char * : 1, \
+                                  void * : 1,       \
+                                  default : 0)
+
 #else
 
 /* ==========================================
@@ -143,6 +160,7 @@ namespace NM_Check {
 #define _nm_is_NMColor(x)    (1)
 #define _nm_is_callback(x)   (1)
 #define _nm_is_context(x)    (1)
+#define _nm_is_string(x)     (1)
 
 /* Scalars are safe to check */
 #define _nm_is_float(x)      (_nm_is_type(x, float) || _nm_is_type(x, double))
@@ -150,8 +168,8 @@ namespace NM_Check {
 
 #endif
 
-#define NotificationModule_SetDefaultValue(type, option, value)                                                        \
-    __extension__({                                                                                                    \
+#define _NM_CHECK_DEFAULT_VALUE(option, value)                                                                         \
+    do {                                                                                                               \
         if (__builtin_constant_p(option)) {                                                                            \
             if ((option == NOTIFICATION_MODULE_DEFAULT_OPTION_BACKGROUND_COLOR) && !_nm_is_NMColor(value))             \
                 _nm_warn_NMColor();                                                                                    \
@@ -165,8 +183,23 @@ namespace NM_Check {
                 _nm_warn_context();                                                                                    \
             else if ((option == NOTIFICATION_MODULE_DEFAULT_OPTION_KEEP_UNTIL_SHOWN) && !_nm_is_bool(value))           \
                 _nm_warn_bool();                                                                                       \
+            else if ((option == NOTIFICATION_MODULE_DEFAULT_OPTION_INACTIVITY_TIMEOUT) && !_nm_is_float(value))        \
+                _nm_warn_float();                                                                                      \
+            else if ((option == NOTIFICATION_MODULE_DEFAULT_OPTION_INACTIVITY_TIMEOUT_TEXT) && !_nm_is_string(value))  \
+                _nm_warn_string();                                                                                     \
         }                                                                                                              \
+    } while (0)
+
+#define NotificationModule_SetDefaultValue(type, option, value)                                                        \
+    __extension__({                                                                                                    \
+        _NM_CHECK_DEFAULT_VALUE(option, value);                                                                        \
         (NotificationModule_SetDefaultValue)(type, option, value);                                                     \
     })
 
+#define NotificationModule_SetContextDefaultValue(context, type, option, value)                                        \
+    __extension__({                                                                                                    \
+        _NM_CHECK_DEFAULT_VALUE(option, value);                                                                        \
+        (NotificationModule_SetContextDefaultValue)(context, type, option, value);                                     \
+    })
+
 #endif /* NOTIFICATIONS_TYPECHECK_GCC_H */
\ No newline at end of file
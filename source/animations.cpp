@@ -0,0 +1,210 @@
+#include "animations.h"
+#include "internal.h"
+#include "scheduler.h"
+
+#include <cmath>
+#include <mutex>
+#include <notifications/notifications.h>
+#include <vector>
+
+// Colors are updated at most 30 times per second.
+#define ANIMATION_UPDATE_INTERVAL_IN_US 33333
+
+enum AnimationTarget {
+    ANIMATION_TARGET_BACKGROUND_COLOR,
+    ANIMATION_TARGET_TEXT_COLOR,
+};
+
+struct ColorAnimation {
+    NotificationModuleHandle handle;
+    AnimationTarget target;
+    NMColor from;
+    NMColor to;
+    NMColor lastSent;
+    bool sentOnce;
+    NotificationModuleEasing easing;
+    uint64_t startInUs;
+    uint64_t durationInUs;
+};
+
+struct PendingColorUpdate {
+    NotificationModuleHandle handle;
+    AnimationTarget target;
+    NMColor color;
+};
+
+static std::mutex sAnimationsMutex;
+static std::vector<ColorAnimation> sAnimations;
+static SchedulerTaskId sAnimationTaskId = 0;
+
+static float ApplyEasing(NotificationModuleEasing easing, float t) {
+    switch (easing) {
+        case NOTIFICATION_MODULE_EASING_EASE_IN:
+            return t * t;
+        case NOTIFICATION_MODULE_EASING_EASE_OUT:
+            return 1.0f - (1.0f - t) * (1.0f - t);
+        case NOTIFICATION_MODULE_EASING_EASE_IN_OUT:
+            return t * t * (3.0f - 2.0f * t);
+        case NOTIFICATION_MODULE_EASING_PULSE: {
+            // from -> to -> from
+            float x = t < 0.5f ? t * 2.0f : 2.0f - t * 2.0f;
+            return x * x * (3.0f - 2.0f * x);
+        }
+        case NOTIFICATION_MODULE_EASING_LINEAR:
+            break;
+    }
+    return t;
+}
+
+static uint8_t LerpChannel(uint8_t from, uint8_t to, float t) {
+    return (uint8_t) lroundf((float) from + ((float) to - (float) from) * t);
+}
+
+static bool ColorEquals(const NMColor &a, const NMColor &b) {
+    return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+
+static uint32_t AnimationTask(void *, uint64_t nowInUs) {
+    static std::vector<PendingColorUpdate> pendingUpdates;
+    pendingUpdates.clear();
+    {
+        std::lock_guard<std::mutex> lock(sAnimationsMutex);
+        for (auto it = sAnimations.begin(); it != sAnimations.end();) {
+            uint64_t elapsed = nowInUs - it->startInUs;
+            bool done        = false;
+            float t;
+            if (it->easing == NOTIFICATION_MODULE_EASING_PULSE) {
+                // Pulses repeat until they are stopped.
+                t = (float) (elapsed % it->durationInUs) / (float) it->durationInUs;
+            } else if (elapsed >= it->durationInUs) {
+                t    = 1.0f;
+                done = true;
+            } else {
+                t = (float) elapsed / (float) it->durationInUs;
+            }
+            float e       = ApplyEasing(it->easing, t);
+            NMColor color = {LerpChannel(it->from.r, it->to.r, e),
+                             LerpChannel(it->from.g, it->to.g, e),
+                             LerpChannel(it->from.b, it->to.b, e),
+                             LerpChannel(it->from.a, it->to.a, e)};
+            if (!it->sentOnce || !ColorEquals(color, it->lastSent)) {
+                it->lastSent = color;
+                it->sentOnce = true;
+                pendingUpdates.push_back({it->handle, it->target, color});
+            }
+            if (done) {
+                it = sAnimations.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    for (const auto &update : pendingUpdates) {
+        NotificationModuleStatus res;
+        if (update.target == ANIMATION_TARGET_BACKGROUND_COLOR) {
+            res = NotificationModule_UpdateDynamicNotificationBackgroundColor(update.handle, update.color);
+        } else {
+            res = NotificationModule_UpdateDynamicNotificationTextColor(update.handle, update.color);
+        }
+        // The notification is gone, there is no point in animating it.
+        if (res == NOTIFICATION_MODULE_RESULT_INVALID_HANDLE) {
+            Animations_Stop(update.handle);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(sAnimationsMutex);
+    if (sAnimations.empty()) {
+        sAnimationTaskId = 0;
+        return 0;
+    }
+    return ANIMATION_UPDATE_INTERVAL_IN_US;
+}
+
+static NotificationModuleStatus StartAnimation(NotificationModuleHandle handle,
+                                               AnimationTarget target,
+                                               NMColor from,
+                                               NMColor to,
+                                               float durationInSeconds,
+                                               NotificationModuleEasing easing) {
+    if (handle == 0 || durationInSeconds <= 0.0f || easing < NOTIFICATION_MODULE_EASING_LINEAR || easing > NOTIFICATION_MODULE_EASING_PULSE) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+
+    ColorAnimation animation = {};
+    animation.handle         = handle;
+    animation.target         = target;
+    animation.from           = from;
+    animation.to             = to;
+    animation.easing         = easing;
+    animation.startInUs      = Scheduler_GetTimeInUs();
+    animation.durationInUs   = (uint64_t) (durationInSeconds * 1000000.0f);
+    if (animation.durationInUs == 0) {
+        animation.durationInUs = 1;
+    }
+
+    std::lock_guard<std::mutex> lock(sAnimationsMutex);
+    bool replaced = false;
+    for (auto &cur : sAnimations) {
+        if (cur.handle == handle && cur.target == target) {
+            cur      = animation;
+            replaced = true;
+            break;
+        }
+    }
+    if (!replaced) {
+        sAnimations.push_back(animation);
+    }
+    if (sAnimationTaskId == 0) {
+        sAnimationTaskId = Scheduler_AddTask(AnimationTask, nullptr, 0);
+    }
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+void Animations_Stop(NotificationModuleHandle handle) {
+    std::lock_guard<std::mutex> lock(sAnimationsMutex);
+    for (auto it = sAnimations.begin(); it != sAnimations.end();) {
+        if (it->handle == handle) {
+            it = sAnimations.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void Animations_Reset() {
+    std::lock_guard<std::mutex> lock(sAnimationsMutex);
+    sAnimations.clear();
+    // The scheduler task is removed by Scheduler_Shutdown.
+    sAnimationTaskId = 0;
+}
+
+NotificationModuleStatus NotificationModule_AnimateDynamicNotificationBackgroundColor(NotificationModuleHandle handle,
+                                                                                      NMColor from,
+                                                                                      NMColor to,
+                                                                                      float durationInSeconds,
+                                                                                      NotificationModuleEasing easing) {
+    if (!NotificationModule_IsLibInitialized()) {
+        return NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED;
+    }
+    return StartAnimation(handle, ANIMATION_TARGET_BACKGROUND_COLOR, from, to, durationInSeconds, easing);
+}
+
+NotificationModuleStatus NotificationModule_AnimateDynamicNotificationTextColor(NotificationModuleHandle handle,
+                                                                                NMColor from,
+                                                                                NMColor to,
+                                                                                float durationInSeconds,
+                                                                                NotificationModuleEasing easing) {
+    if (!NotificationModule_IsLibInitialized()) {
+        return NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED;
+    }
+    return StartAnimation(handle, ANIMATION_TARGET_TEXT_COLOR, from, to, durationInSeconds, easing);
+}
+
+NotificationModuleStatus NotificationModule_StopDynamicNotificationAnimations(NotificationModuleHandle handle) {
+    if (handle == 0) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    Animations_Stop(handle);
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "notifications/notification_defines.h"
+
+/**
+ * Stops all animations of a handle. Called when a dynamic notification is finished.
+ */
+void Animations_Stop(NotificationModuleHandle handle);
+
+/**
+ * Stops all animations. Called by NotificationModule_DeInitLibrary.
+ */
+void Animations_Reset();
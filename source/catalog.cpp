@@ -0,0 +1,157 @@
+#include "logger.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <notifications/notifications.h>
+
+#define CATALOG_MAGIC       0x4E4D4354 // "NMCT"
+#define CATALOG_VERSION     1
+#define CATALOG_HEADER_SIZE 16
+#define CATALOG_ENTRY_SIZE  8
+
+// All values in a catalog file are stored in big endian.
+struct _NMCatalog {
+    uint8_t *data;
+    const uint8_t *index;
+    const char *blob;
+    uint32_t count;
+};
+
+static inline uint32_t ReadBE32(const uint8_t *p) {
+    uint32_t val;
+    memcpy(&val, p, sizeof(val));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    val = __builtin_bswap32(val);
+#endif
+    return val;
+}
+
+static bool ValidateCatalog(const uint8_t *data, uint32_t size) {
+    if (size < CATALOG_HEADER_SIZE || ReadBE32(data) != CATALOG_MAGIC || ReadBE32(data + 4) != CATALOG_VERSION) {
+        return false;
+    }
+    uint32_t count    = ReadBE32(data + 8);
+    uint32_t blobSize = ReadBE32(data + 12);
+    if (count > (size - CATALOG_HEADER_SIZE) / CATALOG_ENTRY_SIZE ||
+        (uint64_t) CATALOG_HEADER_SIZE + (uint64_t) count * CATALOG_ENTRY_SIZE + blobSize != size) {
+        return false;
+    }
+    const uint8_t *index = data + CATALOG_HEADER_SIZE;
+    const char *blob     = (const char *) (index + count * CATALOG_ENTRY_SIZE);
+    if (count > 0 && (blobSize == 0 || blob[blobSize - 1] != '\0')) {
+        return false;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        const uint8_t *entry = index + i * CATALOG_ENTRY_SIZE;
+        if (ReadBE32(entry + 4) >= blobSize) {
+            return false;
+        }
+        // The index has to be sorted for the binary search.
+        if (i > 0 && ReadBE32(entry) <= ReadBE32(entry - CATALOG_ENTRY_SIZE)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+NotificationModuleStatus NotificationModule_OpenCatalog(const char *path, NotificationModuleCatalogHandle *outCatalog) {
+    if (path == nullptr || outCatalog == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+
+    FILE *f = fopen(path, "rb");
+    if (f == nullptr) {
+        DEBUG_FUNCTION_LINE_ERR("Failed to open catalog %s", path);
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+
+    long size = -1;
+    if (fseek(f, 0, SEEK_END) == 0) {
+        size = ftell(f);
+        fseek(f, 0, SEEK_SET);
+    }
+    if (size < CATALOG_HEADER_SIZE) {
+        DEBUG_FUNCTION_LINE_ERR("Invalid catalog size for %s", path);
+        fclose(f);
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+
+    auto *catalog = (_NMCatalog *) malloc(sizeof(_NMCatalog));
+    auto *data    = (uint8_t *) malloc(size);
+    if (catalog == nullptr || data == nullptr) {
+        free(catalog);
+        free(data);
+        fclose(f);
+        return NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED;
+    }
+
+    // Read the whole catalog with a single read, the data is used in place afterwards.
+    bool readSuccess = fread(data, 1, size, f) == (size_t) size;
+    fclose(f);
+    if (!readSuccess || !ValidateCatalog(data, size)) {
+        DEBUG_FUNCTION_LINE_ERR("Invalid catalog %s", path);
+        free(catalog);
+        free(data);
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+
+    catalog->data  = data;
+    catalog->count = ReadBE32(data + 8);
+    catalog->index = data + CATALOG_HEADER_SIZE;
+    catalog->blob  = (const char *) (catalog->index + catalog->count * CATALOG_ENTRY_SIZE);
+
+    *outCatalog = catalog;
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+NotificationModuleStatus NotificationModule_CloseCatalog(NotificationModuleCatalogHandle catalog) {
+    if (catalog == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    free(catalog->data);
+    free(catalog);
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+NotificationModuleStatus NotificationModule_GetCatalogText(NotificationModuleCatalogHandle catalog, uint32_t textId, const char **outText) {
+    if (catalog == nullptr || outText == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+
+    uint32_t low  = 0;
+    uint32_t high = catalog->count;
+    while (low < high) {
+        uint32_t mid         = low + (high - low) / 2;
+        const uint8_t *entry = catalog->index + mid * CATALOG_ENTRY_SIZE;
+        uint32_t id          = ReadBE32(entry);
+        if (id == textId) {
+            *outText = catalog->blob + ReadBE32(entry + 4);
+            return NOTIFICATION_MODULE_RESULT_SUCCESS;
+        }
+        if (id < textId) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+}
+
+NotificationModuleStatus NotificationModule_AddInfoNotificationById(NotificationModuleCatalogHandle catalog, uint32_t textId) {
+    const char *text;
+    auto res = NotificationModule_GetCatalogText(catalog, textId, &text);
+    if (res != NOTIFICATION_MODULE_RESULT_SUCCESS) {
+        return res;
+    }
+    return NotificationModule_AddInfoNotification(text);
+}
+
+NotificationModuleStatus NotificationModule_AddErrorNotificationById(NotificationModuleCatalogHandle catalog, uint32_t textId) {
+    const char *text;
+    auto res = NotificationModule_GetCatalogText(catalog, textId, &text);
+    if (res != NOTIFICATION_MODULE_RESULT_SUCCESS) {
+        return res;
+    }
+    return NotificationModule_AddErrorNotification(text);
+}
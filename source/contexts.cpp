@@ -0,0 +1,252 @@
+#include "internal.h"
+#include "logger.h"
+#include "scheduler.h"
+#include "stats.h"
+
+#include <cstring>
+#include <new>
+#include <notifications/notifications.h>
+
+// Forwards the finish callback of a notification that counts against the in-flight limit of a context.
+struct InFlightRecord {
+    _NMContext *context;
+    NotificationModuleNotificationFinishedCallback callback;
+    void *callbackContext;
+};
+
+static void ReleaseContext(_NMContext *context) {
+    if (context->refCount.fetch_sub(1) == 1) {
+        delete context;
+    }
+}
+
+static uint32_t GetTimeInMs() {
+    return (uint32_t) (Scheduler_GetTimeInUs() / 1000);
+}
+
+/**
+ * Admission check for a new notification, lock-free. Returns NOTIFICATION_MODULE_RESULT_QUOTA_EXCEEDED if the
+ * rate limit or the in-flight limit of the context would be exceeded.
+ */
+static NotificationModuleStatus AdmitNotification(_NMContext *context) {
+    if (context->emissionIntervalInMs != 0) {
+        uint32_t now = GetTimeInMs();
+        uint32_t tat = context->theoreticalArrivalTimeInMs.load(std::memory_order_relaxed);
+        uint32_t newTat;
+        do {
+            // The arrival time is never further ahead than the burst tolerance, anything else means it's in the past (or has wrapped around).
+            uint32_t ahead = tat - now;
+            uint32_t base  = ahead <= context->burstToleranceInMs ? tat : now;
+            newTat         = base + context->emissionIntervalInMs;
+            if (newTat - now > context->burstToleranceInMs) {
+                context->rejectedCount.fetch_add(1, std::memory_order_relaxed);
+                Stats_RecordSuppressed();
+                return NOTIFICATION_MODULE_RESULT_QUOTA_EXCEEDED;
+            }
+        } while (!context->theoreticalArrivalTimeInMs.compare_exchange_weak(tat, newTat, std::memory_order_relaxed));
+    }
+    if (context->maxInFlight != 0) {
+        if (context->inFlight.fetch_add(1, std::memory_order_acquire) >= context->maxInFlight) {
+            context->inFlight.fetch_sub(1, std::memory_order_release);
+            context->rejectedCount.fetch_add(1, std::memory_order_relaxed);
+            Stats_RecordSuppressed();
+            return NOTIFICATION_MODULE_RESULT_QUOTA_EXCEEDED;
+        }
+    }
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+static void InFlightFinishedCallback(NotificationModuleHandle handle, void *context) {
+    auto *record = (InFlightRecord *) context;
+    record->context->inFlight.fetch_sub(1, std::memory_order_release);
+    if (record->callback != nullptr) {
+        record->callback(handle, record->callbackContext);
+    }
+    ReleaseContext(record->context);
+    delete record;
+}
+
+/**
+ * Wraps the finish callback so the notification is removed from the in-flight count when it's gone.
+ * Contexts without an in-flight limit don't need this and keep the callback of the application.
+ * Notifications that are still open on NotificationModule_DeInitLibrary keep their record (and context) forever.
+ */
+static NotificationModuleStatus WrapCallback(_NMContext *context,
+                                             NotificationModuleNotificationFinishedCallback &callback,
+                                             void *&callbackContext,
+                                             InFlightRecord *&outRecord) {
+    outRecord = nullptr;
+    if (context->maxInFlight == 0) {
+        return NOTIFICATION_MODULE_RESULT_SUCCESS;
+    }
+    auto *record = new (std::nothrow) InFlightRecord{context, callback, callbackContext};
+    if (record == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED;
+    }
+    context->refCount.fetch_add(1, std::memory_order_relaxed);
+    callback        = InFlightFinishedCallback;
+    callbackContext = record;
+    outRecord       = record;
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+// Undoes AdmitNotification and WrapCallback if the notification couldn't be added.
+static void RevertAdmission(_NMContext *context, InFlightRecord *record) {
+    if (context->maxInFlight != 0) {
+        context->inFlight.fetch_sub(1, std::memory_order_release);
+    }
+    if (record != nullptr) {
+        ReleaseContext(context);
+        delete record;
+    }
+}
+
+NotificationModuleStatus NotificationModule_CreateContext(const char *name, const NMContextQuota *quota, NotificationModuleContextHandle *outContext) {
+    if (name == nullptr || outContext == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    auto *context = new (std::nothrow) _NMContext;
+    if (context == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED;
+    }
+    strncpy(context->name, name, sizeof(context->name) - 1);
+    for (int type = 0; type < MAX_NOTIFICATION_TYPES; type++) {
+        context->defaultValues[type] = NotificationModule_GetDefaultValues((NotificationModuleNotificationType) type);
+    }
+    if (quota != nullptr) {
+        context->maxInFlight = quota->maxInFlight;
+        if (quota->ratePerSecond > 0.0f) {
+            float interval                = 1000.0f / quota->ratePerSecond;
+            context->emissionIntervalInMs = interval < 1.0f ? 1 : (uint32_t) interval;
+            uint32_t burst                = quota->burst > 0 ? quota->burst : 1;
+            context->burstToleranceInMs   = context->emissionIntervalInMs * burst;
+        }
+    }
+    *outContext = context;
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+NotificationModuleStatus NotificationModule_DestroyContext(NotificationModuleContextHandle context) {
+    if (context == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    uint32_t rejected = context->rejectedCount.load(std::memory_order_relaxed);
+    if (rejected > 0) {
+        DEBUG_FUNCTION_LINE_WARN("Context \"%s\" has rejected %d notifications", context->name, (int) rejected);
+    }
+    // Notifications that are still in flight keep the context alive until their callback has been called.
+    ReleaseContext(context);
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+#undef NotificationModule_SetContextDefaultValue
+NotificationModuleStatus NotificationModule_SetContextDefaultValue(NotificationModuleContextHandle context,
+                                                                   NotificationModuleNotificationType type,
+                                                                   NotificationModuleNotificationOption optionType,
+                                                                   ...) {
+    if (context == nullptr || type < 0 || type >= MAX_NOTIFICATION_TYPES) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+
+    va_list va;
+    va_start(va, optionType);
+    auto res = NotificationModule_SetDefaultValueV(context->defaultValues[type], optionType, va);
+    va_end(va);
+
+    return res;
+}
+
+static NotificationModuleStatus AddStaticNotificationInContext(NotificationModuleContextHandle context,
+                                                               NotificationModuleNotificationType type,
+                                                               const char *text) {
+    if (!NotificationModule_IsLibInitialized()) {
+        return NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED;
+    }
+    if (context == nullptr || text == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    auto res = AdmitNotification(context);
+    if (res != NOTIFICATION_MODULE_RESULT_SUCCESS) {
+        return res;
+    }
+
+    const auto &cur       = context->defaultValues[type];
+    auto callback         = cur.finishFunc;
+    void *callbackContext = cur.finishFuncContext;
+    InFlightRecord *record;
+    if ((res = WrapCallback(context, callback, callbackContext, record)) != NOTIFICATION_MODULE_RESULT_SUCCESS) {
+        RevertAdmission(context, nullptr);
+        return res;
+    }
+
+    if (type == NOTIFICATION_MODULE_NOTIFICATION_TYPE_ERROR) {
+        res = NotificationModule_AddErrorNotificationEx(text,
+                                                        cur.durationBeforeFadeOutInSeconds,
+                                                        cur.shakeDurationOnErrorInSeconds,
+                                                        cur.textColor,
+                                                        cur.backgroundColor,
+                                                        callback,
+                                                        callbackContext,
+                                                        cur.keepUntilShown);
+    } else {
+        res = NotificationModule_AddInfoNotificationEx(text,
+                                                       cur.durationBeforeFadeOutInSeconds,
+                                                       cur.textColor,
+                                                       cur.backgroundColor,
+                                                       callback,
+                                                       callbackContext,
+                                                       cur.keepUntilShown);
+    }
+    if (res != NOTIFICATION_MODULE_RESULT_SUCCESS) {
+        RevertAdmission(context, record);
+    }
+    return res;
+}
+
+NotificationModuleStatus NotificationModule_AddInfoNotificationInContext(NotificationModuleContextHandle context, const char *text) {
+    return AddStaticNotificationInContext(context, NOTIFICATION_MODULE_NOTIFICATION_TYPE_INFO, text);
+}
+
+NotificationModuleStatus NotificationModule_AddErrorNotificationInContext(NotificationModuleContextHandle context, const char *text) {
+    return AddStaticNotificationInContext(context, NOTIFICATION_MODULE_NOTIFICATION_TYPE_ERROR, text);
+}
+
+NotificationModuleStatus NotificationModule_AddDynamicNotificationInContext(NotificationModuleContextHandle context,
+                                                                            const char *text,
+                                                                            NotificationModuleHandle *outHandle) {
+    if (!NotificationModule_IsLibInitialized()) {
+        return NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED;
+    }
+    if (context == nullptr || text == nullptr || outHandle == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    auto res = AdmitNotification(context);
+    if (res != NOTIFICATION_MODULE_RESULT_SUCCESS) {
+        return res;
+    }
+
+    const auto &cur       = context->defaultValues[NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC];
+    auto callback         = cur.finishFunc;
+    void *callbackContext = cur.finishFuncContext;
+    InFlightRecord *record;
+    if ((res = WrapCallback(context, callback, callbackContext, record)) != NOTIFICATION_MODULE_RESULT_SUCCESS) {
+        RevertAdmission(context, nullptr);
+        return res;
+    }
+
+    NMNotificationDesc desc = {};
+    desc.size               = sizeof(NMNotificationDesc);
+    desc.type               = NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC;
+    desc.text               = text;
+    desc.textColor          = cur.textColor;
+    desc.backgroundColor    = cur.backgroundColor;
+    desc.callback           = callback;
+    desc.callbackContext    = callbackContext;
+    desc.keepUntilShown     = cur.keepUntilShown;
+    // The watchdog uses the inactivity timeout of the context.
+    res = NotificationModule_AddDynamicNotificationWithDefaults(desc, cur, outHandle);
+    if (res != NOTIFICATION_MODULE_RESULT_SUCCESS) {
+        RevertAdmission(context, record);
+    }
+    return res;
+}
@@ -0,0 +1,432 @@
+#include "deferred_notifications.h"
+#include "internal.h"
+#include "scheduler.h"
+#include "stats.h"
+#include "templates.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <notifications/notifications.h>
+#include <stdarg.h>
+#include <stddef.h>
+
+// Number of records in the arena, notifications are dropped while all of them are in use.
+#define DEFERRED_MAX_RECORDS          64
+// Space for the captured arguments of a record, strings are truncated if they don't fit.
+#define DEFERRED_RECORD_DATA_SIZE     128
+#define DEFERRED_MAX_ARGS             8
+#define DEFERRED_FORMAT_CACHE_SIZE    32
+#define DEFERRED_FLUSH_INTERVAL_IN_US 16667
+
+enum DeferredArgKind : uint8_t {
+    DEFERRED_ARG_KIND_INT,
+    DEFERRED_ARG_KIND_LONG,
+    DEFERRED_ARG_KIND_LONG_LONG,
+    DEFERRED_ARG_KIND_SIZE,
+    DEFERRED_ARG_KIND_DOUBLE,
+    DEFERRED_ARG_KIND_STRING,
+    DEFERRED_ARG_KIND_POINTER,
+};
+
+// Argument kinds of a format string, looked up by the address of the format. The contents are not compared, formats
+// must not change while the library is initialized (see NotificationModule_AddInfoNotificationDeferred).
+struct DeferredFormat {
+    const char *format;
+    bool supported;
+    uint8_t numArgs;
+    DeferredArgKind args[DEFERRED_MAX_ARGS];
+};
+
+struct DeferredRecord {
+    const char *format;
+    NotificationModuleNotificationType type;
+    uint32_t size;
+    uint8_t data[DEFERRED_RECORD_DATA_SIZE];
+};
+
+static std::mutex sDeferredMutex;
+static DeferredFormat sFormatCache[DEFERRED_FORMAT_CACHE_SIZE];
+static DeferredRecord sRecords[DEFERRED_MAX_RECORDS];
+// Hashes of the format and data of sRecords, so queued records can be compared without touching them.
+static uint32_t sRecordHashes[DEFERRED_MAX_RECORDS];
+static uint32_t sRecordsHead           = 0;
+static uint32_t sRecordsCount          = 0;
+static SchedulerTaskId sDeferredTaskId = 0;
+
+/**
+ * Parses the conversion specification that starts at `spec` (right after the '%').
+ * Returns a pointer behind the specification or NULL if it's not supported. `outHasArg` is false for "%%".
+ */
+static const char *ParseSpec(const char *spec, bool *outHasArg, DeferredArgKind *outKind) {
+    const char *cur = spec;
+    if (*cur == '%') {
+        *outHasArg = false;
+        return cur + 1;
+    }
+    while (*cur == '-' || *cur == '+' || *cur == ' ' || *cur == '#' || *cur == '0') {
+        cur++;
+    }
+    while (*cur >= '0' && *cur <= '9') {
+        cur++;
+    }
+    if (*cur == '.') {
+        cur++;
+        while (*cur >= '0' && *cur <= '9') {
+            cur++;
+        }
+    }
+    int longCount = 0;
+    bool isSize   = false;
+    if (*cur == 'h') {
+        cur += cur[1] == 'h' ? 2 : 1;
+    } else if (*cur == 'l') {
+        longCount = cur[1] == 'l' ? 2 : 1;
+        cur += longCount;
+    } else if (*cur == 'z') {
+        isSize = true;
+        cur++;
+    }
+
+    *outHasArg = true;
+    switch (*cur) {
+        case 'd':
+        case 'i':
+        case 'u':
+        case 'x':
+        case 'X':
+        case 'o':
+        case 'c':
+            *outKind = isSize ? DEFERRED_ARG_KIND_SIZE : longCount == 2 ? DEFERRED_ARG_KIND_LONG_LONG
+                                                     : longCount == 1   ? DEFERRED_ARG_KIND_LONG
+                                                                        : DEFERRED_ARG_KIND_INT;
+            return cur + 1;
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+            *outKind = DEFERRED_ARG_KIND_DOUBLE;
+            return cur + 1;
+        case 's':
+            *outKind = DEFERRED_ARG_KIND_STRING;
+            return longCount == 0 && !isSize ? cur + 1 : nullptr;
+        case 'p':
+            *outKind = DEFERRED_ARG_KIND_POINTER;
+            return cur + 1;
+        default:
+            // '*' width/precision, %n, wide strings, ...
+            return nullptr;
+    }
+}
+
+// Has to be called while holding sDeferredMutex.
+static const DeferredFormat &GetFormat(const char *format) {
+    auto &entry = sFormatCache[((uintptr_t) format >> 2) % DEFERRED_FORMAT_CACHE_SIZE];
+    if (entry.format == format) {
+        return entry;
+    }
+    entry.format    = format;
+    entry.supported = true;
+    entry.numArgs   = 0;
+    for (const char *cur = format; *cur != '\0';) {
+        if (*cur++ != '%') {
+            continue;
+        }
+        bool hasArg;
+        DeferredArgKind kind;
+        cur = ParseSpec(cur, &hasArg, &kind);
+        if (cur == nullptr || (hasArg && entry.numArgs == DEFERRED_MAX_ARGS)) {
+            entry.supported = false;
+            break;
+        }
+        if (hasArg) {
+            entry.args[entry.numArgs++] = kind;
+        }
+    }
+    return entry;
+}
+
+template<typename T>
+static bool WriteValue(DeferredRecord &record, T value) {
+    if (record.size + sizeof(T) > sizeof(record.data)) {
+        return false;
+    }
+    memcpy(record.data + record.size, &value, sizeof(T));
+    record.size += sizeof(T);
+    return true;
+}
+
+// Values beyond the captured ones are read as 0. That only happens if the contents of the format have changed since
+// the arguments were captured, which isn't allowed, but must not read past the record.
+template<typename T>
+static T ReadValue(const DeferredRecord &record, uint32_t &offset) {
+    T value = {};
+    if (offset + sizeof(T) <= record.size) {
+        memcpy(&value, record.data + offset, sizeof(T));
+    }
+    offset += sizeof(T);
+    return value;
+}
+
+static uint32_t HashData(const uint8_t *data, uint32_t size) {
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (uint32_t i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// Copies the arguments into the record. Returns false if they don't fit.
+static bool CaptureArgs(const DeferredFormat &format, DeferredRecord &record, va_list va) {
+    record.size = 0;
+    for (uint32_t i = 0; i < format.numArgs; i++) {
+        bool ok = true;
+        switch (format.args[i]) {
+            case DEFERRED_ARG_KIND_INT:
+                ok = WriteValue(record, va_arg(va, int));
+                break;
+            case DEFERRED_ARG_KIND_LONG:
+                ok = WriteValue(record, va_arg(va, long));
+                break;
+            case DEFERRED_ARG_KIND_LONG_LONG:
+                ok = WriteValue(record, va_arg(va, long long));
+                break;
+            case DEFERRED_ARG_KIND_SIZE:
+                ok = WriteValue(record, va_arg(va, size_t));
+                break;
+            case DEFERRED_ARG_KIND_DOUBLE:
+                ok = WriteValue(record, va_arg(va, double));
+                break;
+            case DEFERRED_ARG_KIND_POINTER:
+                ok = WriteValue(record, va_arg(va, void *));
+                break;
+            case DEFERRED_ARG_KIND_STRING: {
+                // Strings are copied with a length prefix and truncated to the remaining space.
+                const char *str = va_arg(va, const char *);
+                if (str == nullptr) {
+                    str = "(null)";
+                }
+                if (record.size + 1 > sizeof(record.data)) {
+                    return false;
+                }
+                uint32_t length = strnlen(str, sizeof(record.data) - record.size - 1);
+                record.data[record.size++] = (uint8_t) length;
+                memcpy(record.data + record.size, str, length);
+                record.size += length;
+                break;
+            }
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void RenderRecord(const DeferredRecord &record, char *outBuffer, uint32_t bufferSize) {
+    uint32_t written = 0;
+    uint32_t offset  = 0;
+    auto append      = [&](int res) {
+        if (res > 0) {
+            written = std::min(written + (uint32_t) res, bufferSize - 1);
+        }
+    };
+    for (const char *cur = record.format; *cur != '\0' && written < bufferSize - 1;) {
+        if (*cur != '%') {
+            outBuffer[written++] = *cur++;
+            continue;
+        }
+        bool hasArg;
+        DeferredArgKind kind;
+        const char *end = ParseSpec(cur + 1, &hasArg, &kind);
+        if (!hasArg) {
+            outBuffer[written++] = '%';
+            cur                  = end;
+            continue;
+        }
+        char spec[32];
+        uint32_t specLength = std::min((uint32_t) (end - cur), (uint32_t) sizeof(spec) - 1);
+        memcpy(spec, cur, specLength);
+        spec[specLength] = '\0';
+        char *out        = outBuffer + written;
+        uint32_t space   = bufferSize - written;
+        switch (kind) {
+            case DEFERRED_ARG_KIND_INT:
+                append(snprintf(out, space, spec, ReadValue<int>(record, offset)));
+                break;
+            case DEFERRED_ARG_KIND_LONG:
+                append(snprintf(out, space, spec, ReadValue<long>(record, offset)));
+                break;
+            case DEFERRED_ARG_KIND_LONG_LONG:
+                append(snprintf(out, space, spec, ReadValue<long long>(record, offset)));
+                break;
+            case DEFERRED_ARG_KIND_SIZE:
+                append(snprintf(out, space, spec, ReadValue<size_t>(record, offset)));
+                break;
+            case DEFERRED_ARG_KIND_DOUBLE:
+                append(snprintf(out, space, spec, ReadValue<double>(record, offset)));
+                break;
+            case DEFERRED_ARG_KIND_POINTER:
+                append(snprintf(out, space, spec, ReadValue<void *>(record, offset)));
+                break;
+            case DEFERRED_ARG_KIND_STRING: {
+                char str[DEFERRED_RECORD_DATA_SIZE];
+                uint32_t length = offset < record.size ? std::min<uint32_t>(record.data[offset], record.size - offset - 1) : 0;
+                offset++;
+                memcpy(str, record.data + offset, length);
+                str[length] = '\0';
+                offset += length;
+                append(snprintf(out, space, spec, str));
+                break;
+            }
+        }
+        cur = end;
+    }
+    outBuffer[written] = '\0';
+}
+
+static void AddRecord(const DeferredRecord &record) {
+    char text[NOTIFICATION_TEMPLATE_MAX_TEXT_LENGTH];
+    RenderRecord(record, text, sizeof(text));
+    if (record.type == NOTIFICATION_MODULE_NOTIFICATION_TYPE_ERROR) {
+        NotificationModule_AddErrorNotification(text);
+    } else {
+        NotificationModule_AddInfoNotification(text);
+    }
+}
+
+// Takes the oldest record out of the arena, returns false if it's empty.
+static bool PopRecord(DeferredRecord &outRecord) {
+    std::lock_guard<std::mutex> lock(sDeferredMutex);
+    if (sRecordsCount == 0) {
+        return false;
+    }
+    const auto &record = sRecords[sRecordsHead];
+    outRecord.format   = record.format;
+    outRecord.type     = record.type;
+    outRecord.size     = record.size;
+    memcpy(outRecord.data, record.data, record.size);
+    sRecordsHead = (sRecordsHead + 1) % DEFERRED_MAX_RECORDS;
+    sRecordsCount--;
+    return true;
+}
+
+static uint32_t DeferredFlushTask(void *, uint64_t) {
+    // Records stay in the arena (and new ones are dropped) while the overlay is busy.
+    uint32_t delayInMs = 0;
+    if (NotificationModule_GetThrottleDelay(&delayInMs) == NOTIFICATION_MODULE_RESULT_SUCCESS && delayInMs > 0) {
+        return delayInMs * 1000;
+    }
+
+    DeferredRecord record;
+    while (PopRecord(record)) {
+        AddRecord(record);
+    }
+
+    std::lock_guard<std::mutex> lock(sDeferredMutex);
+    if (sRecordsCount == 0) {
+        sDeferredTaskId = 0;
+        return 0;
+    }
+    return DEFERRED_FLUSH_INTERVAL_IN_US;
+}
+
+void DeferredNotifications_Flush() {
+    DeferredRecord record;
+    while (PopRecord(record)) {
+        AddRecord(record);
+    }
+    std::lock_guard<std::mutex> lock(sDeferredMutex);
+    // The scheduler task is removed by Scheduler_Shutdown.
+    sDeferredTaskId = 0;
+}
+
+// Returns false if the arguments can't be captured, `outRes` is set otherwise.
+static bool QueueRecord(NotificationModuleNotificationType type, const char *format, va_list va, NotificationModuleStatus *outRes) {
+    DeferredRecord record;
+    record.format = format;
+    record.type   = type;
+
+    std::lock_guard<std::mutex> lock(sDeferredMutex);
+    const auto &parsedFormat = GetFormat(format);
+    if (!parsedFormat.supported || !CaptureArgs(parsedFormat, record, va)) {
+        return false;
+    }
+    *outRes = NOTIFICATION_MODULE_RESULT_SUCCESS;
+    // Identical notifications that are still queued are only shown once.
+    uint32_t hash = HashData(record.data, record.size) ^ (uint32_t) (uintptr_t) format ^ (uint32_t) type;
+    for (uint32_t i = 0; i < DEFERRED_MAX_RECORDS; i++) {
+        if (sRecordHashes[i] != hash || (i - sRecordsHead) % DEFERRED_MAX_RECORDS >= sRecordsCount) {
+            continue;
+        }
+        const auto &cur = sRecords[i];
+        if (cur.format == record.format && cur.type == record.type && cur.size == record.size && memcmp(cur.data, record.data, record.size) == 0) {
+            Stats_RecordCoalesced();
+            return true;
+        }
+    }
+    if (sRecordsCount == DEFERRED_MAX_RECORDS) {
+        Stats_RecordSuppressed();
+        *outRes = NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED;
+        return true;
+    }
+    uint32_t index       = (sRecordsHead + sRecordsCount) % DEFERRED_MAX_RECORDS;
+    sRecordHashes[index] = hash;
+    auto &slot           = sRecords[index];
+    slot.format          = record.format;
+    slot.type            = record.type;
+    slot.size            = record.size;
+    memcpy(slot.data, record.data, record.size);
+    sRecordsCount++;
+
+    if (sDeferredTaskId == 0) {
+        sDeferredTaskId = Scheduler_AddTask(DeferredFlushTask, nullptr, 0);
+    }
+    return true;
+}
+
+static NotificationModuleStatus AddDeferredNotification(NotificationModuleNotificationType type, const char *format, va_list va) {
+    if (!NotificationModule_IsLibInitialized()) {
+        return NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED;
+    }
+    if (format == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+
+    NotificationModuleStatus res;
+    va_list capture;
+    va_copy(capture, va);
+    bool queued = QueueRecord(type, format, capture, &res);
+    va_end(capture);
+    if (queued) {
+        return res;
+    }
+
+    // Formats that can't be captured (e.g. "%*d" or too many arguments) are formatted right away.
+    char text[NOTIFICATION_TEMPLATE_MAX_TEXT_LENGTH];
+    vsnprintf(text, sizeof(text), format, va);
+    if (type == NOTIFICATION_MODULE_NOTIFICATION_TYPE_ERROR) {
+        return NotificationModule_AddErrorNotification(text);
+    }
+    return NotificationModule_AddInfoNotification(text);
+}
+
+NotificationModuleStatus NotificationModule_AddInfoNotificationDeferred(const char *format, ...) {
+    va_list va;
+    va_start(va, format);
+    auto res = AddDeferredNotification(NOTIFICATION_MODULE_NOTIFICATION_TYPE_INFO, format, va);
+    va_end(va);
+    return res;
+}
+
+NotificationModuleStatus NotificationModule_AddErrorNotificationDeferred(const char *format, ...) {
+    va_list va;
+    va_start(va, format);
+    auto res = AddDeferredNotification(NOTIFICATION_MODULE_NOTIFICATION_TYPE_ERROR, format, va);
+    va_end(va);
+    return res;
+}
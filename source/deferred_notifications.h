@@ -0,0 +1,7 @@
+#pragma once
+
+/**
+ * Adds all deferred notifications that are still queued. Called by NotificationModule_DeInitLibrary before the
+ * scheduler is shut down.
+ */
+void DeferredNotifications_Flush();
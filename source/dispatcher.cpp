@@ -0,0 +1,352 @@
+#include "dispatcher.h"
+#include "handle_table.h"
+#include "internal.h"
+#include "logger.h"
+#include "scheduler.h"
+#include "stats.h"
+#include "watchdog.h"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <notifications/notifications.h>
+#include <vector>
+
+#define DISPATCHER_FRAME_DURATION_IN_US  16667
+// Adds and updates fail with NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED while this many operations are queued.
+// Finishing a notification is always queued, otherwise it might never fade out.
+#define DISPATCHER_MAX_QUEUED_OPS        256
+#define DISPATCHER_MAX_RETRY_DELAY_IN_MS 60000
+
+static std::mutex sDispatcherMutex;
+static std::deque<DispatcherOp> sDispatcherQueue;
+static std::atomic<bool> sDispatcherActive{false};
+// Handles (0 for static notifications) whose next operation has to wait, only used by DispatcherTask.
+static std::vector<NotificationModuleHandle> sDispatcherBlockedHandles;
+static SchedulerTaskId sDispatcherTaskId    = 0;
+static uint32_t sDispatcherMaxCalls         = 0;
+static uint32_t sDispatcherMaxTimeInUs      = 0;
+static uint32_t sDispatcherDeferredCount    = 0;
+static uint32_t sDispatcherCoalescedCount   = 0;
+static NMRetryPolicy sDispatcherRetryPolicy = {};
+static uint32_t sDispatcherRandomState      = 0;
+
+// Token buckets for the call and time budget. Tokens are scaled by DISPATCHER_FRAME_DURATION_IN_US, so refilling
+// `max` tokens per frame is `max` scaled tokens per microsecond. The time bucket may go negative, a slow call
+// delays the following ones.
+static int64_t sDispatcherCallTokens      = 0;
+static int64_t sDispatcherTimeTokens      = 0;
+static uint64_t sDispatcherLastRefillInUs = 0;
+
+// Has to be called while holding sDispatcherMutex.
+static void UpdateActive() {
+    sDispatcherActive = sDispatcherMaxCalls != 0 || sDispatcherMaxTimeInUs != 0 || !sDispatcherQueue.empty();
+}
+
+// Has to be called while holding sDispatcherMutex.
+static void RefillTokens(uint64_t nowInUs) {
+    int64_t elapsedInUs       = (int64_t) std::min<uint64_t>(nowInUs - sDispatcherLastRefillInUs, DISPATCHER_FRAME_DURATION_IN_US);
+    sDispatcherLastRefillInUs = nowInUs;
+    sDispatcherCallTokens     = std::min<int64_t>(sDispatcherCallTokens + elapsedInUs * sDispatcherMaxCalls,
+                                                  (int64_t) sDispatcherMaxCalls * DISPATCHER_FRAME_DURATION_IN_US);
+    sDispatcherTimeTokens     = std::min<int64_t>(sDispatcherTimeTokens + elapsedInUs * sDispatcherMaxTimeInUs,
+                                                  (int64_t) sDispatcherMaxTimeInUs * DISPATCHER_FRAME_DURATION_IN_US);
+}
+
+// Has to be called while holding sDispatcherMutex. Takes a call token if the budget allows another call.
+static bool TakeToken() {
+    if (sDispatcherMaxTimeInUs != 0 && sDispatcherTimeTokens <= 0) {
+        return false;
+    }
+    if (sDispatcherMaxCalls != 0) {
+        if (sDispatcherCallTokens < DISPATCHER_FRAME_DURATION_IN_US) {
+            return false;
+        }
+        sDispatcherCallTokens -= DISPATCHER_FRAME_DURATION_IN_US;
+    }
+    return true;
+}
+
+// Has to be called while holding sDispatcherMutex. Returns the last queued operation that has to run before `op`,
+// or nullptr if there is none. Static notifications that are waiting for a retry don't hold back other static
+// notifications.
+static DispatcherOp *FindPredecessor(const DispatcherOp &op) {
+    for (auto it = sDispatcherQueue.rbegin(); it != sDispatcherQueue.rend(); ++it) {
+        if (op.handle != 0 ? it->handle == op.handle : it->type == DISPATCHER_OP_TYPE_ADD_STATIC && it->attempts == 0) {
+            return &*it;
+        }
+    }
+    return nullptr;
+}
+
+// Has to be called while holding sDispatcherMutex. Returns true if an add that has failed with `res` after
+// `attempts` attempts should be tried again.
+static bool ShouldRetry(NotificationModuleStatus res, uint32_t attempts) {
+    if (res != NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED && res != NOTIFICATION_MODULE_RESULT_OVERLAY_NOT_READY) {
+        return false;
+    }
+    return attempts < sDispatcherRetryPolicy.maxAttempts;
+}
+
+// Has to be called while holding sDispatcherMutex. Exponential backoff, `jitter` of the delay is random so
+// notifications that failed at the same time are not retried at the same time.
+static uint32_t GetRetryDelayInUs(uint32_t attempts) {
+    uint64_t delayInMs = sDispatcherRetryPolicy.initialDelayInMs;
+    for (uint32_t i = 1; i < attempts && delayInMs < sDispatcherRetryPolicy.maxDelayInMs; i++) {
+        delayInMs *= 2;
+    }
+    delayInMs = std::min<uint64_t>(delayInMs, sDispatcherRetryPolicy.maxDelayInMs);
+
+    // xorshift32, good enough for jitter.
+    sDispatcherRandomState ^= sDispatcherRandomState << 13;
+    sDispatcherRandomState ^= sDispatcherRandomState >> 17;
+    sDispatcherRandomState ^= sDispatcherRandomState << 5;
+    float random = (float) (sDispatcherRandomState >> 8) / (float) (1 << 24);
+    return (uint32_t) ((float) (delayInMs * 1000) * (1.0f - sDispatcherRetryPolicy.jitter * random));
+}
+
+// Has to be called without holding sDispatcherMutex. Tells the owner of an add that has been dropped for good that the
+// notification is gone, e.g. so a context can release its in-flight slot. The caller got
+// NOTIFICATION_MODULE_RESULT_SUCCESS for it, so this is the only way it learns about it.
+static void NotifyDroppedAdd(const DispatcherOp &op) {
+    if (op.type == DISPATCHER_OP_TYPE_ADD_DYNAMIC) {
+        // Reserved handles are already watched, see AddDynamicNotification.
+        Watchdog_Untrack(op.handle);
+        // Releases the reserved slot and calls the finish callback of the handle.
+        HandleTable_FinishedCallback(0, (void *) (uintptr_t) op.handle);
+    } else if (op.callback != nullptr) {
+        op.callback(0, op.callbackContext);
+    }
+}
+
+static bool IsBlocked(NotificationModuleHandle handle) {
+    return std::find(sDispatcherBlockedHandles.begin(), sDispatcherBlockedHandles.end(), handle) != sDispatcherBlockedHandles.end();
+}
+
+static uint32_t DispatcherTask(void *, uint64_t nowInUs) {
+    static std::vector<DispatcherOp> droppedAdds;
+    droppedAdds.clear();
+    std::unique_lock<std::mutex> lock(sDispatcherMutex);
+    RefillTokens(nowInUs);
+    // Without a budget (e.g. after it has been removed) all operations that are due are executed at once.
+    bool hasBudget       = sDispatcherMaxCalls != 0 || sDispatcherMaxTimeInUs != 0;
+    uint64_t nextRunInUs = UINT64_MAX;
+    sDispatcherBlockedHandles.clear();
+    for (size_t i = 0; i < sDispatcherQueue.size();) {
+        // Other threads only append to the queue, so the reference stays valid while the lock is released.
+        auto &op = sDispatcherQueue[i];
+        if (IsBlocked(op.handle)) {
+            i++;
+            continue;
+        }
+        if (op.notBeforeInUs > nowInUs) {
+            // Waiting for a retry, the following operations of a dynamic notification have to wait as well.
+            if (op.handle != 0) {
+                sDispatcherBlockedHandles.push_back(op.handle);
+            }
+            nextRunInUs = std::min(nextRunInUs, op.notBeforeInUs);
+            i++;
+            continue;
+        }
+        if (hasBudget && !TakeToken()) {
+            nextRunInUs = std::min<uint64_t>(nextRunInUs, nowInUs + DISPATCHER_FRAME_DURATION_IN_US);
+            break;
+        }
+        op.executing = true;
+        lock.unlock();
+        auto res = NotificationModule_ExecuteQueuedOp(op);
+        lock.lock();
+        op.executing = false;
+        if (res != NOTIFICATION_MODULE_RESULT_SUCCESS && (op.type == DISPATCHER_OP_TYPE_ADD_STATIC || op.type == DISPATCHER_OP_TYPE_ADD_DYNAMIC)) {
+            op.attempts++;
+            if (ShouldRetry(res, op.attempts)) {
+                op.notBeforeInUs = Scheduler_GetTimeInUs() + GetRetryDelayInUs(op.attempts);
+                if (op.handle != 0) {
+                    sDispatcherBlockedHandles.push_back(op.handle);
+                }
+                nextRunInUs = std::min(nextRunInUs, op.notBeforeInUs);
+                i++;
+                continue;
+            }
+            DEBUG_FUNCTION_LINE_WARN("Queued add for handle %08X failed: %d", op.handle, res);
+            droppedAdds.push_back(std::move(op));
+        } else if (res != NOTIFICATION_MODULE_RESULT_SUCCESS) {
+            DEBUG_FUNCTION_LINE_WARN("Queued operation %d for handle %08X failed: %d", op.type, op.handle, res);
+        }
+        sDispatcherQueue.erase(sDispatcherQueue.begin() + i);
+    }
+    uint32_t delay = 0;
+    if (sDispatcherQueue.empty()) {
+        sDispatcherTaskId = 0;
+        UpdateActive();
+    } else {
+        nowInUs = Scheduler_GetTimeInUs();
+        delay   = nextRunInUs > nowInUs ? (uint32_t) std::min<uint64_t>(nextRunInUs - nowInUs, DISPATCHER_MAX_RETRY_DELAY_IN_MS * 1000) : 1;
+    }
+    lock.unlock();
+
+    // The callbacks might add or update notifications, which needs the lock.
+    for (const auto &op : droppedAdds) {
+        NotifyDroppedAdd(op);
+    }
+    return delay;
+}
+
+// Has to be called while holding sDispatcherMutex.
+static bool EnsureTask(uint32_t delayInUs) {
+    if (sDispatcherTaskId == 0) {
+        sDispatcherTaskId = Scheduler_AddTask(DispatcherTask, nullptr, delayInUs);
+        return sDispatcherTaskId != 0;
+    }
+    Scheduler_RunTaskEarlier(sDispatcherTaskId, delayInUs);
+    return true;
+}
+
+bool Dispatcher_IsActive() {
+    return sDispatcherActive;
+}
+
+bool Dispatcher_TryQueue(DispatcherOp &op, bool handleIsValid, NotificationModuleStatus *outRes) {
+    std::lock_guard<std::mutex> lock(sDispatcherMutex);
+    auto *predecessor = FindPredecessor(op);
+    if (predecessor == nullptr) {
+        if (!handleIsValid) {
+            return false;
+        }
+        RefillTokens(Scheduler_GetTimeInUs());
+        if (TakeToken()) {
+            return false;
+        }
+    }
+    *outRes = NOTIFICATION_MODULE_RESULT_SUCCESS;
+    // Consecutive updates of a handle are merged, only the latest value of each field is sent to the module.
+    if (op.type == DISPATCHER_OP_TYPE_UPDATE && predecessor != nullptr && predecessor->type == DISPATCHER_OP_TYPE_UPDATE && !predecessor->executing) {
+        if (op.fieldMask & NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_TEXT) {
+            predecessor->text = std::move(op.text);
+        }
+        if (op.fieldMask & NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_TEXT_COLOR) {
+            predecessor->textColor = op.textColor;
+        }
+        if (op.fieldMask & NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_BACKGROUND_COLOR) {
+            predecessor->backgroundColor = op.backgroundColor;
+        }
+        predecessor->fieldMask |= op.fieldMask;
+        sDispatcherDeferredCount++;
+        sDispatcherCoalescedCount++;
+        Stats_RecordCoalesced();
+        return true;
+    }
+    if (sDispatcherQueue.size() >= DISPATCHER_MAX_QUEUED_OPS && op.type != DISPATCHER_OP_TYPE_FINISH) {
+        Stats_RecordSuppressed();
+        *outRes = NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED;
+        return true;
+    }
+    if (!EnsureTask(DISPATCHER_FRAME_DURATION_IN_US)) {
+        *outRes = NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED;
+        return true;
+    }
+    sDispatcherQueue.push_back(std::move(op));
+    sDispatcherDeferredCount++;
+    UpdateActive();
+    return true;
+}
+
+bool Dispatcher_QueueRetry(DispatcherOp &op, NotificationModuleStatus res) {
+    std::lock_guard<std::mutex> lock(sDispatcherMutex);
+    op.attempts = 1;
+    if (!ShouldRetry(res, op.attempts) || sDispatcherQueue.size() >= DISPATCHER_MAX_QUEUED_OPS) {
+        return false;
+    }
+    uint32_t delayInUs = GetRetryDelayInUs(op.attempts);
+    op.notBeforeInUs   = Scheduler_GetTimeInUs() + delayInUs;
+    if (!EnsureTask(delayInUs)) {
+        return false;
+    }
+    sDispatcherQueue.push_back(std::move(op));
+    UpdateActive();
+    return true;
+}
+
+void Dispatcher_ChargeTime(uint64_t durationInUs) {
+    std::lock_guard<std::mutex> lock(sDispatcherMutex);
+    if (sDispatcherMaxTimeInUs != 0) {
+        sDispatcherTimeTokens -= (int64_t) std::min<uint64_t>(durationInUs, 1000000) * DISPATCHER_FRAME_DURATION_IN_US;
+    }
+}
+
+void Dispatcher_Reset() {
+    std::deque<DispatcherOp> droppedOps;
+    {
+        std::lock_guard<std::mutex> lock(sDispatcherMutex);
+        droppedOps.swap(sDispatcherQueue);
+        sDispatcherTaskId         = 0;
+        sDispatcherMaxCalls       = 0;
+        sDispatcherMaxTimeInUs    = 0;
+        sDispatcherDeferredCount  = 0;
+        sDispatcherCoalescedCount = 0;
+        sDispatcherRetryPolicy    = {};
+        UpdateActive();
+    }
+    for (const auto &op : droppedOps) {
+        if (op.type == DISPATCHER_OP_TYPE_ADD_STATIC || op.type == DISPATCHER_OP_TYPE_ADD_DYNAMIC) {
+            NotifyDroppedAdd(op);
+        }
+    }
+}
+
+NotificationModuleStatus NotificationModule_SetFrameBudget(uint32_t maxCallsPerFrame, uint32_t maxTimePerFrameInUs) {
+    if (!NotificationModule_IsLibInitialized()) {
+        return NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED;
+    }
+    if (maxCallsPerFrame > 1000 || maxTimePerFrameInUs > DISPATCHER_FRAME_DURATION_IN_US) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    std::lock_guard<std::mutex> lock(sDispatcherMutex);
+    sDispatcherMaxCalls       = maxCallsPerFrame;
+    sDispatcherMaxTimeInUs    = maxTimePerFrameInUs;
+    sDispatcherLastRefillInUs = Scheduler_GetTimeInUs();
+    // Start with a full budget.
+    sDispatcherCallTokens = (int64_t) maxCallsPerFrame * DISPATCHER_FRAME_DURATION_IN_US;
+    sDispatcherTimeTokens = (int64_t) maxTimePerFrameInUs * DISPATCHER_FRAME_DURATION_IN_US;
+    if (sDispatcherTaskId != 0) {
+        Scheduler_RunTaskEarlier(sDispatcherTaskId, 0);
+    }
+    UpdateActive();
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+NotificationModuleStatus NotificationModule_GetFrameBudgetInfo(NMFrameBudgetInfo *outInfo) {
+    if (!NotificationModule_IsLibInitialized()) {
+        return NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED;
+    }
+    if (outInfo == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    std::lock_guard<std::mutex> lock(sDispatcherMutex);
+    outInfo->queued    = sDispatcherQueue.size();
+    outInfo->deferred  = sDispatcherDeferredCount;
+    outInfo->coalesced = sDispatcherCoalescedCount;
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+NotificationModuleStatus NotificationModule_SetRetryPolicy(const NMRetryPolicy *policy) {
+    if (!NotificationModule_IsLibInitialized()) {
+        return NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED;
+    }
+    if (policy != nullptr && policy->maxAttempts > 1) {
+        if (policy->initialDelayInMs == 0 || policy->maxDelayInMs < policy->initialDelayInMs || policy->maxDelayInMs > DISPATCHER_MAX_RETRY_DELAY_IN_MS) {
+            return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+        }
+        if (!(policy->jitter >= 0.0f && policy->jitter <= 1.0f)) {
+            return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+        }
+    }
+    std::lock_guard<std::mutex> lock(sDispatcherMutex);
+    // Queued retries keep their current delay and use the new policy for the next attempt.
+    sDispatcherRetryPolicy = policy != nullptr ? *policy : NMRetryPolicy{};
+    if (sDispatcherRandomState == 0) {
+        sDispatcherRandomState = (uint32_t) Scheduler_GetTimeInUs() | 1;
+    }
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
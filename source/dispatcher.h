@@ -0,0 +1,88 @@
+#pragma once
+
+#include "notifications/notification_defines.h"
+
+#include <string>
+
+/**
+ * Limits the number of module calls (or the time spent in the module) per frame, see NotificationModule_SetFrameBudget.
+ * Operations that exceed the budget are queued and executed on the scheduler thread in later frames. Operations on
+ * a handle are never reordered: once an operation of a handle has been queued, all following operations of that
+ * handle are queued as well. The same applies to static notifications.
+ *
+ * Adds that fail with a transient error are retried from the same queue, see NotificationModule_SetRetryPolicy.
+ * A retry waits for its backoff without blocking operations of other handles.
+ *
+ * The caller got NOTIFICATION_MODULE_RESULT_SUCCESS for a queued add, so an add that is dropped (its last attempt
+ * fails or the queue is reset) calls the finish callback of the notification, as if it had faded out. The handle of
+ * a dropped dynamic notification is released.
+ */
+
+enum DispatcherOpType {
+    DISPATCHER_OP_TYPE_ADD_STATIC,
+    DISPATCHER_OP_TYPE_ADD_DYNAMIC,
+    DISPATCHER_OP_TYPE_UPDATE,
+    DISPATCHER_OP_TYPE_FINISH,
+};
+
+// Parameters of a queued operation. `handle` is the library handle (0 for static notifications), `text` is already
+// sanitized and `fieldMask` is only used by DISPATCHER_OP_TYPE_UPDATE. `attempts`, `notBeforeInUs` and `executing`
+// are managed by the dispatcher.
+struct DispatcherOp {
+    std::string text;
+    DispatcherOpType type                                   = DISPATCHER_OP_TYPE_ADD_STATIC;
+    NotificationModuleHandle handle                         = 0;
+    NotificationModuleNotificationType notificationType     = NOTIFICATION_MODULE_NOTIFICATION_TYPE_INFO;
+    float durationBeforeFadeOutInSeconds                    = 0.0f;
+    float shakeDurationInSeconds                            = 0.0f;
+    NMColor textColor                                       = {};
+    NMColor backgroundColor                                 = {};
+    NotificationModuleNotificationFinishedCallback callback = nullptr;
+    void *callbackContext                                   = nullptr;
+    bool keepUntilShown                                     = false;
+    uint32_t fieldMask                                      = 0;
+    NotificationModuleStatusFinish finishMode               = NOTIFICATION_MODULE_STATUS_FINISH;
+    uint32_t attempts                                       = 0;
+    uint64_t notBeforeInUs                                  = 0;
+    bool executing                                          = false;
+};
+
+/**
+ * Returns true if a frame budget is set or operations are queued. Dispatcher_TryQueue and Dispatcher_ChargeTime
+ * only have to be called while the dispatcher is active.
+ */
+bool Dispatcher_IsActive();
+
+/**
+ * Queues the operation if the budget of the current frame is used up or earlier operations of the same handle are
+ * still queued. Returns false if the operation has to be executed right away, in that case it has been charged to
+ * the budget of the current frame. Otherwise `outRes` is set to the result for the caller.
+ * Operations with a handle that is not valid (`handleIsValid`) are only queued if the handle has queued operations,
+ * e.g. while its creation is still queued.
+ */
+bool Dispatcher_TryQueue(DispatcherOp &op, bool handleIsValid, NotificationModuleStatus *outRes);
+
+/**
+ * Queues a retry of an add that has failed on the caller's thread with `res`, if the retry policy allows it.
+ * Returns false if the error has to be returned to the caller. The handle of a dynamic notification stays reserved
+ * while it's retried.
+ */
+bool Dispatcher_QueueRetry(DispatcherOp &op, NotificationModuleStatus res);
+
+/**
+ * Charges the time of a module call to the budget of the current frame.
+ */
+void Dispatcher_ChargeTime(uint64_t durationInUs);
+
+/**
+ * Executes a queued operation. Called on the scheduler thread, implemented in utils.cpp.
+ * Failed adds of dynamic notifications don't release the handle, that's up to the dispatcher.
+ */
+NotificationModuleStatus NotificationModule_ExecuteQueuedOp(const DispatcherOp &op);
+
+/**
+ * Drops all queued operations and removes the frame budget and the retry policy. The finish callbacks of dropped adds
+ * are called. Has to be called after Scheduler_Shutdown.
+ * Called by NotificationModule_DeInitLibrary.
+ */
+void Dispatcher_Reset();
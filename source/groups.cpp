@@ -0,0 +1,161 @@
+#include "groups.h"
+#include "internal.h"
+#include "scheduler.h"
+#include "stats.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <mutex>
+#include <new>
+#include <notifications/notifications.h>
+#include <vector>
+
+#define GROUP_MAX_TEXT_LENGTH    256
+#define GROUP_MAX_DURATION_IN_US 0xFFFFFFFF
+
+struct _NMGroup {
+    std::mutex mutex;
+    NotificationModuleNotificationType type;
+    // Dynamic notification that shows the messages of this group, 0 if there is none.
+    NotificationModuleHandle handle = 0;
+    uint32_t count                  = 0;
+    uint64_t deadlineInUs           = 0;
+    SchedulerTaskId taskId          = 0;
+};
+
+static std::mutex sGroupsMutex;
+static std::vector<_NMGroup *> sGroups;
+
+// Has to be called while holding the group mutex.
+static void FinishGroupNotification(_NMGroup &group) {
+    if (group.handle != 0) {
+        NotificationModule_FinishDynamicNotification(group.handle, 0.0f);
+        group.handle = 0;
+        group.count  = 0;
+    }
+}
+
+static uint32_t GroupTimeoutTask(void *context, uint64_t nowInUs) {
+    auto *group = (_NMGroup *) context;
+    std::lock_guard<std::mutex> lock(group->mutex);
+    if (group->handle != 0 && nowInUs < group->deadlineInUs) {
+        // A message has been added since the task has been scheduled.
+        return group->deadlineInUs - nowInUs;
+    }
+    FinishGroupNotification(*group);
+    group->taskId = 0;
+    return 0;
+}
+
+void Groups_Reset() {
+    std::lock_guard<std::mutex> lock(sGroupsMutex);
+    for (auto *group : sGroups) {
+        std::lock_guard<std::mutex> groupLock(group->mutex);
+        FinishGroupNotification(*group);
+        // The scheduler task is removed by Scheduler_Shutdown.
+        group->taskId = 0;
+    }
+}
+
+NotificationModuleStatus NotificationModule_CreateGroup(NotificationModuleNotificationType type, NotificationModuleGroupHandle *outGroup) {
+    if (outGroup == nullptr || (type != NOTIFICATION_MODULE_NOTIFICATION_TYPE_INFO && type != NOTIFICATION_MODULE_NOTIFICATION_TYPE_ERROR)) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    auto *group = new (std::nothrow) _NMGroup;
+    if (group == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED;
+    }
+    group->type = type;
+
+    std::lock_guard<std::mutex> lock(sGroupsMutex);
+    sGroups.push_back(group);
+    *outGroup = group;
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+NotificationModuleStatus NotificationModule_DestroyGroup(NotificationModuleGroupHandle group) {
+    if (group == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    {
+        std::lock_guard<std::mutex> lock(sGroupsMutex);
+        auto it = std::find(sGroups.begin(), sGroups.end(), group);
+        if (it == sGroups.end()) {
+            return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+        }
+        sGroups.erase(it);
+    }
+
+    SchedulerTaskId taskId;
+    {
+        std::lock_guard<std::mutex> lock(group->mutex);
+        taskId = group->taskId;
+    }
+    // Must not hold the group mutex here, the task might be waiting for it.
+    if (taskId != 0) {
+        Scheduler_RemoveTask(taskId);
+    }
+    {
+        std::lock_guard<std::mutex> lock(group->mutex);
+        FinishGroupNotification(*group);
+    }
+    delete group;
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+NotificationModuleStatus NotificationModule_AddNotificationToGroup(NotificationModuleGroupHandle group, const char *text) {
+    if (!NotificationModule_IsLibInitialized()) {
+        return NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED;
+    }
+    if (group == nullptr || text == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+
+    auto defaults = NotificationModule_GetDefaultValues(group->type);
+
+    std::lock_guard<std::mutex> lock(group->mutex);
+    auto res = NOTIFICATION_MODULE_RESULT_INVALID_HANDLE;
+    if (group->handle != 0) {
+        char buffer[GROUP_MAX_TEXT_LENGTH];
+        snprintf(buffer, sizeof(buffer), "%s (x%u)", text, group->count + 1);
+        res = NotificationModule_UpdateDynamicNotificationText(group->handle, buffer);
+        if (res == NOTIFICATION_MODULE_RESULT_SUCCESS) {
+            group->count++;
+            Stats_RecordCoalesced();
+        } else if (res == NOTIFICATION_MODULE_RESULT_INVALID_HANDLE) {
+            // The notification is gone (e.g. the application has changed), start a new one.
+            group->handle = 0;
+        } else {
+            return res;
+        }
+    }
+    if (group->handle == 0) {
+        res = NotificationModule_AddDynamicNotificationEx(text,
+                                                          &group->handle,
+                                                          defaults.textColor,
+                                                          defaults.backgroundColor,
+                                                          nullptr,
+                                                          nullptr,
+                                                          false);
+        if (res != NOTIFICATION_MODULE_RESULT_SUCCESS) {
+            group->handle = 0;
+            return res;
+        }
+        group->count = 1;
+    }
+
+    // The notification fades out once no message has been added for `durationBeforeFadeOutInSeconds`. Clamped to the
+    // range of a task delay, converting a larger (or NaN) value to uint32_t is undefined.
+    double durationInSeconds = defaults.durationBeforeFadeOutInSeconds;
+    uint32_t durationInUs    = durationInSeconds > 0.0 ? (uint32_t) std::min(durationInSeconds * 1000000.0, (double) GROUP_MAX_DURATION_IN_US) : 0;
+    group->deadlineInUs      = Scheduler_GetTimeInUs() + durationInUs;
+    if (group->taskId == 0) {
+        group->taskId = Scheduler_AddTask(GroupTimeoutTask, group, durationInUs);
+        if (group->taskId == 0) {
+            // Nothing would ever fade it out.
+            FinishGroupNotification(*group);
+            return NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED;
+        }
+    }
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
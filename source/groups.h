@@ -0,0 +1,6 @@
+#pragma once
+
+/**
+ * Finishes the active notification of every group. Called by NotificationModule_DeInitLibrary.
+ */
+void Groups_Reset();
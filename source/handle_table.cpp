@@ -0,0 +1,189 @@
+#include "handle_table.h"
+
+#include <cstdint>
+#include <mutex>
+
+enum HandleSlotState : uint8_t {
+    HANDLE_SLOT_STATE_FREE,
+    HANDLE_SLOT_STATE_RESERVED,
+    HANDLE_SLOT_STATE_LIVE,
+    HANDLE_SLOT_STATE_FINISHED,
+};
+
+struct HandleSlot {
+    NotificationModuleHandle moduleHandle;
+    NotificationModuleNotificationFinishedCallback callback;
+    void *callbackContext;
+    NotificationModuleTag tag;
+    uint16_t generation;
+    HandleSlotState state;
+};
+
+static std::mutex sHandleTableMutex;
+static std::vector<HandleSlot> sHandleSlots;
+static std::vector<uint16_t> sFreeSlots;
+
+static inline uint16_t SlotGeneration(NotificationModuleHandle handle) {
+    return handle >> 16;
+}
+
+static inline NotificationModuleHandle MakeHandle(uint32_t index, uint16_t generation) {
+    return ((NotificationModuleHandle) generation << 16) | index;
+}
+
+// Has to be called while holding sHandleTableMutex. Returns nullptr if the handle is stale.
+static HandleSlot *GetSlot(NotificationModuleHandle handle) {
+    uint32_t index = HandleTable_GetSlotIndex(handle);
+    if (index >= sHandleSlots.size()) {
+        return nullptr;
+    }
+    auto &slot = sHandleSlots[index];
+    if (slot.state == HANDLE_SLOT_STATE_FREE || slot.generation != SlotGeneration(handle)) {
+        return nullptr;
+    }
+    return &slot;
+}
+
+// Has to be called while holding sHandleTableMutex.
+static void FreeSlot(uint32_t index) {
+    auto &slot = sHandleSlots[index];
+    slot.state = HANDLE_SLOT_STATE_FREE;
+    // Generation 0 is never used, so a handle is never 0.
+    if (++slot.generation == 0) {
+        slot.generation = 1;
+    }
+    sFreeSlots.push_back(index);
+}
+
+NotificationModuleHandle HandleTable_Reserve(NotificationModuleNotificationFinishedCallback callback, void *callbackContext) {
+    std::lock_guard<std::mutex> lock(sHandleTableMutex);
+    uint32_t index;
+    if (!sFreeSlots.empty()) {
+        index = sFreeSlots.back();
+        sFreeSlots.pop_back();
+    } else {
+        if (sHandleSlots.size() >= HANDLE_TABLE_MAX_SLOTS) {
+            return 0;
+        }
+        index = sHandleSlots.size();
+        sHandleSlots.push_back({});
+        sHandleSlots[index].generation = 1;
+        // Reserve the space in the free list as well, so FreeSlot never has to allocate. Following the capacity of
+        // the slots keeps the growth geometric, reserving one more entry every time would copy the list every time.
+        sFreeSlots.reserve(sHandleSlots.capacity());
+    }
+    auto &slot           = sHandleSlots[index];
+    slot.moduleHandle    = 0;
+    slot.callback        = callback;
+    slot.callbackContext = callbackContext;
+    slot.tag             = NOTIFICATION_MODULE_TAG_NONE;
+    slot.state           = HANDLE_SLOT_STATE_RESERVED;
+    return MakeHandle(index, slot.generation);
+}
+
+void HandleTable_Activate(NotificationModuleHandle handle, NotificationModuleHandle moduleHandle) {
+    std::lock_guard<std::mutex> lock(sHandleTableMutex);
+    // The notification might already be gone if the module has called the finish callback in the meantime.
+    auto *slot = GetSlot(handle);
+    if (slot != nullptr && slot->state == HANDLE_SLOT_STATE_RESERVED) {
+        slot->moduleHandle = moduleHandle;
+        slot->state        = HANDLE_SLOT_STATE_LIVE;
+    }
+}
+
+void HandleTable_Release(NotificationModuleHandle handle) {
+    std::lock_guard<std::mutex> lock(sHandleTableMutex);
+    if (GetSlot(handle) != nullptr) {
+        FreeSlot(HandleTable_GetSlotIndex(handle));
+    }
+}
+
+bool HandleTable_Resolve(NotificationModuleHandle handle, NotificationModuleHandle *outModuleHandle) {
+    std::lock_guard<std::mutex> lock(sHandleTableMutex);
+    auto *slot = GetSlot(handle);
+    if (slot == nullptr || slot->state != HANDLE_SLOT_STATE_LIVE) {
+        return false;
+    }
+    *outModuleHandle = slot->moduleHandle;
+    return true;
+}
+
+bool HandleTable_IsOpen(NotificationModuleHandle handle) {
+    std::lock_guard<std::mutex> lock(sHandleTableMutex);
+    auto *slot = GetSlot(handle);
+    return slot != nullptr && (slot->state == HANDLE_SLOT_STATE_RESERVED || slot->state == HANDLE_SLOT_STATE_LIVE);
+}
+
+void HandleTable_MarkFinished(NotificationModuleHandle handle) {
+    std::lock_guard<std::mutex> lock(sHandleTableMutex);
+    auto *slot = GetSlot(handle);
+    if (slot != nullptr && slot->state == HANDLE_SLOT_STATE_LIVE) {
+        slot->state = HANDLE_SLOT_STATE_FINISHED;
+    }
+}
+
+bool HandleTable_SetTag(NotificationModuleHandle handle, NotificationModuleTag tag) {
+    std::lock_guard<std::mutex> lock(sHandleTableMutex);
+    auto *slot = GetSlot(handle);
+    if (slot == nullptr || (slot->state != HANDLE_SLOT_STATE_RESERVED && slot->state != HANDLE_SLOT_STATE_LIVE)) {
+        return false;
+    }
+    slot->tag = tag;
+    return true;
+}
+
+void HandleTable_CollectWithTag(NotificationModuleTag tag,
+                                std::vector<NotificationModuleHandle> &outHandles,
+                                std::vector<NotificationModuleHandle> &outModuleHandles) {
+    std::lock_guard<std::mutex> lock(sHandleTableMutex);
+    for (uint32_t i = 0; i < sHandleSlots.size(); i++) {
+        auto &slot = sHandleSlots[i];
+        if ((slot.state != HANDLE_SLOT_STATE_RESERVED && slot.state != HANDLE_SLOT_STATE_LIVE) || slot.tag != tag) {
+            continue;
+        }
+        outHandles.push_back(MakeHandle(i, slot.generation));
+        outModuleHandles.push_back(slot.moduleHandle);
+    }
+}
+
+void HandleTable_FinishedCallback(NotificationModuleHandle, void *context) {
+    auto handle = (NotificationModuleHandle) (uintptr_t) context;
+    NotificationModuleNotificationFinishedCallback callback;
+    void *callbackContext;
+    {
+        std::lock_guard<std::mutex> lock(sHandleTableMutex);
+        auto *slot = GetSlot(handle);
+        if (slot == nullptr) {
+            return;
+        }
+        callback        = slot->callback;
+        callbackContext = slot->callbackContext;
+        FreeSlot(HandleTable_GetSlotIndex(handle));
+    }
+    if (callback != nullptr) {
+        callback(handle, callbackContext);
+    }
+}
+
+void HandleTable_Reset(std::vector<NotificationModuleHandle> &outLiveModuleHandles, std::vector<NotificationModuleHandle> &outPendingModuleHandles) {
+    std::lock_guard<std::mutex> lock(sHandleTableMutex);
+    // The slots are kept (with a new generation) so handles from before the reset stay invalid.
+    for (uint32_t i = 0; i < sHandleSlots.size(); i++) {
+        auto &slot = sHandleSlots[i];
+        if (slot.state == HANDLE_SLOT_STATE_FREE) {
+            continue;
+        }
+        if (slot.state == HANDLE_SLOT_STATE_LIVE) {
+            outLiveModuleHandles.push_back(slot.moduleHandle);
+        }
+        if (slot.state == HANDLE_SLOT_STATE_LIVE || slot.state == HANDLE_SLOT_STATE_FINISHED) {
+            outPendingModuleHandles.push_back(slot.moduleHandle);
+        }
+        FreeSlot(i);
+    }
+}
+
+uint32_t HandleTable_GetUsedCount() {
+    std::lock_guard<std::mutex> lock(sHandleTableMutex);
+    return sHandleSlots.size() - sFreeSlots.size();
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "notifications/notification_defines.h"
+
+#include <vector>
+
+#define HANDLE_TABLE_MAX_SLOTS 0x10000
+
+/**
+ * Client side slot table of all dynamic notifications created through this library.
+ *
+ * The handles returned to the application are not the handles of the module but encode a slot index (low 16 bits)
+ * and the generation of the slot (high 16 bits). The generation is incremented every time a slot is released, so
+ * handles of finished notifications are rejected in O(1) without calling into the module, even if the module reuses
+ * its handle values.
+ */
+
+/**
+ * Index of the slot of a handle, smaller than HANDLE_TABLE_MAX_SLOTS. Can be used to keep per handle data in a flat array.
+ */
+static inline uint32_t HandleTable_GetSlotIndex(NotificationModuleHandle handle) {
+    return handle & 0xFFFF;
+}
+
+/**
+ * Reserves a slot for a new notification and stores the finish callback of the application.
+ * Returns 0 if the table is full.
+ * The module has to be given HandleTable_FinishedCallback with the returned handle as context.
+ */
+NotificationModuleHandle HandleTable_Reserve(NotificationModuleNotificationFinishedCallback callback, void *callbackContext);
+
+/**
+ * Makes a reserved handle live after the module has created the notification.
+ */
+void HandleTable_Activate(NotificationModuleHandle handle, NotificationModuleHandle moduleHandle);
+
+/**
+ * Releases a slot without calling the finish callback. Used if the module failed to create the notification.
+ */
+void HandleTable_Release(NotificationModuleHandle handle);
+
+/**
+ * Returns the module handle of a live handle. Returns false for unknown, stale or finished handles.
+ */
+bool HandleTable_Resolve(NotificationModuleHandle handle, NotificationModuleHandle *outModuleHandle);
+
+/**
+ * Returns true if the handle is reserved or live, i.e. it has neither been finished nor released.
+ */
+bool HandleTable_IsOpen(NotificationModuleHandle handle);
+
+/**
+ * Marks a handle as finished, it won't be resolved anymore. The slot is released once the module calls the finish callback.
+ */
+void HandleTable_MarkFinished(NotificationModuleHandle handle);
+
+/**
+ * Sets the tag of a reserved or live handle. Returns false if the handle is unknown, stale or finished.
+ */
+bool HandleTable_SetTag(NotificationModuleHandle handle, NotificationModuleTag tag);
+
+/**
+ * Appends all reserved and live handles with the given tag and their module handles to the vectors.
+ * Reserved handles (whose notification hasn't been created yet) have the module handle 0.
+ */
+void HandleTable_CollectWithTag(NotificationModuleTag tag,
+                                std::vector<NotificationModuleHandle> &outHandles,
+                                std::vector<NotificationModuleHandle> &outModuleHandles);
+
+/**
+ * Finish callback that is passed to the module for every dynamic notification. Releases the slot and calls the
+ * callback of the application (if any) with the library handle.
+ */
+void HandleTable_FinishedCallback(NotificationModuleHandle moduleHandle, void *context);
+
+/**
+ * Releases all slots. Called by NotificationModule_DeInitLibrary.
+ * Stores the module handles of all live notifications in `outLiveModuleHandles` and the module handles of all
+ * notifications whose finish callback is still pending (live or finished) in `outPendingModuleHandles`.
+ * Finish callbacks that arrive after the reset are ignored.
+ */
+void HandleTable_Reset(std::vector<NotificationModuleHandle> &outLiveModuleHandles, std::vector<NotificationModuleHandle> &outPendingModuleHandles);
+
+/**
+ * Returns the number of dynamic notifications that have not been released yet, including finished notifications
+ * that are still fading out.
+ */
+uint32_t HandleTable_GetUsedCount();
@@ -0,0 +1,145 @@
+#include "intern_table.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#define INTERN_ARENA_BLOCK_SIZE   4096
+#define INTERN_INITIAL_SLOT_COUNT 64
+#define INTERN_MAX_TEXTS          0xFFFFu
+
+struct InternEntry {
+    const char *text;
+    uint32_t length;
+    uint32_t hash;
+};
+
+static std::mutex sInternMutex;
+// Entry for id `n` is stored at index `n - 1`.
+static std::vector<InternEntry> sInternEntries;
+// Open addressing (linear probing) table of ids, 0 marks an empty slot. Size is always a power of two.
+static std::vector<NotificationModuleTextId> sInternSlots;
+// Strings are never moved or freed, this is what allows the module to reference them without copying.
+static char *sArenaCurrent = nullptr;
+static uint32_t sArenaLeft = 0;
+
+static uint32_t HashText(const char *text, uint32_t *outLength) {
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    const char *p = text;
+    while (*p) {
+        hash ^= (uint8_t) *p++;
+        hash *= 16777619u;
+    }
+    *outLength = p - text;
+    return hash;
+}
+
+static char *ArenaAlloc(uint32_t size) {
+    if (size > sArenaLeft) {
+        uint32_t blockSize = size > INTERN_ARENA_BLOCK_SIZE ? size : INTERN_ARENA_BLOCK_SIZE;
+        auto *block        = (char *) malloc(blockSize);
+        if (block == nullptr) {
+            return nullptr;
+        }
+        sArenaCurrent = block;
+        sArenaLeft    = blockSize;
+    }
+    char *res = sArenaCurrent;
+    sArenaCurrent += size;
+    sArenaLeft -= size;
+    return res;
+}
+
+static void InsertSlot(std::vector<NotificationModuleTextId> &slots, uint32_t hash, NotificationModuleTextId id) {
+    uint32_t mask = slots.size() - 1;
+    uint32_t i    = hash & mask;
+    while (slots[i] != NOTIFICATION_MODULE_TEXT_ID_INVALID) {
+        i = (i + 1) & mask;
+    }
+    slots[i] = id;
+}
+
+static void GrowSlots() {
+    std::vector<NotificationModuleTextId> newSlots;
+    uint32_t newSize = sInternSlots.empty() ? INTERN_INITIAL_SLOT_COUNT : sInternSlots.size() * 2;
+    newSlots.resize(newSize, NOTIFICATION_MODULE_TEXT_ID_INVALID);
+    for (uint32_t i = 0; i < sInternEntries.size(); i++) {
+        InsertSlot(newSlots, sInternEntries[i].hash, i + 1);
+    }
+    sInternSlots.swap(newSlots);
+}
+
+// Has to be called while holding sInternMutex.
+static bool FindLocked(const char *text, uint32_t length, uint32_t hash, NotificationModuleTextId *outId) {
+    if (sInternSlots.empty()) {
+        return false;
+    }
+    uint32_t mask = sInternSlots.size() - 1;
+    for (uint32_t i = hash & mask; sInternSlots[i] != NOTIFICATION_MODULE_TEXT_ID_INVALID; i = (i + 1) & mask) {
+        auto &entry = sInternEntries[sInternSlots[i] - 1];
+        if (entry.hash == hash && entry.length == length && memcmp(entry.text, text, length) == 0) {
+            *outId = sInternSlots[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+NotificationModuleStatus InternTable_Intern(const char *text, NotificationModuleTextId *outId) {
+    if (text == nullptr || outId == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    uint32_t length;
+    uint32_t hash = HashText(text, &length);
+
+    std::lock_guard<std::mutex> lock(sInternMutex);
+    if (FindLocked(text, length, hash, outId)) {
+        return NOTIFICATION_MODULE_RESULT_SUCCESS;
+    }
+
+    if (sInternEntries.size() >= INTERN_MAX_TEXTS) {
+        return NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED;
+    }
+
+    // Keep the load factor below 50% so probe sequences stay short.
+    if ((sInternEntries.size() + 1) * 2 > sInternSlots.size()) {
+        GrowSlots();
+    }
+
+    char *copy = ArenaAlloc(length + 1);
+    if (copy == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED;
+    }
+    memcpy(copy, text, length + 1);
+
+    sInternEntries.push_back({copy, length, hash});
+    NotificationModuleTextId id = sInternEntries.size();
+    InsertSlot(sInternSlots, hash, id);
+
+    *outId = id;
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+bool InternTable_Find(const char *text, NotificationModuleTextId *outId) {
+    if (text == nullptr) {
+        return false;
+    }
+    uint32_t length;
+    uint32_t hash = HashText(text, &length);
+
+    std::lock_guard<std::mutex> lock(sInternMutex);
+    return FindLocked(text, length, hash, outId);
+}
+
+bool InternTable_Lookup(NotificationModuleTextId id, const char **outText, uint32_t *outLength) {
+    std::lock_guard<std::mutex> lock(sInternMutex);
+    if (id == NOTIFICATION_MODULE_TEXT_ID_INVALID || id > sInternEntries.size()) {
+        return false;
+    }
+    auto &entry = sInternEntries[id - 1];
+    *outText    = entry.text;
+    *outLength  = entry.length;
+    return true;
+}
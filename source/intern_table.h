@@ -0,0 +1,20 @@
+#pragma once
+
+#include "notifications/notification_defines.h"
+
+/**
+ * Stores a copy of `text` in the append-only arena and returns its id.
+ * Interning the same text twice returns the same id.
+ */
+NotificationModuleStatus InternTable_Intern(const char *text, NotificationModuleTextId *outId);
+
+/**
+ * Looks up the id of a text without interning it. Returns false if the text has never been interned.
+ */
+bool InternTable_Find(const char *text, NotificationModuleTextId *outId);
+
+/**
+ * Resolves an id returned by InternTable_Intern. The returned pointer stays valid
+ * (and unchanged) until the process exits.
+ */
+bool InternTable_Lookup(NotificationModuleTextId id, const char **outText, uint32_t *outLength);
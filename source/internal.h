@@ -2,6 +2,15 @@
 
 #include "notifications/notification_defines.h"
 
+#include <atomic>
+#include <stdarg.h>
+
+#define MAX_NOTIFICATION_TYPES 3
+
+static_assert(NOTIFICATION_MODULE_NOTIFICATION_TYPE_INFO < MAX_NOTIFICATION_TYPES);
+static_assert(NOTIFICATION_MODULE_NOTIFICATION_TYPE_ERROR < MAX_NOTIFICATION_TYPES);
+static_assert(NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC < MAX_NOTIFICATION_TYPES);
+
 struct NMDefaultValueStore {
     float durationBeforeFadeOutInSeconds                        = 2.0f;
     float shakeDurationOnErrorInSeconds                         = 0.5f;
@@ -10,4 +19,40 @@ struct NMDefaultValueStore {
     void (*finishFunc)(NotificationModuleHandle, void *context) = nullptr;
     void *finishFuncContext                                     = nullptr;
     bool keepUntilShown                                         = false;
-};
\ No newline at end of file
+    float inactivityTimeoutInSeconds                            = 0.0f;
+    NotificationModuleTextId inactivityTimeoutTextId            = NOTIFICATION_MODULE_TEXT_ID_INVALID;
+};
+
+struct _NMContext {
+    char name[32] = {};
+    NMDefaultValueStore defaultValues[MAX_NOTIFICATION_TYPES];
+    uint32_t maxInFlight          = 0;
+    uint32_t emissionIntervalInMs = 0;
+    uint32_t burstToleranceInMs   = 0;
+    std::atomic<uint32_t> inFlight{0};
+    // Generic cell rate algorithm: the token bucket is represented by the time at which it will be full again.
+    std::atomic<uint32_t> theoreticalArrivalTimeInMs{0};
+    std::atomic<uint32_t> rejectedCount{0};
+    std::atomic<uint32_t> refCount{1};
+};
+
+bool NotificationModule_IsLibInitialized();
+
+NMDefaultValueStore NotificationModule_GetDefaultValues(NotificationModuleNotificationType type);
+
+NotificationModuleStatus NotificationModule_SetDefaultValueV(NMDefaultValueStore &cur, NotificationModuleNotificationOption valueType, va_list va);
+
+/**
+ * Adds a dynamic notification like NotificationModule_AddNotification, but takes the inactivity timeout, its text and
+ * the fade out and shake durations of the watchdog from `defaults` instead of the global default values.
+ */
+NotificationModuleStatus NotificationModule_AddDynamicNotificationWithDefaults(const NMNotificationDesc &desc,
+                                                                               const NMDefaultValueStore &defaults,
+                                                                               NotificationModuleHandle *outHandle);
+
+/**
+ * Copies a description of the application into `outDesc`. Fields beyond `desc->size` are set to the default values of
+ * the type, `outDesc.size` is always sizeof(NMNotificationDesc).
+ * Returns false if `desc` is NULL or smaller than NM_NOTIFICATION_DESC_SIZE_V1.
+ */
+bool NotificationModule_NormalizeNotificationDesc(const NMNotificationDesc *desc, NMNotificationDesc &outDesc);
@@ -0,0 +1,128 @@
+#include "keyed_notifications.h"
+#include "handle_table.h"
+#include "intern_table.h"
+#include "internal.h"
+
+#include <mutex>
+#include <notifications/notifications.h>
+#include <string>
+#include <unordered_map>
+
+struct KeyedNotification {
+    NotificationModuleHandle handle = 0;
+    // Content that has been sent last, compared against the next upsert.
+    std::string text;
+    NMColor textColor       = {};
+    NMColor backgroundColor = {};
+};
+
+static std::mutex sKeyedMutex;
+// Keys are interned, so a key is identified by its text id.
+static std::unordered_map<NotificationModuleTextId, KeyedNotification> sKeyedNotifications;
+
+static inline bool ColorEquals(const NMColor &a, const NMColor &b) {
+    return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+
+void KeyedNotifications_Reset() {
+    std::lock_guard<std::mutex> lock(sKeyedMutex);
+    sKeyedNotifications.clear();
+}
+
+NotificationModuleStatus NotificationModule_Upsert(const char *key, const NMNotificationDesc *desc) {
+    if (!NotificationModule_IsLibInitialized()) {
+        return NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED;
+    }
+    NMNotificationDesc normalizedDesc;
+    if (key == nullptr || !NotificationModule_NormalizeNotificationDesc(desc, normalizedDesc) || normalizedDesc.text == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    desc = &normalizedDesc;
+    if (desc->type != NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC) {
+        return NOTIFICATION_MODULE_RESULT_UNSUPPORTED_TYPE;
+    }
+
+    NotificationModuleTextId keyId;
+    auto res = InternTable_Intern(key, &keyId);
+    if (res != NOTIFICATION_MODULE_RESULT_SUCCESS) {
+        return res;
+    }
+
+    // Held while calling into the module, so concurrent upserts of a key never create two notifications.
+    std::lock_guard<std::mutex> lock(sKeyedMutex);
+    auto it = sKeyedNotifications.find(keyId);
+    if (it != sKeyedNotifications.end() && HandleTable_IsOpen(it->second.handle)) {
+        auto &entry        = it->second;
+        uint32_t fieldMask = 0;
+        if (entry.text != desc->text) {
+            fieldMask |= NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_TEXT;
+        }
+        if (!ColorEquals(entry.textColor, desc->textColor)) {
+            fieldMask |= NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_TEXT_COLOR;
+        }
+        if (!ColorEquals(entry.backgroundColor, desc->backgroundColor)) {
+            fieldMask |= NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_BACKGROUND_COLOR;
+        }
+        if (fieldMask == 0) {
+            return NOTIFICATION_MODULE_RESULT_SUCCESS;
+        }
+
+        NMDynamicUpdate update = {desc->text, desc->textColor, desc->backgroundColor};
+        res                    = NotificationModule_UpdateDynamicNotification(entry.handle, &update, fieldMask);
+        if (res == NOTIFICATION_MODULE_RESULT_SUCCESS) {
+            entry.text.assign(desc->text);
+            entry.textColor       = desc->textColor;
+            entry.backgroundColor = desc->backgroundColor;
+            return res;
+        }
+        if (res != NOTIFICATION_MODULE_RESULT_INVALID_HANDLE) {
+            return res;
+        }
+        // The notification is gone (e.g. the application has changed), show a new one.
+    }
+
+    NotificationModuleHandle handle;
+    res = NotificationModule_AddNotification(desc, &handle);
+    if (res != NOTIFICATION_MODULE_RESULT_SUCCESS) {
+        if (it != sKeyedNotifications.end()) {
+            sKeyedNotifications.erase(it);
+        }
+        return res;
+    }
+    auto &entry  = sKeyedNotifications[keyId];
+    entry.handle = handle;
+    entry.text.assign(desc->text);
+    entry.textColor       = desc->textColor;
+    entry.backgroundColor = desc->backgroundColor;
+    return res;
+}
+
+NotificationModuleStatus NotificationModule_Remove(const char *key) {
+    if (!NotificationModule_IsLibInitialized()) {
+        return NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED;
+    }
+    if (key == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+
+    // Keys that have never been interned can't have a notification, don't intern them now.
+    NotificationModuleTextId keyId;
+    if (!InternTable_Find(key, &keyId)) {
+        return NOTIFICATION_MODULE_RESULT_SUCCESS;
+    }
+
+    std::lock_guard<std::mutex> lock(sKeyedMutex);
+    auto it = sKeyedNotifications.find(keyId);
+    if (it == sKeyedNotifications.end()) {
+        return NOTIFICATION_MODULE_RESULT_SUCCESS;
+    }
+    auto handle = it->second.handle;
+    sKeyedNotifications.erase(it);
+
+    auto res = NotificationModule_FinishDynamicNotification(handle, 0.0f);
+    // A notification that is already gone has been removed as well.
+    if (res == NOTIFICATION_MODULE_RESULT_INVALID_HANDLE) {
+        res = NOTIFICATION_MODULE_RESULT_SUCCESS;
+    }
+    return res;
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+/**
+ * Forgets all keys. The notifications themselves are finished by NotificationModule_DeInitLibrary.
+ * Called by NotificationModule_DeInitLibrary.
+ */
+void KeyedNotifications_Reset();
@@ -0,0 +1,237 @@
+#include "live_notifications.h"
+#include "internal.h"
+#include "scheduler.h"
+#include "templates.h"
+#include "timer_wheel.h"
+#include "watchdog.h"
+
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <notifications/notifications.h>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#define LIVE_NOTIFICATION_TICK_IN_US       1000
+// Sampling more often than once per frame can't be seen.
+#define LIVE_NOTIFICATION_MIN_PERIOD_IN_MS 16
+// Keeps the period in microseconds within 32 bits.
+#define LIVE_NOTIFICATION_MAX_PERIOD_IN_MS 3600000
+
+struct LiveNotification {
+    // Must stay the first member, expired nodes are cast back to the entry.
+    TimerWheelNode node;
+    NotificationModuleHandle handle               = 0;
+    NotificationModuleLiveSampleCallback sampleFn = nullptr;
+    void *context                                 = nullptr;
+    uint32_t periodInUs                           = 0;
+    // Of the next sample, the wheel only knows it rounded to ticks.
+    uint64_t deadlineInUs = 0;
+    // Set by LiveNotifications_Stop while the entry is not scheduled, the task deletes it then.
+    bool stopped = false;
+    std::string format;
+    // Only used by the task (and before the entry is registered).
+    char text[NOTIFICATION_TEMPLATE_MAX_TEXT_LENGTH];
+    char lastSentText[NOTIFICATION_TEMPLATE_MAX_TEXT_LENGTH];
+};
+
+static std::mutex sLiveMutex;
+static std::condition_variable sLiveSampleDoneCondition;
+static TimerWheel sLiveWheel(LIVE_NOTIFICATION_TICK_IN_US);
+static std::unordered_map<NotificationModuleHandle, LiveNotification *> sLiveNotifications;
+static SchedulerTaskId sLiveTaskId = 0;
+// Handle whose callback is currently running and the thread it's running on.
+static NotificationModuleHandle sLiveSamplingHandle = 0;
+static std::thread::id sLiveSamplingThreadId;
+
+/**
+ * Accepts formats with exactly one floating point conversion ("%f", "%.1f", "%8.2e", ...) and any number of "%%".
+ */
+static bool IsValidLiveFormat(const char *format) {
+    uint32_t numConversions = 0;
+    for (const char *cur = format; *cur != '\0';) {
+        if (*cur++ != '%') {
+            continue;
+        }
+        if (*cur == '%') {
+            cur++;
+            continue;
+        }
+        while (*cur == '-' || *cur == '+' || *cur == ' ' || *cur == '#' || *cur == '0') {
+            cur++;
+        }
+        while (*cur >= '0' && *cur <= '9') {
+            cur++;
+        }
+        if (*cur == '.') {
+            cur++;
+            while (*cur >= '0' && *cur <= '9') {
+                cur++;
+            }
+        }
+        if (*cur == '\0' || strchr("fFeEgG", *cur) == nullptr) {
+            return false;
+        }
+        cur++;
+        numConversions++;
+    }
+    return numConversions == 1;
+}
+
+static void RenderSample(LiveNotification &entry) {
+    double value = entry.sampleFn(entry.context);
+    snprintf(entry.text, sizeof(entry.text), entry.format.c_str(), value);
+}
+
+// Returns false if the notification is gone.
+static bool SampleAndUpdate(LiveNotification &entry) {
+    RenderSample(entry);
+    if (strcmp(entry.text, entry.lastSentText) == 0) {
+        // The sampler is still alive, only the value didn't change. Keeps the inactivity watchdog from finishing it.
+        Watchdog_Touch(entry.handle);
+        return true;
+    }
+    auto res = NotificationModule_UpdateDynamicNotificationText(entry.handle, entry.text);
+    if (res == NOTIFICATION_MODULE_RESULT_SUCCESS) {
+        memcpy(entry.lastSentText, entry.text, strlen(entry.text) + 1);
+    }
+    // Other errors might be temporary, the text is sent again with the next sample.
+    return res != NOTIFICATION_MODULE_RESULT_INVALID_HANDLE;
+}
+
+static uint32_t LiveNotificationTask(void *, uint64_t nowInUs) {
+    static std::vector<TimerWheelNode *> expiredNodes;
+    expiredNodes.clear();
+    {
+        std::lock_guard<std::mutex> lock(sLiveMutex);
+        sLiveWheel.Advance(nowInUs, expiredNodes);
+    }
+
+    for (auto *node : expiredNodes) {
+        auto *entry = (LiveNotification *) node;
+        {
+            std::lock_guard<std::mutex> lock(sLiveMutex);
+            if (entry->stopped) {
+                delete entry;
+                continue;
+            }
+            sLiveSamplingHandle   = entry->handle;
+            sLiveSamplingThreadId = std::this_thread::get_id();
+        }
+
+        bool alive = SampleAndUpdate(*entry);
+
+        std::lock_guard<std::mutex> lock(sLiveMutex);
+        sLiveSamplingHandle = 0;
+        sLiveSampleDoneCondition.notify_all();
+        if (entry->stopped) {
+            delete entry;
+        } else if (!alive) {
+            sLiveNotifications.erase(entry->handle);
+            delete entry;
+        } else {
+            // Based on the previous deadline, so the period doesn't drift by the wakeup latency and the time spent
+            // sampling. Periods that have been missed completely are skipped instead of being sampled back to back.
+            entry->deadlineInUs += entry->periodInUs;
+            if (entry->deadlineInUs <= nowInUs) {
+                entry->deadlineInUs += ((nowInUs - entry->deadlineInUs) / entry->periodInUs + 1) * entry->periodInUs;
+            }
+            sLiveWheel.Schedule(&entry->node, entry->deadlineInUs, Scheduler_GetTimeInUs());
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(sLiveMutex);
+    if (sLiveWheel.IsEmpty()) {
+        sLiveTaskId = 0;
+        return 0;
+    }
+    uint32_t delay = sLiveWheel.GetNextWakeupDelayInUs(Scheduler_GetTimeInUs());
+    return delay > 0 ? delay : 1;
+}
+
+void LiveNotifications_Stop(NotificationModuleHandle handle) {
+    std::unique_lock<std::mutex> lock(sLiveMutex);
+    auto it = sLiveNotifications.find(handle);
+    if (it == sLiveNotifications.end()) {
+        return;
+    }
+    auto *entry = it->second;
+    sLiveNotifications.erase(it);
+    if (TimerWheel::IsScheduled(&entry->node)) {
+        sLiveWheel.Cancel(&entry->node);
+        delete entry;
+        return;
+    }
+    // Expired and waiting for (or in) its sample, the task deletes it.
+    entry->stopped = true;
+    // The callback itself might finish the notification.
+    if (std::this_thread::get_id() != sLiveSamplingThreadId) {
+        sLiveSampleDoneCondition.wait(lock, [handle] { return sLiveSamplingHandle != handle; });
+    }
+}
+
+void LiveNotifications_Reset() {
+    std::lock_guard<std::mutex> lock(sLiveMutex);
+    sLiveWheel.Clear();
+    // The task isn't running anymore, so every entry that is left is in the map.
+    for (auto &cur : sLiveNotifications) {
+        delete cur.second;
+    }
+    sLiveNotifications.clear();
+    // The scheduler task is removed by Scheduler_Shutdown.
+    sLiveTaskId = 0;
+}
+
+NotificationModuleStatus NotificationModule_AddLiveNotification(NotificationModuleLiveSampleCallback sampleFn,
+                                                                void *context,
+                                                                uint32_t periodInMs,
+                                                                const char *format,
+                                                                NotificationModuleHandle *outHandle) {
+    if (!NotificationModule_IsLibInitialized()) {
+        return NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED;
+    }
+    if (sampleFn == nullptr || periodInMs == 0 || periodInMs > LIVE_NOTIFICATION_MAX_PERIOD_IN_MS || format == nullptr || outHandle == nullptr || !IsValidLiveFormat(format)) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+
+    auto *entry = new (std::nothrow) LiveNotification;
+    if (entry == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED;
+    }
+    entry->sampleFn   = sampleFn;
+    entry->context    = context;
+    entry->periodInUs = (periodInMs < LIVE_NOTIFICATION_MIN_PERIOD_IN_MS ? LIVE_NOTIFICATION_MIN_PERIOD_IN_MS : periodInMs) * 1000;
+    entry->format     = format;
+
+    // The first sample is taken right away, so the notification never shows an empty text.
+    RenderSample(*entry);
+    NMNotificationDesc desc;
+    NotificationModule_InitNotificationDesc(NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC, &desc);
+    desc.text = entry->text;
+    NotificationModuleHandle handle;
+    auto res = NotificationModule_AddNotification(&desc, &handle);
+    if (res != NOTIFICATION_MODULE_RESULT_SUCCESS) {
+        delete entry;
+        return res;
+    }
+    entry->handle = handle;
+    memcpy(entry->lastSentText, entry->text, strlen(entry->text) + 1);
+
+    std::lock_guard<std::mutex> lock(sLiveMutex);
+    sLiveNotifications[handle] = entry;
+    uint64_t now               = Scheduler_GetTimeInUs();
+    entry->deadlineInUs        = now + entry->periodInUs;
+    sLiveWheel.Schedule(&entry->node, entry->deadlineInUs, now);
+    uint32_t delay = sLiveWheel.GetNextWakeupDelayInUs(now);
+    if (sLiveTaskId == 0) {
+        sLiveTaskId = Scheduler_AddTask(LiveNotificationTask, nullptr, delay);
+    } else {
+        Scheduler_RunTaskEarlier(sLiveTaskId, delay);
+    }
+    *outHandle = handle;
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
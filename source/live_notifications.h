@@ -0,0 +1,15 @@
+#pragma once
+
+#include "notifications/notification_defines.h"
+
+/**
+ * Stops sampling a live notification. Called when a dynamic notification is finished. If the sample callback of the
+ * handle is currently running on the scheduler thread, this waits until it has returned.
+ */
+void LiveNotifications_Stop(NotificationModuleHandle handle);
+
+/**
+ * Stops sampling all live notifications. Has to be called after Scheduler_Shutdown.
+ * Called by NotificationModule_DeInitLibrary.
+ */
+void LiveNotifications_Reset();
@@ -0,0 +1,165 @@
+#include "progress_channels.h"
+#include "handle_table.h"
+#include "internal.h"
+#include "scheduler.h"
+#include "templates.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <new>
+#include <notifications/notifications.h>
+#include <vector>
+
+// Published values are picked up once per frame.
+#define PROGRESS_CHANNEL_UPDATE_INTERVAL_IN_US 16667
+// Value of a channel that has never been published to.
+#define PROGRESS_CHANNEL_NO_VALUE              0xFFFFFFFF
+
+struct _NMProgressChannel {
+    // Written by the producer, read by the consumer task.
+    std::atomic<uint32_t> value{PROGRESS_CHANNEL_NO_VALUE};
+    std::atomic<bool> closed{false};
+    NotificationModuleHandle handle         = 0;
+    NotificationModuleTemplateId templateId = NOTIFICATION_MODULE_TEMPLATE_ID_INVALID;
+    // Only used by the consumer task.
+    uint32_t lastSentValue = PROGRESS_CHANNEL_NO_VALUE;
+    bool handleGone        = false;
+};
+
+struct PendingProgressUpdate {
+    _NMProgressChannel *channel;
+    uint32_t value;
+};
+
+static std::mutex sProgressChannelsMutex;
+static std::vector<_NMProgressChannel *> sProgressChannels;
+static SchedulerTaskId sProgressChannelTaskId = 0;
+
+static NotificationModuleStatus SendProgress(const _NMProgressChannel &channel, uint32_t value) {
+    if (channel.templateId == NOTIFICATION_MODULE_TEMPLATE_ID_INVALID) {
+        char text[16];
+        snprintf(text, sizeof(text), "%u%%", (unsigned int) value);
+        return NotificationModule_UpdateDynamicNotificationText(channel.handle, text);
+    }
+    NMTemplateArg arg;
+    arg.type      = NOTIFICATION_MODULE_TEMPLATE_ARG_TYPE_UINT;
+    arg.value.u32 = value;
+    return NotificationModule_UpdateDynamicNotificationTextFromTemplate(channel.handle, channel.templateId, &arg, 1);
+}
+
+static uint32_t ProgressChannelTask(void *, uint64_t) {
+    static std::vector<PendingProgressUpdate> pendingUpdates;
+    static std::vector<_NMProgressChannel *> closedChannels;
+    pendingUpdates.clear();
+    closedChannels.clear();
+    {
+        std::lock_guard<std::mutex> lock(sProgressChannelsMutex);
+        for (auto it = sProgressChannels.begin(); it != sProgressChannels.end();) {
+            auto *channel = *it;
+            // Check "closed" first, so the last value published before closing is always sent.
+            bool closed    = channel->closed.load(std::memory_order_acquire);
+            uint32_t value = channel->value.load(std::memory_order_acquire);
+            if (value != PROGRESS_CHANNEL_NO_VALUE && value != channel->lastSentValue && !channel->handleGone) {
+                channel->lastSentValue = value;
+                pendingUpdates.push_back({channel, value});
+            }
+            if (closed) {
+                closedChannels.push_back(channel);
+                it = sProgressChannels.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    // Only this task deletes channels while it's registered, so they can be used without holding the lock.
+    for (const auto &update : pendingUpdates) {
+        if (SendProgress(*update.channel, update.value) == NOTIFICATION_MODULE_RESULT_INVALID_HANDLE) {
+            update.channel->handleGone = true;
+        }
+    }
+    for (auto *channel : closedChannels) {
+        delete channel;
+    }
+
+    std::lock_guard<std::mutex> lock(sProgressChannelsMutex);
+    if (sProgressChannels.empty()) {
+        sProgressChannelTaskId = 0;
+        return 0;
+    }
+    return PROGRESS_CHANNEL_UPDATE_INTERVAL_IN_US;
+}
+
+void ProgressChannels_Reset() {
+    std::lock_guard<std::mutex> lock(sProgressChannelsMutex);
+    sProgressChannels.erase(std::remove_if(sProgressChannels.begin(),
+                                           sProgressChannels.end(),
+                                           [](_NMProgressChannel *channel) {
+                                               if (channel->closed.load(std::memory_order_acquire)) {
+                                                   delete channel;
+                                                   return true;
+                                               }
+                                               return false;
+                                           }),
+                            sProgressChannels.end());
+    // The scheduler task is removed by Scheduler_Shutdown.
+    sProgressChannelTaskId = 0;
+}
+
+NotificationModuleStatus NotificationModule_OpenProgressChannel(NotificationModuleHandle handle,
+                                                                NotificationModuleTemplateId templateId,
+                                                                NotificationModuleProgressChannel *outChannel) {
+    if (!NotificationModule_IsLibInitialized()) {
+        return NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED;
+    }
+    if (outChannel == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    // The notification of a deferred handle might not have been created yet, its updates are queued after it.
+    if (!HandleTable_IsOpen(handle)) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_HANDLE;
+    }
+
+    auto *channel = new (std::nothrow) _NMProgressChannel;
+    if (channel == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED;
+    }
+    channel->handle     = handle;
+    channel->templateId = templateId;
+
+    std::lock_guard<std::mutex> lock(sProgressChannelsMutex);
+    sProgressChannels.push_back(channel);
+    if (sProgressChannelTaskId == 0) {
+        sProgressChannelTaskId = Scheduler_AddTask(ProgressChannelTask, nullptr, PROGRESS_CHANNEL_UPDATE_INTERVAL_IN_US);
+    }
+    *outChannel = channel;
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+NotificationModuleStatus NotificationModule_PublishProgress(NotificationModuleProgressChannel channel, uint32_t value) {
+    if (channel == nullptr || value == PROGRESS_CHANNEL_NO_VALUE) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    channel->value.store(value, std::memory_order_release);
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+NotificationModuleStatus NotificationModule_CloseProgressChannel(NotificationModuleProgressChannel channel) {
+    if (channel == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    std::lock_guard<std::mutex> lock(sProgressChannelsMutex);
+    if (sProgressChannelTaskId != 0) {
+        // The consumer task sends the last value and deletes the channel.
+        channel->closed.store(true, std::memory_order_release);
+        return NOTIFICATION_MODULE_RESULT_SUCCESS;
+    }
+    auto it = std::find(sProgressChannels.begin(), sProgressChannels.end(), channel);
+    if (it != sProgressChannels.end()) {
+        sProgressChannels.erase(it);
+    }
+    delete channel;
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+/**
+ * Drops all closed progress channels and forgets the consumer task. Open channels stay valid and are picked up
+ * again by the next NotificationModule_OpenProgressChannel after the library has been initialized again.
+ * Has to be called after Scheduler_Shutdown. Called by NotificationModule_DeInitLibrary.
+ */
+void ProgressChannels_Reset();
@@ -0,0 +1,71 @@
+#include "queue_estimate.h"
+#include "handle_table.h"
+#include "scheduler.h"
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+// Rough numbers, only used if the module can't tell us the real ones.
+#define QUEUE_ESTIMATE_OVERHEAD_IN_BYTES     256
+#define QUEUE_ESTIMATE_DYNAMIC_TEXT_IN_BYTES 64
+#define QUEUE_ESTIMATE_FADE_OUT_IN_US        500000
+#define QUEUE_ESTIMATE_CAPACITY_IN_BYTES     (32 * 1024)
+// Expired entries are only removed once this many have been recorded, or twice as many as were left after the last prune.
+#define QUEUE_ESTIMATE_PRUNE_THRESHOLD       64
+
+struct StaticEstimate {
+    uint64_t expiresAtInUs;
+    uint32_t sizeInBytes;
+};
+
+static std::mutex sQueueEstimateMutex;
+static std::vector<StaticEstimate> sStaticEstimates;
+static size_t sPruneAtSize = QUEUE_ESTIMATE_PRUNE_THRESHOLD;
+
+// Has to be called while holding sQueueEstimateMutex.
+static void PruneExpired(uint64_t nowInUs) {
+    sStaticEstimates.erase(std::remove_if(sStaticEstimates.begin(),
+                                          sStaticEstimates.end(),
+                                          [nowInUs](const StaticEstimate &cur) { return cur.expiresAtInUs <= nowInUs; }),
+                           sStaticEstimates.end());
+    // Keeps adding amortized O(1) during bursts where nothing has expired yet.
+    sPruneAtSize = std::max<size_t>(QUEUE_ESTIMATE_PRUNE_THRESHOLD, sStaticEstimates.size() * 2);
+}
+
+void QueueEstimate_OnStaticAdded(uint32_t textLength, float durationBeforeFadeOutInSeconds, float shakeDurationInSeconds) {
+    uint64_t nowInUs    = Scheduler_GetTimeInUs();
+    uint64_t lifetimeUs = (uint64_t) ((durationBeforeFadeOutInSeconds + shakeDurationInSeconds) * 1000000.0f) + QUEUE_ESTIMATE_FADE_OUT_IN_US;
+
+    std::lock_guard<std::mutex> lock(sQueueEstimateMutex);
+    if (sStaticEstimates.size() >= sPruneAtSize) {
+        PruneExpired(nowInUs);
+    }
+    sStaticEstimates.push_back({nowInUs + lifetimeUs, textLength + 1 + QUEUE_ESTIMATE_OVERHEAD_IN_BYTES});
+}
+
+void QueueEstimate_Get(bool overlayReady, NMQueueInfo *outInfo) {
+    uint32_t dynamicCount = HandleTable_GetUsedCount();
+    uint32_t count        = dynamicCount;
+    uint32_t bytesUsed    = dynamicCount * (QUEUE_ESTIMATE_DYNAMIC_TEXT_IN_BYTES + QUEUE_ESTIMATE_OVERHEAD_IN_BYTES);
+    {
+        std::lock_guard<std::mutex> lock(sQueueEstimateMutex);
+        PruneExpired(Scheduler_GetTimeInUs());
+        count += sStaticEstimates.size();
+        for (const auto &cur : sStaticEstimates) {
+            bytesUsed += cur.sizeInBytes;
+        }
+    }
+
+    outInfo->pending         = overlayReady ? 0 : count;
+    outInfo->visible         = overlayReady ? count : 0;
+    outInfo->bytesUsed       = bytesUsed;
+    outInfo->capacityInBytes = QUEUE_ESTIMATE_CAPACITY_IN_BYTES;
+    outInfo->isEstimate      = true;
+}
+
+void QueueEstimate_Reset() {
+    std::lock_guard<std::mutex> lock(sQueueEstimateMutex);
+    sStaticEstimates.clear();
+    sPruneAtSize = QUEUE_ESTIMATE_PRUNE_THRESHOLD;
+}
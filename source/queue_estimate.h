@@ -0,0 +1,24 @@
+#pragma once
+
+#include "notifications/notification_defines.h"
+
+/**
+ * Library side estimate of the overlay queue, used by NotificationModule_GetQueueInfo if the module doesn't
+ * export NMGetQueueInfo. Static notifications are assumed to be gone once their fade out time has passed,
+ * dynamic notifications until the module has called their finish callback.
+ */
+
+/**
+ * Records a static notification that has been added successfully.
+ */
+void QueueEstimate_OnStaticAdded(uint32_t textLength, float durationBeforeFadeOutInSeconds, float shakeDurationInSeconds);
+
+/**
+ * Fills `outInfo` with the estimate. All notifications are counted as pending while the overlay is not ready.
+ */
+void QueueEstimate_Get(bool overlayReady, NMQueueInfo *outInfo);
+
+/**
+ * Forgets all recorded notifications. Called by NotificationModule_DeInitLibrary.
+ */
+void QueueEstimate_Reset();
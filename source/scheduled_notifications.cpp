@@ -0,0 +1,156 @@
+#include "scheduled_notifications.h"
+#include "internal.h"
+#include "logger.h"
+#include "scheduler.h"
+#include "timer_wheel.h"
+
+#include <deque>
+#include <mutex>
+#include <notifications/notifications.h>
+#include <string>
+#include <vector>
+
+#define SCHEDULED_NOTIFICATION_TICK_IN_US 10000
+#define SCHEDULED_NOTIFICATION_MAX_SLOTS  0x10000
+
+struct ScheduledNotification {
+    // Must stay the first member, expired nodes are cast back to the entry.
+    TimerWheelNode node;
+    NMNotificationDesc desc = {};
+    std::string text;
+    uint32_t index      = 0;
+    uint16_t generation = 1;
+    bool used           = false;
+};
+
+static std::mutex sScheduledMutex;
+static TimerWheel sScheduledWheel(SCHEDULED_NOTIFICATION_TICK_IN_US);
+// A deque keeps the nodes at a stable address.
+static std::deque<ScheduledNotification> sScheduledSlots;
+static std::vector<uint32_t> sScheduledFreeSlots;
+static SchedulerTaskId sScheduledTaskId = 0;
+
+static inline NMScheduleHandle MakeScheduleHandle(const ScheduledNotification &entry) {
+    return ((NMScheduleHandle) entry.generation << 16) | entry.index;
+}
+
+// Has to be called while holding sScheduledMutex.
+static void ReleaseSlot(ScheduledNotification &entry) {
+    entry.used = false;
+    entry.text.clear();
+    if (++entry.generation == 0) {
+        entry.generation = 1;
+    }
+    sScheduledFreeSlots.push_back(entry.index);
+}
+
+static uint32_t ScheduledNotificationTask(void *, uint64_t nowInUs) {
+    std::vector<TimerWheelNode *> expiredNodes;
+    std::vector<std::string> texts;
+    std::vector<NMNotificationDesc> descs;
+    {
+        std::lock_guard<std::mutex> lock(sScheduledMutex);
+        sScheduledWheel.Advance(nowInUs, expiredNodes);
+        for (auto *node : expiredNodes) {
+            auto *entry = (ScheduledNotification *) node;
+            descs.push_back(entry->desc);
+            texts.push_back(std::move(entry->text));
+            ReleaseSlot(*entry);
+        }
+    }
+
+    for (size_t i = 0; i < descs.size(); i++) {
+        descs[i].text = texts[i].c_str();
+        auto res      = NotificationModule_AddNotification(&descs[i], nullptr);
+        if (res != NOTIFICATION_MODULE_RESULT_SUCCESS) {
+            DEBUG_FUNCTION_LINE_WARN("Failed to show scheduled notification: %s", NotificationModule_GetStatusStr(res));
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(sScheduledMutex);
+    if (sScheduledWheel.IsEmpty()) {
+        sScheduledTaskId = 0;
+        return 0;
+    }
+    uint32_t delay = sScheduledWheel.GetNextWakeupDelayInUs(Scheduler_GetTimeInUs());
+    return delay > 0 ? delay : 1;
+}
+
+NotificationModuleStatus NotificationModule_ScheduleNotification(const NMNotificationDesc *desc, uint64_t delayInUs, NMScheduleHandle *outHandle) {
+    if (!NotificationModule_IsLibInitialized()) {
+        return NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED;
+    }
+    NMNotificationDesc normalizedDesc;
+    // Larger delays are most likely a negative value cast to uint64_t, and `now + delayInUs` could wrap around.
+    if (delayInUs > NM_SCHEDULE_MAX_DELAY_IN_US || !NotificationModule_NormalizeNotificationDesc(desc, normalizedDesc) || normalizedDesc.text == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    desc = &normalizedDesc;
+    if (desc->type != NOTIFICATION_MODULE_NOTIFICATION_TYPE_INFO && desc->type != NOTIFICATION_MODULE_NOTIFICATION_TYPE_ERROR) {
+        return NOTIFICATION_MODULE_RESULT_UNSUPPORTED_TYPE;
+    }
+
+    std::lock_guard<std::mutex> lock(sScheduledMutex);
+    ScheduledNotification *entry;
+    if (!sScheduledFreeSlots.empty()) {
+        entry = &sScheduledSlots[sScheduledFreeSlots.back()];
+        sScheduledFreeSlots.pop_back();
+    } else {
+        if (sScheduledSlots.size() >= SCHEDULED_NOTIFICATION_MAX_SLOTS) {
+            return NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED;
+        }
+        entry        = &sScheduledSlots.emplace_back();
+        entry->index = sScheduledSlots.size() - 1;
+    }
+    entry->desc      = *desc;
+    entry->desc.size = sizeof(NMNotificationDesc);
+    entry->text      = desc->text;
+    entry->desc.text = nullptr;
+    entry->used      = true;
+
+    uint64_t now = Scheduler_GetTimeInUs();
+    sScheduledWheel.Schedule(&entry->node, now + delayInUs, now);
+    uint32_t delay = sScheduledWheel.GetNextWakeupDelayInUs(now);
+    if (sScheduledTaskId == 0) {
+        sScheduledTaskId = Scheduler_AddTask(ScheduledNotificationTask, nullptr, delay);
+    } else {
+        Scheduler_RunTaskEarlier(sScheduledTaskId, delay);
+    }
+
+    if (outHandle != nullptr) {
+        *outHandle = MakeScheduleHandle(*entry);
+    }
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+NotificationModuleStatus NotificationModule_CancelScheduled(NMScheduleHandle handle) {
+    if (handle == NM_SCHEDULE_HANDLE_INVALID) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    std::lock_guard<std::mutex> lock(sScheduledMutex);
+    uint32_t index = handle & 0xFFFF;
+    if (index >= sScheduledSlots.size()) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_HANDLE;
+    }
+    auto &entry = sScheduledSlots[index];
+    if (!entry.used || MakeScheduleHandle(entry) != handle) {
+        // Already shown or cancelled.
+        return NOTIFICATION_MODULE_RESULT_INVALID_HANDLE;
+    }
+    // The task is stopped on its next run if the wheel is empty, no need to wake it up.
+    sScheduledWheel.Cancel(&entry.node);
+    ReleaseSlot(entry);
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+void ScheduledNotifications_Reset() {
+    std::lock_guard<std::mutex> lock(sScheduledMutex);
+    sScheduledWheel.Clear();
+    for (auto &entry : sScheduledSlots) {
+        if (entry.used) {
+            ReleaseSlot(entry);
+        }
+    }
+    // The scheduler task is removed by Scheduler_Shutdown.
+    sScheduledTaskId = 0;
+}
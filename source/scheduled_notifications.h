@@ -0,0 +1,6 @@
+#pragma once
+
+/**
+ * Cancels all scheduled notifications. Called by NotificationModule_DeInitLibrary.
+ */
+void ScheduledNotifications_Reset();
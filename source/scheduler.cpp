@@ -0,0 +1,136 @@
+#include "scheduler.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <coreinit/time.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct SchedulerTask {
+    SchedulerTaskId id;
+    SchedulerTaskFunc func;
+    void *context;
+    uint64_t nextRunInUs;
+};
+
+static std::mutex sSchedulerMutex;
+static std::condition_variable sSchedulerCondition;
+static std::condition_variable sSchedulerTaskDoneCondition;
+static std::vector<SchedulerTask> sSchedulerTasks;
+static std::thread sSchedulerThread;
+static bool sSchedulerStop            = false;
+static SchedulerTaskId sNextTaskId    = 1;
+static SchedulerTaskId sRunningTaskId = 0;
+static std::thread::id sSchedulerThreadId;
+
+uint64_t Scheduler_GetTimeInUs() {
+    return OSTicksToMicroseconds(OSGetSystemTime());
+}
+
+static void SchedulerThreadEntry() {
+    std::unique_lock<std::mutex> lock(sSchedulerMutex);
+    while (!sSchedulerStop) {
+        if (sSchedulerTasks.empty()) {
+            sSchedulerCondition.wait(lock);
+            continue;
+        }
+
+        SchedulerTask *next = &sSchedulerTasks[0];
+        for (auto &task : sSchedulerTasks) {
+            if (task.nextRunInUs < next->nextRunInUs) {
+                next = &task;
+            }
+        }
+
+        uint64_t now = Scheduler_GetTimeInUs();
+        if (next->nextRunInUs > now) {
+            sSchedulerCondition.wait_for(lock, std::chrono::microseconds(next->nextRunInUs - now));
+            continue;
+        }
+
+        SchedulerTask task = *next;
+        sRunningTaskId     = task.id;
+        lock.unlock();
+        uint32_t delay = task.func(task.context, now);
+        lock.lock();
+        sRunningTaskId = 0;
+        sSchedulerTaskDoneCondition.notify_all();
+
+        // The task might have been removed (or the vector modified) while it was running.
+        for (auto it = sSchedulerTasks.begin(); it != sSchedulerTasks.end(); ++it) {
+            if (it->id != task.id) {
+                continue;
+            }
+            if (delay == 0) {
+                sSchedulerTasks.erase(it);
+            } else if (it->nextRunInUs == task.nextRunInUs) {
+                it->nextRunInUs = now + delay;
+            } else if (it->nextRunInUs > now + delay) {
+                // Scheduler_RunTaskEarlier has been called while the task was running.
+                it->nextRunInUs = now + delay;
+            }
+            break;
+        }
+    }
+}
+
+SchedulerTaskId Scheduler_AddTask(SchedulerTaskFunc func, void *context, uint32_t delayInUs) {
+    if (func == nullptr) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(sSchedulerMutex);
+    if (!sSchedulerThread.joinable()) {
+        sSchedulerStop     = false;
+        sSchedulerThread   = std::thread(SchedulerThreadEntry);
+        sSchedulerThreadId = sSchedulerThread.get_id();
+    }
+    SchedulerTaskId id = sNextTaskId++;
+    if (sNextTaskId == 0) {
+        sNextTaskId = 1;
+    }
+    sSchedulerTasks.push_back({id, func, context, Scheduler_GetTimeInUs() + delayInUs});
+    sSchedulerCondition.notify_one();
+    return id;
+}
+
+void Scheduler_RunTaskEarlier(SchedulerTaskId id, uint32_t delayInUs) {
+    std::lock_guard<std::mutex> lock(sSchedulerMutex);
+    uint64_t deadline = Scheduler_GetTimeInUs() + delayInUs;
+    for (auto &task : sSchedulerTasks) {
+        if (task.id == id) {
+            if (deadline < task.nextRunInUs) {
+                task.nextRunInUs = deadline;
+                sSchedulerCondition.notify_one();
+            }
+            break;
+        }
+    }
+}
+
+void Scheduler_RemoveTask(SchedulerTaskId id) {
+    std::unique_lock<std::mutex> lock(sSchedulerMutex);
+    for (auto it = sSchedulerTasks.begin(); it != sSchedulerTasks.end(); ++it) {
+        if (it->id == id) {
+            sSchedulerTasks.erase(it);
+            break;
+        }
+    }
+    if (std::this_thread::get_id() != sSchedulerThreadId) {
+        sSchedulerTaskDoneCondition.wait(lock, [id] { return sRunningTaskId != id; });
+    }
+}
+
+void Scheduler_Shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(sSchedulerMutex);
+        if (!sSchedulerThread.joinable()) {
+            return;
+        }
+        sSchedulerTasks.clear();
+        sSchedulerStop = true;
+        sSchedulerCondition.notify_one();
+    }
+    sSchedulerThread.join();
+    sSchedulerThreadId = {};
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Single background thread shared by all library features that need to run code periodically or after a delay.
+ * The thread is created on demand and sleeps without any wakeups while no task is registered.
+ */
+
+typedef uint32_t SchedulerTaskId;
+
+/**
+ * Called on the scheduler thread.
+ * Returns the delay in microseconds until the task should run again, 0 removes the task.
+ */
+typedef uint32_t (*SchedulerTaskFunc)(void *context, uint64_t nowInUs);
+
+/**
+ * Returns the current time in microseconds, based on the system timer.
+ */
+uint64_t Scheduler_GetTimeInUs();
+
+/**
+ * Registers a task that will run after `delayInUs`. Returns 0 on failure.
+ */
+SchedulerTaskId Scheduler_AddTask(SchedulerTaskFunc func, void *context, uint32_t delayInUs);
+
+/**
+ * Moves the next run of a task to `delayInUs` from now (if that is earlier than the current deadline).
+ */
+void Scheduler_RunTaskEarlier(SchedulerTaskId id, uint32_t delayInUs);
+
+/**
+ * Removes a task. If the task is currently running on another thread, this waits until it has returned.
+ */
+void Scheduler_RemoveTask(SchedulerTaskId id);
+
+/**
+ * Removes all tasks and stops the scheduler thread.
+ */
+void Scheduler_Shutdown();
@@ -0,0 +1,222 @@
+#include "shared_ring.h"
+#include "logger.h"
+
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <notifications/notifications.h>
+
+// Bigger records are sent with the exported functions, so a single long text can't fill the ring.
+#define SHARED_RING_MAX_RECORD_SIZE (SHARED_RING_CAPACITY / 4)
+
+static_assert((SHARED_RING_CAPACITY & (SHARED_RING_CAPACITY - 1)) == 0, "The capacity has to be a power of two");
+static_assert(SHARED_RING_MAX_RECORD_SIZE <= 0xFFFF, "Record sizes have to fit into SharedRingRecord::size");
+
+struct SharedRingMemory {
+    SharedRingHeader header;
+    alignas(64) uint8_t data[SHARED_RING_CAPACITY];
+};
+
+static std::mutex sSharedRingMutex;
+static std::condition_variable sSharedRingProcessDoneCondition;
+static SharedRingMemory *sSharedRing                = nullptr;
+static SharedRingProcessFunc sSharedRingProcessFunc = nullptr;
+static SharedRingDetachFunc sSharedRingDetachFunc   = nullptr;
+// Number of NMProcessSharedRing calls that are running, the ring must not be detached before they have returned.
+static uint32_t sSharedRingProcessCalls = 0;
+
+static inline uint32_t AlignRecordSize(uint32_t size) {
+    return (size + alignof(SharedRingRecord) - 1) & ~(uint32_t) (alignof(SharedRingRecord) - 1);
+}
+
+// Has to be called while holding sSharedRingMutex. Returns NULL if the ring is full, otherwise a zeroed record
+// that is published by storing `outNewHead` to the head.
+static SharedRingRecord *Reserve(uint32_t size, uint32_t *outNewHead) {
+    auto &header        = sSharedRing->header;
+    uint32_t head       = header.head.load(std::memory_order_relaxed);
+    uint32_t tail       = header.tail.load(std::memory_order_acquire);
+    uint32_t offset     = head & (SHARED_RING_CAPACITY - 1);
+    uint32_t contiguous = SHARED_RING_CAPACITY - offset;
+    uint32_t needed     = contiguous < size ? contiguous + size : size;
+    if (SHARED_RING_CAPACITY - (head - tail) < needed) {
+        return nullptr;
+    }
+    if (contiguous < size) {
+        // Records don't wrap around. The rest is at least alignof(SharedRingRecord) bytes, enough for size and command.
+        auto *pad    = (SharedRingRecord *) &sSharedRing->data[offset];
+        pad->size    = (uint16_t) contiguous;
+        pad->command = SHARED_RING_COMMAND_PAD;
+        offset       = 0;
+    }
+    auto *record = (SharedRingRecord *) &sSharedRing->data[offset];
+    memset(record, 0, sizeof(SharedRingRecord));
+    record->size = (uint16_t) size;
+    *outNewHead  = head + needed;
+    return record;
+}
+
+// Has to be called while holding `lock` on sSharedRingMutex and a ring is attached. Calls NMProcessSharedRing with the
+// lock released: the module may call finish callbacks while it consumes the records, and those may call back into the
+// library. Returns false if the ring has been detached in the meantime.
+static bool Process(std::unique_lock<std::mutex> &lock) {
+    auto processFunc = sSharedRingProcessFunc;
+    sSharedRingProcessCalls++;
+    lock.unlock();
+    processFunc();
+    lock.lock();
+    if (--sSharedRingProcessCalls == 0) {
+        sSharedRingProcessDoneCondition.notify_all();
+    }
+    return sSharedRing != nullptr;
+}
+
+// Has to be called while holding `lock` on sSharedRingMutex and a ring is attached.
+static SharedRingRecord *ReserveOrProcess(std::unique_lock<std::mutex> &lock, uint32_t size, uint32_t *outNewHead) {
+    auto *record = Reserve(size, outNewHead);
+    if (record == nullptr) {
+        // The module hasn't caught up, let it consume everything on this thread.
+        if (!Process(lock)) {
+            return nullptr;
+        }
+        record = Reserve(size, outNewHead);
+    }
+    return record;
+}
+
+// Has to be called while holding sSharedRingMutex and a ring is attached.
+static bool IsEmpty() {
+    auto &header = sSharedRing->header;
+    return header.head.load(std::memory_order_relaxed) == header.tail.load(std::memory_order_acquire);
+}
+
+// Has to be called while holding `lock` on sSharedRingMutex and a ring is attached.
+static void SyncLocked(std::unique_lock<std::mutex> &lock) {
+    if (!IsEmpty()) {
+        Process(lock);
+    }
+}
+
+bool SharedRing_Attach(SharedRingAttachFunc attachFunc, SharedRingProcessFunc processFunc, SharedRingDetachFunc detachFunc) {
+    std::lock_guard<std::mutex> lock(sSharedRingMutex);
+    if (sSharedRing != nullptr) {
+        return true;
+    }
+    auto *ring = new (std::nothrow) SharedRingMemory;
+    if (ring == nullptr) {
+        DEBUG_FUNCTION_LINE_WARN("Failed to allocate the shared ring");
+        return false;
+    }
+    ring->header.magic      = SHARED_RING_MAGIC;
+    ring->header.version    = SHARED_RING_VERSION;
+    ring->header.dataOffset = (uint32_t) (ring->data - (uint8_t *) &ring->header);
+    ring->header.capacity   = SHARED_RING_CAPACITY;
+    ring->header.head.store(0, std::memory_order_relaxed);
+    ring->header.tail.store(0, std::memory_order_relaxed);
+
+    auto res = attachFunc(&ring->header);
+    if (res != NOTIFICATION_MODULE_RESULT_SUCCESS) {
+        DEBUG_FUNCTION_LINE_WARN("NMAttachSharedRing failed: %s. Updates will be sent with the exported functions.", NotificationModule_GetStatusStr(res));
+        delete ring;
+        return false;
+    }
+    sSharedRing            = ring;
+    sSharedRingProcessFunc = processFunc;
+    sSharedRingDetachFunc  = detachFunc;
+    return true;
+}
+
+bool SharedRing_PushUpdate(NotificationModuleHandle moduleHandle, const NMDynamicUpdate &update, uint32_t fieldMask, bool textIsShared) {
+    std::unique_lock<std::mutex> lock(sSharedRingMutex);
+    if (sSharedRing == nullptr) {
+        return false;
+    }
+    bool hasText        = (fieldMask & NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_TEXT) != 0;
+    uint32_t textLength = hasText ? strlen(update.text) : 0;
+    uint32_t size       = sizeof(SharedRingRecord);
+    if (hasText && !textIsShared) {
+        size += textLength + 1;
+    }
+    size = AlignRecordSize(size);
+    if (size > SHARED_RING_MAX_RECORD_SIZE) {
+        SyncLocked(lock);
+        return false;
+    }
+
+    uint32_t newHead;
+    auto *record = ReserveOrProcess(lock, size, &newHead);
+    if (record == nullptr) {
+        return false;
+    }
+    record->command         = SHARED_RING_COMMAND_UPDATE;
+    record->flags           = (uint8_t) fieldMask;
+    record->moduleHandle    = moduleHandle;
+    record->textColor       = update.textColor;
+    record->backgroundColor = update.backgroundColor;
+    if (hasText) {
+        record->textLength = textLength;
+        if (textIsShared) {
+            record->sharedText = update.text;
+        } else {
+            memcpy((char *) (record + 1), update.text, textLength + 1);
+        }
+    }
+    sSharedRing->header.head.store(newHead, std::memory_order_release);
+    return true;
+}
+
+bool SharedRing_PushFinish(NotificationModuleHandle moduleHandle,
+                           NotificationModuleStatusFinish finishMode,
+                           float durationBeforeFadeOutInSeconds,
+                           float shakeDurationInSeconds) {
+    std::unique_lock<std::mutex> lock(sSharedRingMutex);
+    if (sSharedRing == nullptr) {
+        return false;
+    }
+    uint32_t newHead;
+    auto *record = ReserveOrProcess(lock, AlignRecordSize(sizeof(SharedRingRecord)), &newHead);
+    if (record == nullptr) {
+        return false;
+    }
+    record->command                        = SHARED_RING_COMMAND_FINISH;
+    record->flags                          = (uint8_t) finishMode;
+    record->moduleHandle                   = moduleHandle;
+    record->durationBeforeFadeOutInSeconds = durationBeforeFadeOutInSeconds;
+    record->shakeDurationInSeconds         = shakeDurationInSeconds;
+    sSharedRing->header.head.store(newHead, std::memory_order_release);
+    return true;
+}
+
+void SharedRing_Sync() {
+    std::unique_lock<std::mutex> lock(sSharedRingMutex);
+    if (sSharedRing != nullptr) {
+        SyncLocked(lock);
+    }
+}
+
+void SharedRing_Detach() {
+    std::unique_lock<std::mutex> lock(sSharedRingMutex);
+    // Finish callbacks of the remaining records are called here, without holding the lock.
+    while (sSharedRing != nullptr && !IsEmpty()) {
+        Process(lock);
+    }
+    if (sSharedRing == nullptr) {
+        return;
+    }
+    // Pushes that arrive from now on use the exported functions. The ring is empty, so they can't overtake a record.
+    auto *ring             = sSharedRing;
+    auto detachFunc        = sSharedRingDetachFunc;
+    sSharedRing            = nullptr;
+    sSharedRingProcessFunc = nullptr;
+    sSharedRingDetachFunc  = nullptr;
+    sSharedRingProcessDoneCondition.wait(lock, [] { return sSharedRingProcessCalls == 0; });
+
+    // Nothing is left to consume, so the module doesn't call any callbacks while the lock is held.
+    auto res = detachFunc();
+    if (res != NOTIFICATION_MODULE_RESULT_SUCCESS) {
+        // The module might still read it, leaking is the safe option.
+        DEBUG_FUNCTION_LINE_ERR("NMDetachSharedRing failed: %s", NotificationModule_GetStatusStr(res));
+    } else {
+        delete ring;
+    }
+}
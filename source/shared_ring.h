@@ -0,0 +1,101 @@
+#pragma once
+
+#include "notifications/notification_defines.h"
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Ring buffer in memory that is shared with the module. The library writes updates and finishes of dynamic
+ * notifications into it and the module consumes them in place, e.g. once per frame, instead of being called for
+ * every update. Module handles and texts are only valid for the module, the library never reads the ring.
+ *
+ * The ring is negotiated by NotificationModule_InitLibrary if the module exports NMAttachSharedRing,
+ * NMProcessSharedRing and NMDetachSharedRing. Otherwise (and for records that don't fit) the exported functions are
+ * called like before.
+ *
+ * Protocol (version 1):
+ *  - head and tail are byte counters that wrap at 2^32, the record at `tail` starts at data[tail & (capacity - 1)].
+ *  - Only the library writes head (release), only the module writes tail (release).
+ *  - The module reads records while tail != head (acquire) and advances tail by SharedRingRecord::size.
+ *    Records never wrap around, the rest of the data area is skipped with a SHARED_RING_COMMAND_PAD record.
+ *  - NMProcessSharedRing() consumes all published records before it returns. The library calls it when the ring
+ *    is full and before it calls other exports that affect dynamic notifications, so the order is kept.
+ *    It's called without holding any lock of the library, possibly from several threads at once and again from a
+ *    finish callback it calls. The module has to serialize its consumers itself and must not hold that lock while it
+ *    calls finish callbacks.
+ *  - NMDetachSharedRing() stops using the memory. The library lets the module consume all records first, so the
+ *    ring is empty and no callbacks are called by it.
+ */
+
+#define SHARED_RING_MAGIC    0x4E4D5247 // "NMRG"
+#define SHARED_RING_VERSION  1
+#define SHARED_RING_CAPACITY 0x4000
+
+typedef enum SharedRingCommand {
+    SHARED_RING_COMMAND_PAD    = 0, /* Skip to the start of the data area */
+    SHARED_RING_COMMAND_UPDATE = 1, /* NMUpdateDynamicNotification, flags is the field mask */
+    SHARED_RING_COMMAND_FINISH = 2, /* NMFinishDynamicNotification, flags is the NotificationModuleStatusFinish */
+} SharedRingCommand;
+
+struct SharedRingHeader {
+    uint32_t magic;      // SHARED_RING_MAGIC
+    uint32_t version;    // SHARED_RING_VERSION
+    uint32_t dataOffset; // Offset of the data area from the start of the header
+    uint32_t capacity;   // Size of the data area in bytes, a power of two
+    // On their own cache lines, each side only writes one of them.
+    alignas(64) std::atomic<uint32_t> head;
+    alignas(64) std::atomic<uint32_t> tail;
+};
+
+struct SharedRingRecord {
+    uint16_t size;   // Size of the record including the inline text, a multiple of alignof(SharedRingRecord)
+    uint8_t command; // SharedRingCommand
+    uint8_t flags;
+    NotificationModuleHandle moduleHandle;
+    NMColor textColor;
+    NMColor backgroundColor;
+    float durationBeforeFadeOutInSeconds;
+    float shakeDurationInSeconds;
+    // Set if the text is interned and stays valid until the library is deinitialized, it's not inlined then.
+    const char *sharedText;
+    // Length without the null terminator. Unless sharedText is set, the null terminated text follows the record.
+    uint32_t textLength;
+};
+
+typedef NotificationModuleStatus (*SharedRingAttachFunc)(SharedRingHeader *);
+typedef NotificationModuleStatus (*SharedRingProcessFunc)();
+typedef NotificationModuleStatus (*SharedRingDetachFunc)();
+
+/**
+ * Allocates the ring and hands it to the module. Returns false if the module rejected it or the allocation failed,
+ * the exported functions are used then.
+ */
+bool SharedRing_Attach(SharedRingAttachFunc attachFunc, SharedRingProcessFunc processFunc, SharedRingDetachFunc detachFunc);
+
+/**
+ * Writes an update into the ring. `update` has to be sanitized already. If `textIsShared` is set, only a pointer
+ * to the text is written. Returns false if no ring is attached or the record doesn't fit, the update has to be sent
+ * with the exported functions then (everything written before has been consumed by the module at that point).
+ */
+bool SharedRing_PushUpdate(NotificationModuleHandle moduleHandle, const NMDynamicUpdate &update, uint32_t fieldMask, bool textIsShared);
+
+/**
+ * Writes a finish into the ring. Returns false if no ring is attached.
+ */
+bool SharedRing_PushFinish(NotificationModuleHandle moduleHandle,
+                           NotificationModuleStatusFinish finishMode,
+                           float durationBeforeFadeOutInSeconds,
+                           float shakeDurationInSeconds);
+
+/**
+ * Lets the module consume everything that has been written. Has to be called before an exported function that
+ * affects dynamic notifications is called directly.
+ */
+void SharedRing_Sync();
+
+/**
+ * Detaches the ring from the module (which consumes the remaining records) and frees it.
+ * Called by NotificationModule_DeInitLibrary.
+ */
+void SharedRing_Detach();
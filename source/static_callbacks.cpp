@@ -0,0 +1,56 @@
+#include "static_callbacks.h"
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+struct StaticCallback {
+    NotificationModuleNotificationFinishedCallback callback;
+    void *callbackContext;
+};
+
+static std::mutex sStaticCallbacksMutex;
+static std::unordered_map<uint32_t, StaticCallback> sStaticCallbacks;
+// Ids aren't reused after a reset, so callbacks from before it can't hit a new entry.
+static uint32_t sNextStaticCallbackId = 1;
+
+static void StaticCallbackTrampoline(NotificationModuleHandle handle, void *context) {
+    StaticCallback cur;
+    {
+        std::lock_guard<std::mutex> lock(sStaticCallbacksMutex);
+        auto it = sStaticCallbacks.find((uint32_t) (uintptr_t) context);
+        if (it == sStaticCallbacks.end()) {
+            return;
+        }
+        cur = it->second;
+        sStaticCallbacks.erase(it);
+    }
+    cur.callback(handle, cur.callbackContext);
+}
+
+void StaticCallbacks_Wrap(NotificationModuleNotificationFinishedCallback &callback, void *&callbackContext) {
+    if (callback == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(sStaticCallbacksMutex);
+    uint32_t id = sNextStaticCallbackId++;
+    if (sNextStaticCallbackId == 0) {
+        sNextStaticCallbackId = 1;
+    }
+    sStaticCallbacks[id] = {callback, callbackContext};
+    callback             = StaticCallbackTrampoline;
+    callbackContext      = (void *) (uintptr_t) id;
+}
+
+void StaticCallbacks_Release(NotificationModuleNotificationFinishedCallback callback, void *callbackContext) {
+    if (callback != StaticCallbackTrampoline) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(sStaticCallbacksMutex);
+    sStaticCallbacks.erase((uint32_t) (uintptr_t) callbackContext);
+}
+
+void StaticCallbacks_Reset() {
+    std::lock_guard<std::mutex> lock(sStaticCallbacksMutex);
+    sStaticCallbacks.clear();
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "notifications/notification_defines.h"
+
+/**
+ * Finish callbacks of static notifications. The module has no way to detach them (unlike
+ * NMDetachDynamicNotificationCallbacks for dynamic notifications), so the module is given a trampoline of this library
+ * with an id as context instead. NotificationModule_DeInitLibrary forgets all ids, callbacks that arrive after that
+ * are ignored.
+ */
+
+/**
+ * Replaces `callback` and `callbackContext` with the trampoline if `callback` is set. Has to be undone with
+ * StaticCallbacks_Release if the module fails to add the notification.
+ */
+void StaticCallbacks_Wrap(NotificationModuleNotificationFinishedCallback &callback, void *&callbackContext);
+
+/**
+ * Forgets a callback wrapped by StaticCallbacks_Wrap without calling it. Does nothing for callbacks that haven't been wrapped.
+ */
+void StaticCallbacks_Release(NotificationModuleNotificationFinishedCallback callback, void *callbackContext);
+
+/**
+ * Forgets all callbacks that haven't been called yet. Called by NotificationModule_DeInitLibrary.
+ */
+void StaticCallbacks_Reset();
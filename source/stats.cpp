@@ -0,0 +1,222 @@
+#include "stats.h"
+#include "internal.h"
+#include "logger.h"
+#include "scheduler.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <notifications/notifications.h>
+#include <string>
+#include <vector>
+
+#define STATS_HEADER_MAGIC       0x4E4D5348 // "NMSH"
+#define STATS_RECORD_MAGIC       0x4E4D5352 // "NMSR"
+#define STATS_VERSION            1
+#define STATS_NUM_BUCKETS        6
+// Records are collected in memory and written once this much data is buffered.
+#define STATS_CHUNK_SIZE         4096
+#define STATS_MIN_INTERVAL_IN_MS 100
+
+// All values in a stats file are stored in big endian, see tools/nmstats2csv.py for the layout.
+
+// Every status gets its own counter, unknown values are counted as NOTIFICATION_MODULE_RESULT_UNKNOWN_ERROR (the last entry).
+static const NotificationModuleStatus sStatsStatuses[] = {
+        NOTIFICATION_MODULE_RESULT_SUCCESS,
+        NOTIFICATION_MODULE_RESULT_MODULE_NOT_FOUND,
+        NOTIFICATION_MODULE_RESULT_MODULE_MISSING_EXPORT,
+        NOTIFICATION_MODULE_RESULT_UNSUPPORTED_VERSION,
+        NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT,
+        NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED,
+        NOTIFICATION_MODULE_RESULT_UNSUPPORTED_COMMAND,
+        NOTIFICATION_MODULE_RESULT_OVERLAY_NOT_READY,
+        NOTIFICATION_MODULE_RESULT_UNSUPPORTED_TYPE,
+        NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED,
+        NOTIFICATION_MODULE_RESULT_INVALID_HANDLE,
+        NOTIFICATION_MODULE_RESULT_QUOTA_EXCEEDED,
+        NOTIFICATION_MODULE_RESULT_UNKNOWN_ERROR,
+};
+#define STATS_NUM_STATUSES (sizeof(sStatsStatuses) / sizeof(sStatsStatuses[0]))
+
+// Upper bounds (exclusive) of the latency buckets in microseconds, the last bucket has no limit.
+static const uint32_t sStatsBucketLimitsInUs[STATS_NUM_BUCKETS] = {10, 100, 1000, 10000, 100000, 0xFFFFFFFF};
+
+static std::atomic<uint32_t> sStatsCalls{0};
+static std::atomic<uint32_t> sStatsFailures{0};
+static std::atomic<uint32_t> sStatsSuppressed{0};
+static std::atomic<uint32_t> sStatsCoalesced{0};
+static std::atomic<uint32_t> sStatsStatusCounts[STATS_NUM_STATUSES];
+static std::atomic<uint32_t> sStatsLatencyBuckets[STATS_NUM_BUCKETS];
+
+static std::mutex sStatsExportMutex;
+static std::string sStatsExportPath;
+static std::vector<uint8_t> sStatsBuffer;
+static uint32_t sStatsIntervalInUs  = 0;
+static SchedulerTaskId sStatsTaskId = 0;
+
+void Stats_RecordCall(NotificationModuleStatus status, uint64_t latencyInUs) {
+    sStatsCalls.fetch_add(1, std::memory_order_relaxed);
+    if (status != NOTIFICATION_MODULE_RESULT_SUCCESS) {
+        sStatsFailures.fetch_add(1, std::memory_order_relaxed);
+    }
+    uint32_t statusIndex = STATS_NUM_STATUSES - 1;
+    for (uint32_t i = 0; i < STATS_NUM_STATUSES; i++) {
+        if (sStatsStatuses[i] == status) {
+            statusIndex = i;
+            break;
+        }
+    }
+    sStatsStatusCounts[statusIndex].fetch_add(1, std::memory_order_relaxed);
+    uint32_t bucket = 0;
+    while (bucket < STATS_NUM_BUCKETS - 1 && latencyInUs >= sStatsBucketLimitsInUs[bucket]) {
+        bucket++;
+    }
+    sStatsLatencyBuckets[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+void Stats_RecordSuppressed() {
+    sStatsSuppressed.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Stats_RecordCoalesced() {
+    sStatsCoalesced.fetch_add(1, std::memory_order_relaxed);
+}
+
+static void AppendBE16(uint16_t val) {
+    sStatsBuffer.push_back(val >> 8);
+    sStatsBuffer.push_back(val & 0xFF);
+}
+
+static void AppendBE32(uint32_t val) {
+    AppendBE16(val >> 16);
+    AppendBE16(val & 0xFFFF);
+}
+
+// Has to be called while holding sStatsExportMutex.
+static void AppendHeader() {
+    AppendBE32(STATS_HEADER_MAGIC);
+    AppendBE16(STATS_VERSION);
+    AppendBE16(STATS_NUM_STATUSES);
+    AppendBE16(STATS_NUM_BUCKETS);
+    AppendBE16(0);
+    AppendBE32(sStatsIntervalInUs);
+    for (auto status : sStatsStatuses) {
+        AppendBE32((uint32_t) status);
+    }
+    for (auto limit : sStatsBucketLimitsInUs) {
+        AppendBE32(limit);
+    }
+}
+
+// Has to be called while holding sStatsExportMutex. The counters are never reset, the reader calculates the deltas.
+static void AppendRecord(uint64_t nowInUs) {
+    AppendBE32(STATS_RECORD_MAGIC);
+    AppendBE32(nowInUs >> 32);
+    AppendBE32(nowInUs & 0xFFFFFFFF);
+    AppendBE32(sStatsCalls.load(std::memory_order_relaxed));
+    AppendBE32(sStatsFailures.load(std::memory_order_relaxed));
+    AppendBE32(sStatsSuppressed.load(std::memory_order_relaxed));
+    AppendBE32(sStatsCoalesced.load(std::memory_order_relaxed));
+    for (const auto &count : sStatsStatusCounts) {
+        AppendBE32(count.load(std::memory_order_relaxed));
+    }
+    for (const auto &count : sStatsLatencyBuckets) {
+        AppendBE32(count.load(std::memory_order_relaxed));
+    }
+}
+
+// Has to be called while holding sStatsExportMutex.
+static void FlushBuffer() {
+    if (sStatsBuffer.empty()) {
+        return;
+    }
+    FILE *f = fopen(sStatsExportPath.c_str(), "ab");
+    if (f == nullptr) {
+        DEBUG_FUNCTION_LINE_ERR("Failed to open %s, dropping %d bytes of stats", sStatsExportPath.c_str(), (int) sStatsBuffer.size());
+    } else {
+        if (fwrite(sStatsBuffer.data(), 1, sStatsBuffer.size(), f) != sStatsBuffer.size()) {
+            DEBUG_FUNCTION_LINE_ERR("Failed to write stats to %s", sStatsExportPath.c_str());
+        }
+        fclose(f);
+    }
+    sStatsBuffer.clear();
+}
+
+static uint32_t StatsExportTask(void *, uint64_t nowInUs) {
+    std::lock_guard<std::mutex> lock(sStatsExportMutex);
+    AppendRecord(nowInUs);
+    if (sStatsBuffer.size() + STATS_CHUNK_SIZE / 8 > STATS_CHUNK_SIZE) {
+        FlushBuffer();
+    }
+    return sStatsIntervalInUs;
+}
+
+// Has to be called while holding sStatsExportMutex, the task must not be registered anymore.
+static void StopExport() {
+    if (sStatsExportPath.empty()) {
+        return;
+    }
+    AppendRecord(Scheduler_GetTimeInUs());
+    FlushBuffer();
+    sStatsExportPath.clear();
+    sStatsBuffer.shrink_to_fit();
+}
+
+void Stats_Reset() {
+    std::lock_guard<std::mutex> lock(sStatsExportMutex);
+    // The scheduler task is removed by Scheduler_Shutdown.
+    sStatsTaskId = 0;
+    StopExport();
+    sStatsCalls      = 0;
+    sStatsFailures   = 0;
+    sStatsSuppressed = 0;
+    sStatsCoalesced  = 0;
+    for (auto &count : sStatsStatusCounts) {
+        count = 0;
+    }
+    for (auto &count : sStatsLatencyBuckets) {
+        count = 0;
+    }
+}
+
+NotificationModuleStatus NotificationModule_StartStatsExport(const char *path, uint32_t intervalInMs) {
+    if (!NotificationModule_IsLibInitialized()) {
+        return NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED;
+    }
+    if (path == nullptr || path[0] == '\0' || intervalInMs < STATS_MIN_INTERVAL_IN_MS) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    NotificationModule_StopStatsExport();
+
+    std::lock_guard<std::mutex> lock(sStatsExportMutex);
+    sStatsExportPath   = path;
+    sStatsIntervalInUs = intervalInMs * 1000;
+    sStatsBuffer.reserve(STATS_CHUNK_SIZE);
+    // Every export starts with a header, so a file can contain several exports.
+    AppendHeader();
+    AppendRecord(Scheduler_GetTimeInUs());
+    sStatsTaskId = Scheduler_AddTask(StatsExportTask, nullptr, sStatsIntervalInUs);
+    if (sStatsTaskId == 0) {
+        sStatsExportPath.clear();
+        sStatsBuffer.clear();
+        return NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED;
+    }
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+NotificationModuleStatus NotificationModule_StopStatsExport() {
+    SchedulerTaskId taskId;
+    {
+        std::lock_guard<std::mutex> lock(sStatsExportMutex);
+        taskId       = sStatsTaskId;
+        sStatsTaskId = 0;
+    }
+    // Waits for a running export task, so it can't touch the buffer anymore.
+    if (taskId != 0) {
+        Scheduler_RemoveTask(taskId);
+    }
+    std::lock_guard<std::mutex> lock(sStatsExportMutex);
+    StopExport();
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "notifications/notification_defines.h"
+
+/**
+ * Counters of the library that can be exported with NotificationModule_StartStatsExport.
+ * Recording only updates atomics, all file I/O happens on the scheduler thread or in NotificationModule_StopStatsExport.
+ */
+
+/**
+ * Records the result and the latency of a call into the module.
+ */
+void Stats_RecordCall(NotificationModuleStatus status, uint64_t latencyInUs);
+
+/**
+ * Records a notification that has been dropped by the library, e.g. because of a quota.
+ */
+void Stats_RecordSuppressed();
+
+/**
+ * Records a notification that has been merged into another one, e.g. a duplicate.
+ */
+void Stats_RecordCoalesced();
+
+/**
+ * Stops the export and writes the remaining data. Has to be called after Scheduler_Shutdown.
+ * Called by NotificationModule_DeInitLibrary.
+ */
+void Stats_Reset();
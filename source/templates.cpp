@@ -0,0 +1,298 @@
+#include "templates.h"
+#include "logger.h"
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#define TEMPLATE_MAX_FLOAT_PRECISION 9
+
+enum TemplateSegmentType : uint8_t {
+    TEMPLATE_SEGMENT_LITERAL,
+    TEMPLATE_SEGMENT_INT,
+    TEMPLATE_SEGMENT_UINT,
+    TEMPLATE_SEGMENT_HEX,
+    TEMPLATE_SEGMENT_HEX_UPPER,
+    TEMPLATE_SEGMENT_FLOAT,
+    TEMPLATE_SEGMENT_STRING,
+};
+
+struct TemplateSegment {
+    TemplateSegmentType type;
+    uint8_t precision; // Only used by TEMPLATE_SEGMENT_FLOAT
+    uint16_t length;   // Only used by TEMPLATE_SEGMENT_LITERAL
+    uint32_t offset;   // Only used by TEMPLATE_SEGMENT_LITERAL, offset into NotificationTemplate::literals
+};
+
+struct NotificationTemplate {
+    NotificationModuleNotificationType profile;
+    uint32_t numArgs;
+    std::vector<TemplateSegment> segments;
+    std::string literals;
+};
+
+static std::mutex sTemplatesMutex;
+// Template for id `n` is stored at index `n - 1`.
+static std::vector<std::unique_ptr<NotificationTemplate>> sTemplates;
+
+namespace {
+    class TextWriter {
+    public:
+        TextWriter(char *buffer, uint32_t size) : mCur(buffer), mEnd(buffer + size - 1) {}
+
+        void Append(const char *str, uint32_t length) {
+            uint32_t left = mEnd - mCur;
+            if (length > left) {
+                length = left;
+            }
+            memcpy(mCur, str, length);
+            mCur += length;
+        }
+
+        void AppendChar(char c) {
+            if (mCur < mEnd) {
+                *mCur++ = c;
+            }
+        }
+
+        void AppendUInt(uint64_t value, uint32_t minDigits = 1) {
+            char tmp[20];
+            char *p = tmp + sizeof(tmp);
+            do {
+                *--p = (char) ('0' + (value % 10));
+                value /= 10;
+            } while (value != 0 || (uint32_t) ((tmp + sizeof(tmp)) - p) < minDigits);
+            Append(p, (tmp + sizeof(tmp)) - p);
+        }
+
+        void AppendHex(uint32_t value, bool upperCase) {
+            const char *digits = upperCase ? "0123456789ABCDEF" : "0123456789abcdef";
+            char tmp[8];
+            char *p = tmp + sizeof(tmp);
+            do {
+                *--p = digits[value & 0xF];
+                value >>= 4;
+            } while (value != 0);
+            Append(p, (tmp + sizeof(tmp)) - p);
+        }
+
+        void AppendFloat(float value, uint32_t precision) {
+            static constexpr uint64_t sPow10[TEMPLATE_MAX_FLOAT_PRECISION + 1] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+            double v = value;
+            // Fall back to snprintf for NaN, inf and values that don't fit into the fixed point conversion.
+            if (v != v || v > 4e9 || v < -4e9) {
+                char tmp[64];
+                int len = snprintf(tmp, sizeof(tmp), "%.*f", (int) precision, v);
+                if (len > 0) {
+                    Append(tmp, (uint32_t) len < sizeof(tmp) ? len : sizeof(tmp) - 1);
+                }
+                return;
+            }
+            if (v < 0) {
+                AppendChar('-');
+                v = -v;
+            }
+            uint64_t scale = sPow10[precision];
+            auto fixed     = (uint64_t) (v * (double) scale + 0.5);
+            AppendUInt(fixed / scale);
+            if (precision > 0) {
+                AppendChar('.');
+                AppendUInt(fixed % scale, precision);
+            }
+        }
+
+        void Terminate() {
+            *mCur = '\0';
+        }
+
+    private:
+        char *mCur;
+        char *mEnd;
+    };
+} // namespace
+
+static void AddLiteral(NotificationTemplate &tmpl, const char *str, uint32_t length) {
+    if (length == 0) {
+        return;
+    }
+    auto &segments = tmpl.segments;
+    // Merge with the previous literal, this happens for "%%".
+    if (!segments.empty() && segments.back().type == TEMPLATE_SEGMENT_LITERAL &&
+        segments.back().offset + segments.back().length == tmpl.literals.size()) {
+        segments.back().length += length;
+    } else {
+        segments.push_back({TEMPLATE_SEGMENT_LITERAL, 0, (uint16_t) length, (uint32_t) tmpl.literals.size()});
+    }
+    tmpl.literals.append(str, length);
+}
+
+static bool ParseTemplate(const char *format, NotificationTemplate &tmpl) {
+    const char *literalStart = format;
+    const char *p            = format;
+    while (*p) {
+        if (*p != '%') {
+            p++;
+            continue;
+        }
+        AddLiteral(tmpl, literalStart, p - literalStart);
+        p++;
+
+        uint32_t precision = 6;
+        if (*p == '.') {
+            p++;
+            precision = 0;
+            while (*p >= '0' && *p <= '9') {
+                precision = precision * 10 + (*p++ - '0');
+                if (precision > TEMPLATE_MAX_FLOAT_PRECISION) {
+                    return false;
+                }
+            }
+            if (*p != 'f') {
+                return false;
+            }
+        }
+
+        TemplateSegmentType type;
+        switch (*p) {
+            case '%':
+                AddLiteral(tmpl, "%", 1);
+                p++;
+                literalStart = p;
+                continue;
+            case 'd':
+            case 'i':
+                type = TEMPLATE_SEGMENT_INT;
+                break;
+            case 'u':
+                type = TEMPLATE_SEGMENT_UINT;
+                break;
+            case 'x':
+                type = TEMPLATE_SEGMENT_HEX;
+                break;
+            case 'X':
+                type = TEMPLATE_SEGMENT_HEX_UPPER;
+                break;
+            case 'f':
+                type = TEMPLATE_SEGMENT_FLOAT;
+                break;
+            case 's':
+                type = TEMPLATE_SEGMENT_STRING;
+                break;
+            default:
+                return false;
+        }
+        tmpl.segments.push_back({type, (uint8_t) precision, 0, 0});
+        tmpl.numArgs++;
+        p++;
+        literalStart = p;
+    }
+    AddLiteral(tmpl, literalStart, p - literalStart);
+    return true;
+}
+
+NotificationModuleStatus Templates_Register(const char *format, NotificationModuleNotificationType profile, NotificationModuleTemplateId *outId) {
+    if (format == nullptr || outId == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    if (profile < NOTIFICATION_MODULE_NOTIFICATION_TYPE_INFO || profile > NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC || strlen(format) > 0xFFFF) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+
+    auto tmpl     = std::make_unique<NotificationTemplate>();
+    tmpl->profile = profile;
+    tmpl->numArgs = 0;
+    if (!ParseTemplate(format, *tmpl)) {
+        DEBUG_FUNCTION_LINE_ERR("Unsupported format string: \"%s\"", format);
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> lock(sTemplatesMutex);
+    sTemplates.push_back(std::move(tmpl));
+    *outId = sTemplates.size();
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+NotificationModuleStatus Templates_Render(NotificationModuleTemplateId id,
+                                          const NMTemplateArg *args,
+                                          uint32_t numArgs,
+                                          char *outBuffer,
+                                          uint32_t bufferSize,
+                                          NotificationModuleNotificationType *outProfile) {
+    if (outBuffer == nullptr || bufferSize == 0 || (args == nullptr && numArgs > 0)) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+
+    const NotificationTemplate *tmpl;
+    {
+        std::lock_guard<std::mutex> lock(sTemplatesMutex);
+        if (id == NOTIFICATION_MODULE_TEMPLATE_ID_INVALID || id > sTemplates.size()) {
+            return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+        }
+        // Templates are immutable and never freed, it's safe to use them without holding the lock.
+        tmpl = sTemplates[id - 1].get();
+    }
+
+    if (numArgs != tmpl->numArgs) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+
+    TextWriter writer(outBuffer, bufferSize);
+    const NMTemplateArg *arg = args;
+    for (const auto &segment : tmpl->segments) {
+        if (segment.type == TEMPLATE_SEGMENT_LITERAL) {
+            writer.Append(tmpl->literals.data() + segment.offset, segment.length);
+            continue;
+        }
+        switch (segment.type) {
+            case TEMPLATE_SEGMENT_INT:
+                if (arg->type != NOTIFICATION_MODULE_TEMPLATE_ARG_TYPE_INT) {
+                    return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+                }
+                if (arg->value.i32 < 0) {
+                    writer.AppendChar('-');
+                    writer.AppendUInt(-(int64_t) arg->value.i32);
+                } else {
+                    writer.AppendUInt(arg->value.i32);
+                }
+                break;
+            case TEMPLATE_SEGMENT_UINT:
+            case TEMPLATE_SEGMENT_HEX:
+            case TEMPLATE_SEGMENT_HEX_UPPER:
+                if (arg->type != NOTIFICATION_MODULE_TEMPLATE_ARG_TYPE_UINT) {
+                    return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+                }
+                if (segment.type == TEMPLATE_SEGMENT_UINT) {
+                    writer.AppendUInt(arg->value.u32);
+                } else {
+                    writer.AppendHex(arg->value.u32, segment.type == TEMPLATE_SEGMENT_HEX_UPPER);
+                }
+                break;
+            case TEMPLATE_SEGMENT_FLOAT:
+                if (arg->type != NOTIFICATION_MODULE_TEMPLATE_ARG_TYPE_FLOAT) {
+                    return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+                }
+                writer.AppendFloat(arg->value.f, segment.precision);
+                break;
+            case TEMPLATE_SEGMENT_STRING: {
+                if (arg->type != NOTIFICATION_MODULE_TEMPLATE_ARG_TYPE_STRING) {
+                    return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+                }
+                const char *str = arg->value.str ? arg->value.str : "(null)";
+                writer.Append(str, strnlen(str, bufferSize));
+                break;
+            }
+            case TEMPLATE_SEGMENT_LITERAL:
+                break;
+        }
+        arg++;
+    }
+    writer.Terminate();
+
+    if (outProfile) {
+        *outProfile = tmpl->profile;
+    }
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "notifications/notification_defines.h"
+
+#define NOTIFICATION_TEMPLATE_MAX_TEXT_LENGTH 256
+
+/**
+ * Parses `format` into a list of segments and stores it. Templates are never freed.
+ */
+NotificationModuleStatus Templates_Register(const char *format, NotificationModuleNotificationType profile, NotificationModuleTemplateId *outId);
+
+/**
+ * Renders a registered template into `outBuffer`. The output is truncated (on a byte boundary) if it doesn't fit.
+ */
+NotificationModuleStatus Templates_Render(NotificationModuleTemplateId id,
+                                          const NMTemplateArg *args,
+                                          uint32_t numArgs,
+                                          char *outBuffer,
+                                          uint32_t bufferSize,
+                                          NotificationModuleNotificationType *outProfile);
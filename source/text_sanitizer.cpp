@@ -0,0 +1,157 @@
+#include "text_sanitizer.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+#define ELLIPSIS_LENGTH 3
+
+// Native word of the target, 4 bytes on the Wii U.
+typedef unsigned long SanitizerWord;
+
+static constexpr SanitizerWord WORD_HIGH_BITS = ((SanitizerWord) ~0UL / 0xFF) * 0x80;
+
+static std::atomic<uint32_t> sMaxTextLength(0);
+
+void TextSanitizer_SetMaxLength(uint32_t maxLengthInCodePoints) {
+    sMaxTextLength = maxLengthInCodePoints;
+}
+
+/**
+ * Returns the length of the valid UTF-8 sequence starting at `p`, or 0 if it's invalid.
+ * Rejects overlong encodings, surrogates and code points above U+10FFFF.
+ */
+static uint32_t ValidSequenceLength(const uint8_t *p, const uint8_t *end) {
+    uint8_t c = p[0];
+    if (c < 0x80) {
+        return 1;
+    }
+    if (c < 0xC2) {
+        return 0;
+    }
+    if (c < 0xE0) {
+        return (end - p >= 2 && (p[1] & 0xC0) == 0x80) ? 2 : 0;
+    }
+    if (c < 0xF0) {
+        if (end - p < 3 || (p[1] & 0xC0) != 0x80 || (p[2] & 0xC0) != 0x80) {
+            return 0;
+        }
+        if ((c == 0xE0 && p[1] < 0xA0) || (c == 0xED && p[1] >= 0xA0)) {
+            return 0;
+        }
+        return 3;
+    }
+    if (c < 0xF5) {
+        if (end - p < 4 || (p[1] & 0xC0) != 0x80 || (p[2] & 0xC0) != 0x80 || (p[3] & 0xC0) != 0x80) {
+            return 0;
+        }
+        if ((c == 0xF0 && p[1] < 0x90) || (c == 0xF4 && p[1] >= 0x90)) {
+            return 0;
+        }
+        return 4;
+    }
+    return 0;
+}
+
+/**
+ * Returns true if the text contains invalid UTF-8 or is longer than `maxCodePoints`.
+ * Runs of ASCII are checked a whole word at a time.
+ */
+static bool NeedsSanitizing(const uint8_t *text, uint32_t length, uint32_t maxCodePoints) {
+    const uint8_t *p    = text;
+    const uint8_t *end  = text + length;
+    uint32_t codePoints = 0;
+    while (p < end) {
+        while ((uint32_t) (end - p) >= sizeof(SanitizerWord)) {
+            SanitizerWord word;
+            memcpy(&word, p, sizeof(word));
+            if (word & WORD_HIGH_BITS) {
+                break;
+            }
+            p += sizeof(word);
+            codePoints += sizeof(word);
+        }
+        if (p >= end) {
+            break;
+        }
+        uint32_t sequenceLength = ValidSequenceLength(p, end);
+        if (sequenceLength == 0) {
+            return true;
+        }
+        p += sequenceLength;
+        codePoints++;
+        // The text gets truncated anyway, the rest doesn't have to be checked.
+        if (maxCodePoints != 0 && codePoints > maxCodePoints) {
+            return true;
+        }
+    }
+    return maxCodePoints != 0 && codePoints > maxCodePoints;
+}
+
+static void WriteSanitized(const uint8_t *text, uint32_t length, uint32_t maxCodePoints, char *out) {
+    const uint8_t *p    = text;
+    const uint8_t *end  = text + length;
+    uint32_t codePoints = 0;
+    uint32_t cutAt      = maxCodePoints > ELLIPSIS_LENGTH ? maxCodePoints - ELLIPSIS_LENGTH : maxCodePoints;
+    char *cut           = out;
+    while (p < end) {
+        if (maxCodePoints != 0) {
+            if (codePoints == cutAt) {
+                cut = out;
+            }
+            if (codePoints == maxCodePoints) {
+                out = cut;
+                if (maxCodePoints > ELLIPSIS_LENGTH) {
+                    memcpy(out, "...", ELLIPSIS_LENGTH);
+                    out += ELLIPSIS_LENGTH;
+                }
+                break;
+            }
+        }
+        uint32_t sequenceLength = ValidSequenceLength(p, end);
+        if (sequenceLength == 0) {
+            // U+FFFD REPLACEMENT CHARACTER
+            memcpy(out, "\xEF\xBF\xBD", 3);
+            out += 3;
+            p++;
+        } else {
+            memcpy(out, p, sequenceLength);
+            out += sequenceLength;
+            p += sequenceLength;
+        }
+        codePoints++;
+    }
+    *out = '\0';
+}
+
+SanitizedText::SanitizedText(const char *text) {
+    if (text == nullptr) {
+        return;
+    }
+    uint32_t maxCodePoints = sMaxTextLength;
+    uint32_t length        = strlen(text);
+    if (!NeedsSanitizing((const uint8_t *) text, length, maxCodePoints)) {
+        mText = text;
+        return;
+    }
+
+    // Every input byte turns into at most 3 output bytes (U+FFFD), every output code point is at most 4 bytes.
+    uint32_t maxOutputLength = length * 3;
+    if (maxCodePoints != 0 && maxOutputLength > maxCodePoints * 4) {
+        maxOutputLength = maxCodePoints * 4;
+    }
+    char *buffer = mStackBuffer;
+    if (maxOutputLength + 1 > sizeof(mStackBuffer)) {
+        mHeapBuffer = (char *) malloc(maxOutputLength + 1);
+        if (mHeapBuffer == nullptr) {
+            return;
+        }
+        buffer = mHeapBuffer;
+    }
+    WriteSanitized((const uint8_t *) text, length, maxCodePoints, buffer);
+    mText = buffer;
+}
+
+SanitizedText::~SanitizedText() {
+    free(mHeapBuffer);
+}
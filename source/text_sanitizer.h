@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+
+#define TEXT_SANITIZER_STACK_BUFFER_SIZE 256
+
+void TextSanitizer_SetMaxLength(uint32_t maxLengthInCodePoints);
+
+/**
+ * Validates a text before it's passed to the module.
+ * Invalid UTF-8 sequences are replaced with U+FFFD and texts longer than the configured max length
+ * are truncated on a code point boundary and end with "...".
+ *
+ * c_str() returns the original text if it's valid and short enough, otherwise a sanitized copy that is valid
+ * until this object is destroyed. c_str() returns NULL if the text was NULL or allocating the copy failed.
+ */
+class SanitizedText {
+public:
+    explicit SanitizedText(const char *text);
+
+    ~SanitizedText();
+
+    SanitizedText(const SanitizedText &) = delete;
+
+    SanitizedText &operator=(const SanitizedText &) = delete;
+
+    [[nodiscard]] const char *c_str() const {
+        return mText;
+    }
+
+private:
+    const char *mText = nullptr;
+    char *mHeapBuffer = nullptr;
+    char mStackBuffer[TEXT_SANITIZER_STACK_BUFFER_SIZE];
+};
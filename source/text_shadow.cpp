@@ -0,0 +1,134 @@
+#include "text_shadow.h"
+#include "handle_table.h"
+
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+
+struct TextShadowEntry {
+    // Held while an update is sent, see TextShadowUpdate.
+    std::mutex mutex;
+    NotificationModuleHandle handle = 0;
+    std::string text;
+};
+
+// Only protects the size of sTextShadowEntries, entries are protected by their own mutex.
+static std::mutex sTextShadowMutex;
+// Indexed by the handle table slot, a deque keeps the entries at a stable address.
+static std::deque<TextShadowEntry> sTextShadowEntries;
+
+static TextShadowEntry *GetEntry(NotificationModuleHandle handle, bool create) {
+    uint32_t index = HandleTable_GetSlotIndex(handle);
+    std::lock_guard<std::mutex> lock(sTextShadowMutex);
+    if (index >= sTextShadowEntries.size()) {
+        if (!create) {
+            return nullptr;
+        }
+        // Entries can't be moved because of the mutex, so they are added one by one.
+        while (sTextShadowEntries.size() <= index) {
+            sTextShadowEntries.emplace_back();
+        }
+    }
+    return &sTextShadowEntries[index];
+}
+
+static inline bool IsContinuationByte(char c) {
+    return ((uint8_t) c & 0xC0) == 0x80;
+}
+
+void TextShadow_Track(NotificationModuleHandle handle, const char *text) {
+    auto *entry = GetEntry(handle, true);
+    std::lock_guard<std::mutex> lock(entry->mutex);
+    entry->handle = handle;
+    entry->text.assign(text);
+}
+
+void TextShadow_Untrack(NotificationModuleHandle handle) {
+    auto *entry = GetEntry(handle, false);
+    if (entry == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(entry->mutex);
+    if (entry->handle == handle) {
+        entry->handle = 0;
+        std::string().swap(entry->text);
+    }
+}
+
+void TextShadow_Reset() {
+    std::lock_guard<std::mutex> lock(sTextShadowMutex);
+    sTextShadowEntries.clear();
+}
+
+TextShadowUpdate::TextShadowUpdate(NotificationModuleHandle handle, const char *newText) {
+    if (newText == nullptr) {
+        return;
+    }
+    mNewText   = newText;
+    mNewLength = strlen(newText);
+    mEntry     = GetEntry(handle, false);
+    if (mEntry == nullptr) {
+        return;
+    }
+    mEntry->mutex.lock();
+    if (mEntry->handle != handle) {
+        mEntry->mutex.unlock();
+        mEntry = nullptr;
+    }
+}
+
+TextShadowUpdate::~TextShadowUpdate() {
+    if (mEntry != nullptr) {
+        mEntry->mutex.unlock();
+    }
+}
+
+bool TextShadowUpdate::IsUnchanged() const {
+    return mEntry != nullptr && mEntry->text.size() == mNewLength && memcmp(mEntry->text.data(), mNewText, mNewLength) == 0;
+}
+
+bool TextShadowUpdate::GetSplice(TextSplice *outSplice) const {
+    if (mEntry == nullptr) {
+        return false;
+    }
+    const char *oldText = mEntry->text.data();
+    uint32_t oldLength  = mEntry->text.size();
+    uint32_t maxCommon  = oldLength < mNewLength ? oldLength : mNewLength;
+
+    uint32_t prefix = 0;
+    while (prefix < maxCommon && oldText[prefix] == mNewText[prefix]) {
+        prefix++;
+    }
+    uint32_t suffix = 0;
+    while (suffix < maxCommon - prefix && oldText[oldLength - 1 - suffix] == mNewText[mNewLength - 1 - suffix]) {
+        suffix++;
+    }
+    // Don't split code points, so the module only ever sees complete UTF-8 sequences.
+    while (prefix > 0 && (IsContinuationByte(oldText[prefix]) || IsContinuationByte(mNewText[prefix]))) {
+        prefix--;
+    }
+    while (suffix > 0 && (IsContinuationByte(oldText[oldLength - suffix]) || IsContinuationByte(mNewText[mNewLength - suffix]))) {
+        suffix--;
+    }
+    if (prefix == 0 && suffix == 0) {
+        return false;
+    }
+
+    outSplice->offset         = prefix;
+    outSplice->removedLength  = oldLength - prefix - suffix;
+    outSplice->inserted       = mNewText + prefix;
+    outSplice->insertedLength = mNewLength - prefix - suffix;
+    return true;
+}
+
+void TextShadowUpdate::Commit(bool success) {
+    if (mEntry == nullptr) {
+        return;
+    }
+    if (success) {
+        mEntry->text.assign(mNewText, mNewLength);
+    } else {
+        mEntry->handle = 0;
+    }
+}
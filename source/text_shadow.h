@@ -0,0 +1,65 @@
+#pragma once
+
+#include "notifications/notification_defines.h"
+
+#include <cstdint>
+
+/**
+ * Library side copy of the current text of every dynamic notification. It's used to skip updates that don't change
+ * the text and to send only the changed part of a text (a splice) to modules that support it.
+ */
+
+struct TextSplice {
+    uint32_t offset;         // Byte offset of the first changed byte in the old text
+    uint32_t removedLength;  // Number of bytes of the old text that are replaced
+    const char *inserted;    // Bytes that replace them, not null terminated
+    uint32_t insertedLength; // Number of inserted bytes
+};
+
+/**
+ * Starts tracking the text of a new dynamic notification. `text` has to be sanitized already.
+ */
+void TextShadow_Track(NotificationModuleHandle handle, const char *text);
+
+/**
+ * Stops tracking a handle. Called when a dynamic notification is finished.
+ */
+void TextShadow_Untrack(NotificationModuleHandle handle);
+
+/**
+ * Drops all shadows. Called by NotificationModule_DeInitLibrary.
+ */
+void TextShadow_Reset();
+
+struct TextShadowEntry;
+
+/**
+ * Compares a new text with the shadow of a handle. The shadow stays locked until this object is destroyed, so
+ * concurrent updates of the same notification reach the module in the same order as they are applied to the shadow.
+ * Commit() has to be called after the text has been sent.
+ */
+class TextShadowUpdate {
+public:
+    // `newText` has to be sanitized already, NULL if the update doesn't change the text.
+    TextShadowUpdate(NotificationModuleHandle handle, const char *newText);
+
+    ~TextShadowUpdate();
+
+    TextShadowUpdate(const TextShadowUpdate &) = delete;
+
+    TextShadowUpdate &operator=(const TextShadowUpdate &) = delete;
+
+    // True if the new text is equal to the current text of the notification.
+    [[nodiscard]] bool IsUnchanged() const;
+
+    // Returns false if the current text is unknown or has nothing in common with the new text.
+    bool GetSplice(TextSplice *outSplice) const;
+
+    // Stores the new text if it has been sent successfully, otherwise the text of the notification is unknown.
+    void Commit(bool success);
+
+private:
+    TextShadowEntry *mEntry = nullptr;
+    const char *mNewText    = nullptr;
+    uint32_t mNewLength     = 0;
+};
@@ -0,0 +1,130 @@
+#include "timer_wheel.h"
+
+#include <algorithm>
+
+TimerWheel::TimerWheel(uint32_t tickInUs) : mTickInUs(tickInUs) {
+    for (auto &level : mSlots) {
+        for (auto &head : level) {
+            head.prev = &head;
+            head.next = &head;
+        }
+    }
+}
+
+void TimerWheel::Unlink(TimerWheelNode *node) {
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+    node->prev       = nullptr;
+    node->next       = nullptr;
+}
+
+void TimerWheel::Insert(TimerWheelNode *node) {
+    uint64_t delta = node->deadlineInTicks - mCurrentTick;
+    TimerWheelNode *head;
+    if (delta > MAX_DELTA) {
+        // Too far in the future, park it in the last slot of the highest level, it's reinserted when that slot is cascaded.
+        head = &mSlots[LEVELS - 1][((mCurrentTick >> ((LEVELS - 1) * SLOT_BITS)) + SLOT_MASK) & SLOT_MASK];
+    } else {
+        uint32_t level = 0;
+        while (level < LEVELS - 1 && delta >= (1ULL << ((level + 1) * SLOT_BITS))) {
+            level++;
+        }
+        head = &mSlots[level][(node->deadlineInTicks >> (level * SLOT_BITS)) & SLOT_MASK];
+    }
+    node->prev       = head->prev;
+    node->next       = head;
+    head->prev->next = node;
+    head->prev       = node;
+}
+
+void TimerWheel::Schedule(TimerWheelNode *node, uint64_t deadlineInUs, uint64_t nowInUs) {
+    if (IsScheduled(node)) {
+        Unlink(node);
+    } else {
+        if (mCount == 0) {
+            // Nothing to catch up on, skip the ticks that passed while the wheel was empty.
+            mCurrentTick = nowInUs / mTickInUs;
+        }
+        mCount++;
+    }
+    uint64_t deadlineInTicks = (deadlineInUs + mTickInUs - 1) / mTickInUs;
+    node->deadlineInTicks    = deadlineInTicks > mCurrentTick ? deadlineInTicks : mCurrentTick + 1;
+    Insert(node);
+}
+
+void TimerWheel::Cancel(TimerWheelNode *node) {
+    if (IsScheduled(node)) {
+        Unlink(node);
+        mCount--;
+    }
+}
+
+void TimerWheel::Advance(uint64_t nowInUs, std::vector<TimerWheelNode *> &outExpired) {
+    uint64_t nowInTicks = nowInUs / mTickInUs;
+    while (mCount > 0 && mCurrentTick < nowInTicks) {
+        mCurrentTick++;
+        // Cascade the higher levels first, their nodes might end up in a lower level that is cascaded in the same tick.
+        for (uint32_t level = LEVELS - 1; level > 0; level--) {
+            if ((mCurrentTick & ((1ULL << (level * SLOT_BITS)) - 1)) != 0) {
+                continue;
+            }
+            auto &head = mSlots[level][(mCurrentTick >> (level * SLOT_BITS)) & SLOT_MASK];
+            while (head.next != &head) {
+                auto *node = head.next;
+                Unlink(node);
+                Insert(node);
+            }
+        }
+        auto &head = mSlots[0][mCurrentTick & SLOT_MASK];
+        while (head.next != &head) {
+            auto *node = head.next;
+            Unlink(node);
+            mCount--;
+            outExpired.push_back(node);
+        }
+    }
+    if (mCurrentTick < nowInTicks) {
+        mCurrentTick = nowInTicks;
+    }
+}
+
+uint32_t TimerWheel::GetNextWakeupDelayInUs(uint64_t nowInUs) const {
+    // The next expiry in level 0 or the next cascade of a higher level, whichever comes first. Each slot of a level
+    // belongs to exactly one of the next SLOTS blocks of that level.
+    uint64_t wakeupTick = UINT64_MAX;
+    for (uint32_t level = 0; level < LEVELS; level++) {
+        uint32_t shift = level * SLOT_BITS;
+        uint64_t block = mCurrentTick >> shift;
+        if (((block + 1) << shift) >= wakeupTick) {
+            // Higher levels can't cascade earlier.
+            break;
+        }
+        for (uint64_t next = block + 1; next <= block + SLOTS; next++) {
+            const auto &head = mSlots[level][next & SLOT_MASK];
+            if (head.next != &head) {
+                wakeupTick = std::min(wakeupTick, next << shift);
+                break;
+            }
+        }
+    }
+    if (wakeupTick == UINT64_MAX) {
+        return 0xFFFFFFFF;
+    }
+    uint64_t wakeupInUs = wakeupTick * mTickInUs;
+    if (wakeupInUs <= nowInUs) {
+        return 0;
+    }
+    uint64_t delay = wakeupInUs - nowInUs;
+    return delay > 0xFFFFFFFF ? 0xFFFFFFFF : (uint32_t) delay;
+}
+
+void TimerWheel::Clear() {
+    for (auto &level : mSlots) {
+        for (auto &head : level) {
+            while (head.next != &head) {
+                Unlink(head.next);
+            }
+        }
+    }
+    mCount = 0;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Intrusive list node, embed it into the object that should expire.
+ */
+struct TimerWheelNode {
+    TimerWheelNode *prev     = nullptr;
+    TimerWheelNode *next     = nullptr;
+    uint64_t deadlineInTicks = 0;
+};
+
+/**
+ * Hierarchical timer wheel with 4 levels of 64 slots. Scheduling, rescheduling and cancelling a node is O(1),
+ * nodes are only touched again when their level is cascaded or they expire.
+ * Not thread safe, the owner has to provide locking.
+ */
+class TimerWheel {
+public:
+    explicit TimerWheel(uint32_t tickInUs);
+
+    TimerWheel(const TimerWheel &)            = delete;
+    TimerWheel &operator=(const TimerWheel &) = delete;
+
+    /**
+     * Schedules (or reschedules) a node. Deadlines in the past expire on the next tick.
+     */
+    void Schedule(TimerWheelNode *node, uint64_t deadlineInUs, uint64_t nowInUs);
+
+    void Cancel(TimerWheelNode *node);
+
+    static bool IsScheduled(const TimerWheelNode *node) {
+        return node->next != nullptr;
+    }
+
+    bool IsEmpty() const {
+        return mCount == 0;
+    }
+
+    /**
+     * Moves the wheel forward to `nowInUs` and appends all expired nodes to `outExpired`. Expired nodes are unscheduled.
+     */
+    void Advance(uint64_t nowInUs, std::vector<TimerWheelNode *> &outExpired);
+
+    /**
+     * Returns the delay until Advance has to be called again: the next deadline in level 0 or the next cascade of a
+     * level that has nodes, so a far deadline only needs one wakeup per level. 0xFFFFFFFF if the wheel is empty.
+     */
+    uint32_t GetNextWakeupDelayInUs(uint64_t nowInUs) const;
+
+    /**
+     * Unschedules all nodes.
+     */
+    void Clear();
+
+private:
+    static constexpr uint32_t LEVELS    = 4;
+    static constexpr uint32_t SLOT_BITS = 6;
+    static constexpr uint32_t SLOTS     = 1 << SLOT_BITS;
+    static constexpr uint32_t SLOT_MASK = SLOTS - 1;
+    static constexpr uint64_t MAX_DELTA = (1ULL << (LEVELS * SLOT_BITS)) - 1;
+
+    void Insert(TimerWheelNode *node);
+    static void Unlink(TimerWheelNode *node);
+
+    // Sentinels of circular lists.
+    TimerWheelNode mSlots[LEVELS][SLOTS];
+    uint64_t mCurrentTick = 0;
+    uint32_t mTickInUs;
+    uint32_t mCount = 0;
+};
@@ -1,12 +1,39 @@
+#include "animations.h"
+#include "deferred_notifications.h"
+#include "dispatcher.h"
+#include "groups.h"
+#include "handle_table.h"
+#include "intern_table.h"
 #include "internal.h"
+#include "keyed_notifications.h"
+#include "live_notifications.h"
 #include "logger.h"
-
+#include "progress_channels.h"
+#include "queue_estimate.h"
+#include "scheduled_notifications.h"
+#include "scheduler.h"
+#include "shared_ring.h"
+#include "static_callbacks.h"
+#include "stats.h"
+#include "templates.h"
+#include "text_sanitizer.h"
+#include "text_shadow.h"
+#include "watchdog.h"
+
+#include <algorithm>
+#include <cstring>
 #include <stdarg.h>
+#include <vector>
 
 #include <coreinit/debug.h>
 #include <coreinit/dynload.h>
 #include <notifications/notifications.h>
 
+// NotificationModule_GetThrottleDelay starts to delay once the overlay is half full, up to one second when it's full.
+#define THROTTLE_START_LOAD      0.5f
+#define THROTTLE_MAX_DELAY_IN_MS 1000
+#define THROTTLE_PENDING_LIMIT   8
+
 static OSDynLoad_Module sModuleHandle = nullptr;
 
 static NotificationModuleStatus (*sNMGetVersion)(NotificationModuleAPIVersion *) = nullptr;
@@ -59,18 +86,69 @@ static NotificationModuleStatus (*sNMFinishDynamicNotification)(NotificationModu
                                                                 float durationBeforeFadeOutInSeconds,
                                                                 float shakeDurationInSeconds) = nullptr;
 
-static bool sLibInitDone = false;
-
-#define MAX_NOTIFICATION_TYPES 3
+// The "Shared" exports receive texts that stay valid until the process exits, the module may reference them instead of copying.
+static NotificationModuleStatus (*sNMAddStaticNotificationShared)(const char *,
+                                                                  uint32_t,
+                                                                  NotificationModuleNotificationType,
+                                                                  float,
+                                                                  float,
+                                                                  NMColor,
+                                                                  NMColor,
+                                                                  void (*)(NotificationModuleHandle, void *),
+                                                                  void *,
+                                                                  bool) = nullptr;
+
+static NotificationModuleStatus (*sNMUpdateDynamicNotificationTextShared)(NotificationModuleHandle,
+                                                                          const char *,
+                                                                          uint32_t) = nullptr;
+
+static NotificationModuleStatus (*sNMUpdateDynamicNotification)(NotificationModuleHandle,
+                                                                const NMDynamicUpdate *,
+                                                                uint32_t) = nullptr;
+
+// Replaces `removedLength` bytes at `offset` of the current text with `insertedLength` bytes of `inserted`.
+static NotificationModuleStatus (*sNMSpliceDynamicNotificationText)(NotificationModuleHandle,
+                                                                    uint32_t,
+                                                                    uint32_t,
+                                                                    const char *,
+                                                                    uint32_t) = nullptr;
+
+static NotificationModuleStatus (*sNMFinishDynamicNotificationBatch)(const NotificationModuleHandle *,
+                                                                     uint32_t,
+                                                                     NotificationModuleStatusFinish,
+                                                                     float,
+                                                                     float) = nullptr;
+
+static NotificationModuleStatus (*sNMUpdateDynamicNotificationBatch)(const NotificationModuleHandle *,
+                                                                     uint32_t,
+                                                                     const NMDynamicUpdate *,
+                                                                     uint32_t) = nullptr;
+
+static NotificationModuleStatus (*sNMDetachDynamicNotificationCallbacks)(const NotificationModuleHandle *,
+                                                                         uint32_t) = nullptr;
+
+static NotificationModuleStatus (*sNMGetQueueInfo)(NMQueueInfo *) = nullptr;
+
+// Reads the fields of the description up to desc->size, new fields don't need a new export. outHandle is only written for dynamic notifications.
+static NotificationModuleStatus (*sNMAddNotification)(const NMNotificationDesc *,
+                                                      NotificationModuleHandle *) = nullptr;
 
-static_assert(NOTIFICATION_MODULE_NOTIFICATION_TYPE_INFO < MAX_NOTIFICATION_TYPES);
-static_assert(NOTIFICATION_MODULE_NOTIFICATION_TYPE_ERROR < MAX_NOTIFICATION_TYPES);
-static_assert(NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC < MAX_NOTIFICATION_TYPES);
+static bool sLibInitDone = false;
 
-static NMDefaultValueStore sDefaultValues[MAX_NOTIFICATION_TYPES];
+// Used by all functions that don't take a context, it has no limits.
+static _NMContext sDefaultContext;
 
 static NotificationModuleAPIVersion sNotificationModuleVersion = NOTIFICATION_MODULE_API_VERSION_ERROR;
 
+// Called after every call into the module.
+static void RecordModuleCall(NotificationModuleStatus res, uint64_t startInUs) {
+    uint64_t durationInUs = Scheduler_GetTimeInUs() - startInUs;
+    Stats_RecordCall(res, durationInUs);
+    if (Dispatcher_IsActive()) {
+        Dispatcher_ChargeTime(durationInUs);
+    }
+}
+
 const char *NotificationModule_GetStatusStr(NotificationModuleStatus status) {
     switch (status) {
         case NOTIFICATION_MODULE_RESULT_SUCCESS:
@@ -97,6 +175,8 @@ const char *NotificationModule_GetStatusStr(NotificationModuleStatus status) {
             return "NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED";
         case NOTIFICATION_MODULE_RESULT_INVALID_HANDLE:
             return "NOTIFICATION_MODULE_RESULT_INVALID_HANDLE";
+        case NOTIFICATION_MODULE_RESULT_QUOTA_EXCEEDED:
+            return "NOTIFICATION_MODULE_RESULT_QUOTA_EXCEEDED";
     }
     return "NOTIFICATION_MODULE_RESULT_UNKNOWN_ERROR";
 }
@@ -163,21 +243,164 @@ NotificationModuleStatus NotificationModule_InitLibrary() {
         sNMAddStaticNotificationV2 = nullptr;
     }
 
-    for (auto &sDefaultValue : sDefaultValues) {
+    if (OSDynLoad_FindExport(sModuleHandle, OS_DYNLOAD_EXPORT_FUNC, "NMAddStaticNotificationShared", (void **) &sNMAddStaticNotificationShared) != OS_DYNLOAD_OK) {
+        DEBUG_FUNCTION_LINE_WARN("FindExport NMAddStaticNotificationShared failed. Interned texts will be copied.");
+        sNMAddStaticNotificationShared = nullptr;
+    }
+    if (OSDynLoad_FindExport(sModuleHandle, OS_DYNLOAD_EXPORT_FUNC, "NMUpdateDynamicNotificationTextShared", (void **) &sNMUpdateDynamicNotificationTextShared) != OS_DYNLOAD_OK) {
+        DEBUG_FUNCTION_LINE_WARN("FindExport NMUpdateDynamicNotificationTextShared failed. Interned texts will be copied.");
+        sNMUpdateDynamicNotificationTextShared = nullptr;
+    }
+
+    if (OSDynLoad_FindExport(sModuleHandle, OS_DYNLOAD_EXPORT_FUNC, "NMUpdateDynamicNotification", (void **) &sNMUpdateDynamicNotification) != OS_DYNLOAD_OK) {
+        DEBUG_FUNCTION_LINE_WARN("FindExport NMUpdateDynamicNotification failed. Attributes will be updated one by one.");
+        sNMUpdateDynamicNotification = nullptr;
+    }
+    if (OSDynLoad_FindExport(sModuleHandle, OS_DYNLOAD_EXPORT_FUNC, "NMSpliceDynamicNotificationText", (void **) &sNMSpliceDynamicNotificationText) != OS_DYNLOAD_OK) {
+        DEBUG_FUNCTION_LINE_WARN("FindExport NMSpliceDynamicNotificationText failed. Texts will always be sent completely.");
+        sNMSpliceDynamicNotificationText = nullptr;
+    }
+
+    if (OSDynLoad_FindExport(sModuleHandle, OS_DYNLOAD_EXPORT_FUNC, "NMFinishDynamicNotificationBatch", (void **) &sNMFinishDynamicNotificationBatch) != OS_DYNLOAD_OK) {
+        DEBUG_FUNCTION_LINE_WARN("FindExport NMFinishDynamicNotificationBatch failed. Handles will be finished one by one.");
+        sNMFinishDynamicNotificationBatch = nullptr;
+    }
+    if (OSDynLoad_FindExport(sModuleHandle, OS_DYNLOAD_EXPORT_FUNC, "NMUpdateDynamicNotificationBatch", (void **) &sNMUpdateDynamicNotificationBatch) != OS_DYNLOAD_OK) {
+        DEBUG_FUNCTION_LINE_WARN("FindExport NMUpdateDynamicNotificationBatch failed. Handles will be updated one by one.");
+        sNMUpdateDynamicNotificationBatch = nullptr;
+    }
+    if (OSDynLoad_FindExport(sModuleHandle, OS_DYNLOAD_EXPORT_FUNC, "NMDetachDynamicNotificationCallbacks", (void **) &sNMDetachDynamicNotificationCallbacks) != OS_DYNLOAD_OK) {
+        DEBUG_FUNCTION_LINE_WARN("FindExport NMDetachDynamicNotificationCallbacks failed. Finish callbacks can't be disabled on deinit.");
+        sNMDetachDynamicNotificationCallbacks = nullptr;
+    }
+    if (OSDynLoad_FindExport(sModuleHandle, OS_DYNLOAD_EXPORT_FUNC, "NMGetQueueInfo", (void **) &sNMGetQueueInfo) != OS_DYNLOAD_OK) {
+        DEBUG_FUNCTION_LINE_WARN("FindExport NMGetQueueInfo failed. The queue info will be estimated.");
+        sNMGetQueueInfo = nullptr;
+    }
+    if (OSDynLoad_FindExport(sModuleHandle, OS_DYNLOAD_EXPORT_FUNC, "NMAddNotification", (void **) &sNMAddNotification) != OS_DYNLOAD_OK) {
+        DEBUG_FUNCTION_LINE_WARN("FindExport NMAddNotification failed. Notifications will be added with the scalar exports.");
+        sNMAddNotification = nullptr;
+    }
+
+    SharedRingAttachFunc attachSharedRing   = nullptr;
+    SharedRingProcessFunc processSharedRing = nullptr;
+    SharedRingDetachFunc detachSharedRing   = nullptr;
+    if (OSDynLoad_FindExport(sModuleHandle, OS_DYNLOAD_EXPORT_FUNC, "NMAttachSharedRing", (void **) &attachSharedRing) == OS_DYNLOAD_OK &&
+        OSDynLoad_FindExport(sModuleHandle, OS_DYNLOAD_EXPORT_FUNC, "NMProcessSharedRing", (void **) &processSharedRing) == OS_DYNLOAD_OK &&
+        OSDynLoad_FindExport(sModuleHandle, OS_DYNLOAD_EXPORT_FUNC, "NMDetachSharedRing", (void **) &detachSharedRing) == OS_DYNLOAD_OK) {
+        SharedRing_Attach(attachSharedRing, processSharedRing, detachSharedRing);
+    } else {
+        DEBUG_FUNCTION_LINE_WARN("FindExport NMAttachSharedRing failed. Updates will be sent with the exported functions.");
+    }
+
+    for (auto &sDefaultValue : sDefaultContext.defaultValues) {
         sDefaultValue = NMDefaultValueStore(); // Reset to defaults
     }
 
     // Set specific default for Error
     if constexpr (NOTIFICATION_MODULE_NOTIFICATION_TYPE_ERROR < MAX_NOTIFICATION_TYPES) {
-        sDefaultValues[NOTIFICATION_MODULE_NOTIFICATION_TYPE_ERROR].backgroundColor = {237, 28, 36, 255};
+        sDefaultContext.defaultValues[NOTIFICATION_MODULE_NOTIFICATION_TYPE_ERROR].backgroundColor = {237, 28, 36, 255};
     }
 
     sLibInitDone = true;
     return NOTIFICATION_MODULE_RESULT_SUCCESS;
 }
 
+bool NotificationModule_IsLibInitialized() {
+    return sNotificationModuleVersion != NOTIFICATION_MODULE_API_VERSION_ERROR;
+}
+
+NMDefaultValueStore NotificationModule_GetDefaultValues(NotificationModuleNotificationType type) {
+    if (type < 0 || type >= MAX_NOTIFICATION_TYPES) {
+        return {};
+    }
+    return sDefaultContext.defaultValues[type];
+}
+
+/**
+ * Finishes all dynamic notifications that are still open and makes sure the module won't call back into this library anymore.
+ */
+static void FinishOpenDynamicNotifications() {
+    std::vector<NotificationModuleHandle> liveModuleHandles;
+    std::vector<NotificationModuleHandle> pendingModuleHandles;
+    HandleTable_Reset(liveModuleHandles, pendingModuleHandles);
+    if (pendingModuleHandles.empty()) {
+        return;
+    }
+
+    auto startInUs = Scheduler_GetTimeInUs();
+    // Detach first, the callbacks must not fire while (or after) this library is unloaded.
+    if (sNMDetachDynamicNotificationCallbacks != nullptr) {
+        sNMDetachDynamicNotificationCallbacks(pendingModuleHandles.data(), pendingModuleHandles.size());
+    }
+    if (!liveModuleHandles.empty()) {
+        if (sNMFinishDynamicNotificationBatch != nullptr) {
+            sNMFinishDynamicNotificationBatch(liveModuleHandles.data(), liveModuleHandles.size(), NOTIFICATION_MODULE_STATUS_FINISH, 0.0f, 0.0f);
+        } else if (sNMFinishDynamicNotification != nullptr) {
+            for (auto moduleHandle : liveModuleHandles) {
+                sNMFinishDynamicNotification(moduleHandle, NOTIFICATION_MODULE_STATUS_FINISH, 0.0f, 0.0f);
+            }
+        }
+    }
+    DEBUG_FUNCTION_LINE_WARN("Finished %d open dynamic notifications (%d pending callbacks) in %d us",
+                             (int) liveModuleHandles.size(),
+                             (int) pendingModuleHandles.size(),
+                             (int) (Scheduler_GetTimeInUs() - startInUs));
+}
+
+NotificationModuleStatus NotificationModule_InitNotificationDesc(NotificationModuleNotificationType type, NMNotificationDesc *outDesc) {
+    if (outDesc == nullptr || type < 0 || type >= MAX_NOTIFICATION_TYPES) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    auto &cur                               = sDefaultContext.defaultValues[type];
+    *outDesc                                = {};
+    outDesc->size                           = sizeof(NMNotificationDesc);
+    outDesc->type                           = type;
+    outDesc->durationBeforeFadeOutInSeconds = cur.durationBeforeFadeOutInSeconds;
+    outDesc->shakeDurationInSeconds         = type == NOTIFICATION_MODULE_NOTIFICATION_TYPE_ERROR ? cur.shakeDurationOnErrorInSeconds : 0.0f;
+    outDesc->textColor                      = cur.textColor;
+    outDesc->backgroundColor                = cur.backgroundColor;
+    outDesc->callback                       = cur.finishFunc;
+    outDesc->callbackContext                = cur.finishFuncContext;
+    outDesc->keepUntilShown                 = cur.keepUntilShown;
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+bool NotificationModule_NormalizeNotificationDesc(const NMNotificationDesc *desc, NMNotificationDesc &outDesc) {
+    if (desc == nullptr || desc->size < NM_NOTIFICATION_DESC_SIZE_V1) {
+        return false;
+    }
+    if (desc->size >= sizeof(NMNotificationDesc)) {
+        outDesc = *desc;
+    } else {
+        // Built against an older header, the remaining fields keep the defaults.
+        if (NotificationModule_InitNotificationDesc(desc->type, &outDesc) != NOTIFICATION_MODULE_RESULT_SUCCESS) {
+            outDesc = {};
+        }
+        memcpy(&outDesc, desc, desc->size);
+    }
+    outDesc.size = sizeof(NMNotificationDesc);
+    return true;
+}
+
 NotificationModuleStatus NotificationModule_DeInitLibrary() {
     if (sLibInitDone) {
+        Animations_Reset();
+        Watchdog_Reset();
+        ScheduledNotifications_Reset();
+        Groups_Reset();
+        KeyedNotifications_Reset();
+        DeferredNotifications_Flush();
+        Scheduler_Shutdown();
+        LiveNotifications_Reset();
+        ProgressChannels_Reset();
+        Dispatcher_Reset();
+        SharedRing_Detach();
+        FinishOpenDynamicNotifications();
+        StaticCallbacks_Reset();
+        TextShadow_Reset();
+        QueueEstimate_Reset();
+        Stats_Reset();
         sNMGetVersion              = nullptr;
         sNotificationModuleVersion = NOTIFICATION_MODULE_API_VERSION_ERROR;
         OSDynLoad_Release(sModuleHandle);
@@ -218,48 +441,142 @@ NotificationModuleStatus NotificationModule_IsOverlayReady(bool *outIsReady) {
     return sNMIsOverlayReady(outIsReady);
 }
 
-NotificationModuleStatus NotificationModule_AddDynamicNotificationEx(const char *text,
-                                                                     NotificationModuleHandle *outHandle,
-                                                                     NMColor textColor,
-                                                                     NMColor backgroundColor,
-                                                                     void (*finishFunc)(NotificationModuleHandle, void *context),
-                                                                     void *context,
-                                                                     bool keepUntilShown) {
-    if (sNotificationModuleVersion == NOTIFICATION_MODULE_API_VERSION_ERROR) {
-        return NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED;
+// Returns NOTIFICATION_MODULE_RESULT_SUCCESS if the loaded module can add notifications of this type.
+static NotificationModuleStatus CheckAddSupported(NotificationModuleNotificationType type) {
+    if (sNMAddNotification != nullptr) {
+        return NOTIFICATION_MODULE_RESULT_SUCCESS;
+    }
+    if (sNotificationModuleVersion < 1) {
+        return NOTIFICATION_MODULE_RESULT_UNSUPPORTED_COMMAND;
     }
-    if (sNMAddDynamicNotification == nullptr || sNotificationModuleVersion < 1) {
+    if (type == NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC) {
+        if (sNMAddDynamicNotification == nullptr || (sNotificationModuleVersion == 2 && sNMAddDynamicNotificationV2 == nullptr)) {
+            return NOTIFICATION_MODULE_RESULT_UNSUPPORTED_COMMAND;
+        }
+    } else if (sNMAddStaticNotification == nullptr || (sNotificationModuleVersion == 2 && sNMAddStaticNotificationV2 == nullptr)) {
         return NOTIFICATION_MODULE_RESULT_UNSUPPORTED_COMMAND;
     }
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+// Creates the notification of a reserved handle. The handle stays reserved if that fails.
+// `desc` has to be sanitized already, its callback is replaced by the one of the handle table.
+static NotificationModuleStatus CallAddDynamicNotification(NotificationModuleHandle handle, const NMNotificationDesc &desc) {
+    NotificationModuleStatus res;
+    NotificationModuleHandle moduleHandle = 0;
+    uint64_t startInUs                    = Scheduler_GetTimeInUs();
+    if (sNMAddNotification != nullptr) {
+        NMNotificationDesc moduleDesc = desc;
+        moduleDesc.size               = sizeof(NMNotificationDesc);
+        moduleDesc.callback           = HandleTable_FinishedCallback;
+        moduleDesc.callbackContext    = (void *) (uintptr_t) handle;
+        res                           = sNMAddNotification(&moduleDesc, &moduleHandle);
+    } else if (sNotificationModuleVersion == 2) {
+        res = sNMAddDynamicNotificationV2(desc.text,
+                                          desc.textColor,
+                                          desc.backgroundColor,
+                                          HandleTable_FinishedCallback,
+                                          (void *) (uintptr_t) handle,
+                                          desc.keepUntilShown,
+                                          &moduleHandle);
+    } else {
+        res = sNMAddDynamicNotification(desc.text,
+                                        desc.textColor,
+                                        desc.backgroundColor,
+                                        HandleTable_FinishedCallback,
+                                        (void *) (uintptr_t) handle,
+                                        &moduleHandle);
+    }
+    RecordModuleCall(res, startInUs);
+    if (res != NOTIFICATION_MODULE_RESULT_SUCCESS) {
+        return res;
+    }
+    HandleTable_Activate(handle, moduleHandle);
+    TextShadow_Track(handle, desc.text);
+    return res;
+}
+
+// `defaults` is the store of the context the notification is added in, its inactivity timeout values are used.
+static NotificationModuleStatus AddDynamicNotification(const NMNotificationDesc &desc, const NMDefaultValueStore &defaults, NotificationModuleHandle *outHandle) {
+    auto res = CheckAddSupported(NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC);
+    if (res != NOTIFICATION_MODULE_RESULT_SUCCESS) {
+        return res;
+    }
 
-    if (text == nullptr || outHandle == nullptr) {
+    if (desc.text == nullptr || outHandle == nullptr) {
         return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
     }
 
-    if (sNotificationModuleVersion == 2) {
-        if (sNMAddDynamicNotificationV2 == nullptr) {
-            return NOTIFICATION_MODULE_RESULT_UNSUPPORTED_COMMAND;
+    SanitizedText sanitizedText(desc.text);
+    if (sanitizedText.c_str() == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED;
+    }
+
+    // The module calls HandleTable_FinishedCallback which releases the slot and forwards to the callback of the description.
+    NotificationModuleHandle handle = HandleTable_Reserve(desc.callback, desc.callbackContext);
+    if (handle == 0) {
+        return NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED;
+    }
+
+    DispatcherOp op;
+    op.type            = DISPATCHER_OP_TYPE_ADD_DYNAMIC;
+    op.handle          = handle;
+    op.textColor       = desc.textColor;
+    op.backgroundColor = desc.backgroundColor;
+    op.keepUntilShown  = desc.keepUntilShown;
+    if (Dispatcher_IsActive()) {
+        op.text = sanitizedText.c_str();
+        if (Dispatcher_TryQueue(op, true, &res)) {
+            if (res != NOTIFICATION_MODULE_RESULT_SUCCESS) {
+                HandleTable_Release(handle);
+                return res;
+            }
+            // The handle can be used right away, its operations are queued until the notification has been created.
+            Watchdog_Track(handle, defaults.inactivityTimeoutInSeconds, defaults);
+            *outHandle = handle;
+            return res;
         }
-        return sNMAddDynamicNotificationV2(text,
-                                           textColor,
-                                           backgroundColor,
-                                           finishFunc,
-                                           context,
-                                           keepUntilShown,
-                                           outHandle);
     }
 
-    return sNMAddDynamicNotification(text,
-                                     textColor,
-                                     backgroundColor,
-                                     finishFunc,
-                                     context,
-                                     outHandle);
+    NMNotificationDesc sanitizedDesc = desc;
+    sanitizedDesc.text               = sanitizedText.c_str();
+    res                              = CallAddDynamicNotification(handle, sanitizedDesc);
+    if (res != NOTIFICATION_MODULE_RESULT_SUCCESS) {
+        op.text = sanitizedText.c_str();
+        if (!Dispatcher_QueueRetry(op, res)) {
+            HandleTable_Release(handle);
+            return res;
+        }
+        res = NOTIFICATION_MODULE_RESULT_SUCCESS;
+    }
+    // Before the handle is returned, so a timeout the application sets right away isn't overridden.
+    Watchdog_Track(handle, defaults.inactivityTimeoutInSeconds, defaults);
+    *outHandle = handle;
+    return res;
+}
+
+NotificationModuleStatus NotificationModule_AddDynamicNotificationEx(const char *text,
+                                                                     NotificationModuleHandle *outHandle,
+                                                                     NMColor textColor,
+                                                                     NMColor backgroundColor,
+                                                                     void (*finishFunc)(NotificationModuleHandle, void *context),
+                                                                     void *context,
+                                                                     bool keepUntilShown) {
+    NMNotificationDesc desc = {};
+    desc.size               = sizeof(NMNotificationDesc);
+    desc.type               = NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC;
+    desc.text               = text;
+    desc.textColor          = textColor;
+    desc.backgroundColor    = backgroundColor;
+    desc.callback           = finishFunc;
+    desc.callbackContext    = context;
+    desc.keepUntilShown     = keepUntilShown;
+    return NotificationModule_AddNotification(&desc, outHandle);
 }
 
 NotificationModuleStatus NotificationModule_AddDynamicNotification(const char *text, NotificationModuleHandle *outHandle) {
     static_assert(NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC < MAX_NOTIFICATION_TYPES);
-    auto &cur = sDefaultValues[NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC];
+    auto &cur = sDefaultContext.defaultValues[NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC];
     return NotificationModule_AddDynamicNotificationEx(text,
                                                        outHandle,
                                                        cur.textColor,
@@ -274,7 +591,7 @@ NotificationModuleStatus NotificationModule_AddDynamicNotificationWithCallback(c
                                                                                NotificationModuleNotificationFinishedCallback callback,
                                                                                void *callbackContext) {
     static_assert(NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC < MAX_NOTIFICATION_TYPES);
-    auto &cur = sDefaultValues[NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC];
+    auto &cur = sDefaultContext.defaultValues[NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC];
     return NotificationModule_AddDynamicNotificationEx(text,
                                                        outHandle,
                                                        cur.textColor,
@@ -284,66 +601,130 @@ NotificationModuleStatus NotificationModule_AddDynamicNotificationWithCallback(c
                                                        cur.keepUntilShown);
 }
 
-static NotificationModuleStatus NotificationModule_AddStaticNotification(const char *text,
-                                                                         NotificationModuleNotificationType type,
-                                                                         float durationBeforeFadeOutInSeconds,
-                                                                         float shakeDurationInSeconds,
-                                                                         NMColor textColor,
-                                                                         NMColor backgroundColor,
-                                                                         NotificationModuleNotificationFinishedCallback callback,
-                                                                         void *callbackContext,
-                                                                         bool keepUntilShown) {
-    if (sNotificationModuleVersion == NOTIFICATION_MODULE_API_VERSION_ERROR) {
-        return NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED;
+// `desc` has to be sanitized already.
+static NotificationModuleStatus CallAddStaticNotification(const NMNotificationDesc &desc) {
+    // The module calls the trampoline, which can be turned off on NotificationModule_DeInitLibrary.
+    auto callback        = desc.callback;
+    auto callbackContext = desc.callbackContext;
+    StaticCallbacks_Wrap(callback, callbackContext);
+
+    NotificationModuleStatus res;
+    uint64_t startInUs = Scheduler_GetTimeInUs();
+    if (sNMAddNotification != nullptr) {
+        NMNotificationDesc moduleDesc = desc;
+        moduleDesc.size               = sizeof(NMNotificationDesc);
+        moduleDesc.callback           = callback;
+        moduleDesc.callbackContext    = callbackContext;
+        res                           = sNMAddNotification(&moduleDesc, nullptr);
+    } else if (sNotificationModuleVersion == 2) {
+        res = sNMAddStaticNotificationV2(desc.text,
+                                         desc.type,
+                                         desc.durationBeforeFadeOutInSeconds,
+                                         desc.shakeDurationInSeconds,
+                                         desc.textColor,
+                                         desc.backgroundColor,
+                                         callback,
+                                         callbackContext,
+                                         desc.keepUntilShown);
+    } else {
+        res = sNMAddStaticNotification(desc.text,
+                                       desc.type,
+                                       desc.durationBeforeFadeOutInSeconds,
+                                       desc.shakeDurationInSeconds,
+                                       desc.textColor,
+                                       desc.backgroundColor,
+                                       callback,
+                                       callbackContext);
     }
-    if (sNMAddStaticNotification == nullptr || sNotificationModuleVersion < 1) {
-        return NOTIFICATION_MODULE_RESULT_UNSUPPORTED_COMMAND;
+    RecordModuleCall(res, startInUs);
+    if (res != NOTIFICATION_MODULE_RESULT_SUCCESS) {
+        StaticCallbacks_Release(callback, callbackContext);
+    } else if (sNMGetQueueInfo == nullptr) {
+        QueueEstimate_OnStaticAdded(strlen(desc.text), desc.durationBeforeFadeOutInSeconds, desc.shakeDurationInSeconds);
+    }
+    return res;
+}
+
+// Everything but the text, which has to be sanitized first.
+static void InitStaticAddOp(const NMNotificationDesc &desc, DispatcherOp &op) {
+    op.type                           = DISPATCHER_OP_TYPE_ADD_STATIC;
+    op.notificationType               = desc.type;
+    op.durationBeforeFadeOutInSeconds = desc.durationBeforeFadeOutInSeconds;
+    op.shakeDurationInSeconds         = desc.shakeDurationInSeconds;
+    op.textColor                      = desc.textColor;
+    op.backgroundColor                = desc.backgroundColor;
+    op.callback                       = desc.callback;
+    op.callbackContext                = desc.callbackContext;
+    op.keepUntilShown                 = desc.keepUntilShown;
+}
+
+static NotificationModuleStatus AddStaticNotification(const NMNotificationDesc &desc) {
+    auto res = CheckAddSupported(desc.type);
+    if (res != NOTIFICATION_MODULE_RESULT_SUCCESS) {
+        return res;
     }
 
-    if (text == nullptr) {
+    if (desc.text == nullptr) {
         return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
     }
 
-    if (sNotificationModuleVersion == 2) {
-        if (sNMAddStaticNotificationV2 == nullptr) {
-            return NOTIFICATION_MODULE_RESULT_UNSUPPORTED_COMMAND;
+    SanitizedText sanitizedText(desc.text);
+    if (sanitizedText.c_str() == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED;
+    }
+
+    DispatcherOp op;
+    InitStaticAddOp(desc, op);
+    if (Dispatcher_IsActive()) {
+        op.text = sanitizedText.c_str();
+        if (Dispatcher_TryQueue(op, true, &res)) {
+            return res;
+        }
+    }
+
+    NMNotificationDesc sanitizedDesc = desc;
+    sanitizedDesc.text               = sanitizedText.c_str();
+    res                              = CallAddStaticNotification(sanitizedDesc);
+    if (res != NOTIFICATION_MODULE_RESULT_SUCCESS) {
+        // Transient errors are retried in the background if a retry policy has been set.
+        op.text = sanitizedText.c_str();
+        if (Dispatcher_QueueRetry(op, res)) {
+            res = NOTIFICATION_MODULE_RESULT_SUCCESS;
         }
-        return sNMAddStaticNotificationV2(text,
-                                          type,
-                                          durationBeforeFadeOutInSeconds,
-                                          shakeDurationInSeconds,
-                                          textColor,
-                                          backgroundColor,
-                                          callback,
-                                          callbackContext,
-                                          keepUntilShown);
-    }
-    return sNMAddStaticNotification(text,
-                                    type,
-                                    durationBeforeFadeOutInSeconds,
-                                    shakeDurationInSeconds,
-                                    textColor,
-                                    backgroundColor,
-                                    callback,
-                                    callbackContext);
+    }
+    return res;
 }
 
-#undef NotificationModule_SetDefaultValue
-NotificationModuleStatus NotificationModule_SetDefaultValue(NotificationModuleNotificationType type,
-                                                            NotificationModuleNotificationOption valueType,
-                                                            ...) {
-    if (sModuleHandle == nullptr) {
+NotificationModuleStatus NotificationModule_AddNotification(const NMNotificationDesc *desc, NotificationModuleHandle *outHandle) {
+    if (sNotificationModuleVersion == NOTIFICATION_MODULE_API_VERSION_ERROR) {
         return NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED;
     }
-
-    if (type < 0 || type >= MAX_NOTIFICATION_TYPES) {
+    NMNotificationDesc normalizedDesc;
+    if (!NotificationModule_NormalizeNotificationDesc(desc, normalizedDesc)) {
         return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
     }
+    switch (normalizedDesc.type) {
+        case NOTIFICATION_MODULE_NOTIFICATION_TYPE_INFO:
+        case NOTIFICATION_MODULE_NOTIFICATION_TYPE_ERROR:
+            return AddStaticNotification(normalizedDesc);
+        case NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC:
+            static_assert(NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC < MAX_NOTIFICATION_TYPES);
+            return AddDynamicNotification(normalizedDesc, sDefaultContext.defaultValues[NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC], outHandle);
+    }
+    return NOTIFICATION_MODULE_RESULT_UNSUPPORTED_TYPE;
+}
 
-    va_list va;
+NotificationModuleStatus NotificationModule_AddDynamicNotificationWithDefaults(const NMNotificationDesc &desc,
+                                                                               const NMDefaultValueStore &defaults,
+                                                                               NotificationModuleHandle *outHandle) {
+    if (sNotificationModuleVersion == NOTIFICATION_MODULE_API_VERSION_ERROR) {
+        return NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED;
+    }
+    return AddDynamicNotification(desc, defaults, outHandle);
+}
 
-    auto &cur = sDefaultValues[type];
-    va_start(va, valueType);
+#undef NotificationModule_SetDefaultValue
+NotificationModuleStatus NotificationModule_SetDefaultValueV(NMDefaultValueStore &cur, NotificationModuleNotificationOption valueType, va_list va) {
     auto res = NOTIFICATION_MODULE_RESULT_SUCCESS;
     switch (valueType) {
         case NOTIFICATION_MODULE_DEFAULT_OPTION_BACKGROUND_COLOR: {
@@ -376,11 +757,44 @@ NotificationModuleStatus NotificationModule_SetDefaultValue(NotificationModuleNo
             cur.keepUntilShown = (bool) arg;
             break;
         }
+        case NOTIFICATION_MODULE_DEFAULT_OPTION_INACTIVITY_TIMEOUT: {
+            auto arg                       = va_arg(va, double);
+            cur.inactivityTimeoutInSeconds = arg > 0.0 ? (float) arg : 0.0f;
+            break;
+        }
+        case NOTIFICATION_MODULE_DEFAULT_OPTION_INACTIVITY_TIMEOUT_TEXT: {
+            // Interned, so the text stays valid no matter what the caller does with its copy.
+            NotificationModuleTextId textId = NOTIFICATION_MODULE_TEXT_ID_INVALID;
+            auto arg                        = va_arg(va, const char *);
+            if (arg != nullptr) {
+                res = NotificationModule_InternText(arg, &textId);
+            }
+            if (res == NOTIFICATION_MODULE_RESULT_SUCCESS) {
+                cur.inactivityTimeoutTextId = textId;
+            }
+            break;
+        }
         default:
             res = NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
             break;
     }
+    return res;
+}
 
+NotificationModuleStatus NotificationModule_SetDefaultValue(NotificationModuleNotificationType type,
+                                                            NotificationModuleNotificationOption valueType,
+                                                            ...) {
+    if (sModuleHandle == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED;
+    }
+
+    if (type < 0 || type >= MAX_NOTIFICATION_TYPES) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+
+    va_list va;
+    va_start(va, valueType);
+    auto res = NotificationModule_SetDefaultValueV(sDefaultContext.defaultValues[type], valueType, va);
     va_end(va);
 
     return res;
@@ -393,20 +807,22 @@ NotificationModuleStatus NotificationModule_AddInfoNotificationEx(const char *te
                                                                   NotificationModuleNotificationFinishedCallback callback,
                                                                   void *callbackContext,
                                                                   bool keepUntilShown) {
-    return NotificationModule_AddStaticNotification(text,
-                                                    NOTIFICATION_MODULE_NOTIFICATION_TYPE_INFO,
-                                                    durationBeforeFadeOutInSeconds,
-                                                    0.0f,
-                                                    textColor,
-                                                    backgroundColor,
-                                                    callback,
-                                                    callbackContext,
-                                                    keepUntilShown);
+    NMNotificationDesc desc             = {};
+    desc.size                           = sizeof(NMNotificationDesc);
+    desc.type                           = NOTIFICATION_MODULE_NOTIFICATION_TYPE_INFO;
+    desc.text                           = text;
+    desc.durationBeforeFadeOutInSeconds = durationBeforeFadeOutInSeconds;
+    desc.textColor                      = textColor;
+    desc.backgroundColor                = backgroundColor;
+    desc.callback                       = callback;
+    desc.callbackContext                = callbackContext;
+    desc.keepUntilShown                 = keepUntilShown;
+    return NotificationModule_AddNotification(&desc, nullptr);
 }
 
 NotificationModuleStatus NotificationModule_AddInfoNotification(const char *text) {
     static_assert(NOTIFICATION_MODULE_NOTIFICATION_TYPE_INFO < MAX_NOTIFICATION_TYPES);
-    auto &cur = sDefaultValues[NOTIFICATION_MODULE_NOTIFICATION_TYPE_INFO];
+    auto &cur = sDefaultContext.defaultValues[NOTIFICATION_MODULE_NOTIFICATION_TYPE_INFO];
     return NotificationModule_AddInfoNotificationEx(text,
                                                     cur.durationBeforeFadeOutInSeconds,
                                                     cur.textColor,
@@ -419,7 +835,7 @@ NotificationModuleStatus NotificationModule_AddInfoNotificationWithCallback(cons
                                                                             NotificationModuleNotificationFinishedCallback callback,
                                                                             void *callbackContext) {
     static_assert(NOTIFICATION_MODULE_NOTIFICATION_TYPE_INFO < MAX_NOTIFICATION_TYPES);
-    auto &cur = sDefaultValues[NOTIFICATION_MODULE_NOTIFICATION_TYPE_INFO];
+    auto &cur = sDefaultContext.defaultValues[NOTIFICATION_MODULE_NOTIFICATION_TYPE_INFO];
     return NotificationModule_AddInfoNotificationEx(text,
                                                     cur.durationBeforeFadeOutInSeconds,
                                                     cur.textColor,
@@ -437,15 +853,18 @@ NotificationModuleStatus NotificationModule_AddErrorNotificationEx(const char *t
                                                                    NotificationModuleNotificationFinishedCallback callback,
                                                                    void *callbackContext,
                                                                    bool keepUntilShown) {
-    return NotificationModule_AddStaticNotification(text,
-                                                    NOTIFICATION_MODULE_NOTIFICATION_TYPE_ERROR,
-                                                    durationBeforeFadeOutInSeconds,
-                                                    shakeDurationInSeconds,
-                                                    textColor,
-                                                    backgroundColor,
-                                                    callback,
-                                                    callbackContext,
-                                                    keepUntilShown);
+    NMNotificationDesc desc             = {};
+    desc.size                           = sizeof(NMNotificationDesc);
+    desc.type                           = NOTIFICATION_MODULE_NOTIFICATION_TYPE_ERROR;
+    desc.text                           = text;
+    desc.durationBeforeFadeOutInSeconds = durationBeforeFadeOutInSeconds;
+    desc.shakeDurationInSeconds         = shakeDurationInSeconds;
+    desc.textColor                      = textColor;
+    desc.backgroundColor                = backgroundColor;
+    desc.callback                       = callback;
+    desc.callbackContext                = callbackContext;
+    desc.keepUntilShown                 = keepUntilShown;
+    return NotificationModule_AddNotification(&desc, nullptr);
 }
 
 NotificationModuleStatus NotificationModule_AddErrorNotification(const char *text) {
@@ -454,7 +873,7 @@ NotificationModuleStatus NotificationModule_AddErrorNotification(const char *tex
     }
 
     static_assert(NOTIFICATION_MODULE_NOTIFICATION_TYPE_ERROR < MAX_NOTIFICATION_TYPES);
-    auto &cur = sDefaultValues[NOTIFICATION_MODULE_NOTIFICATION_TYPE_ERROR];
+    auto &cur = sDefaultContext.defaultValues[NOTIFICATION_MODULE_NOTIFICATION_TYPE_ERROR];
     return NotificationModule_AddErrorNotificationEx(text,
                                                      cur.durationBeforeFadeOutInSeconds,
                                                      cur.shakeDurationOnErrorInSeconds,
@@ -473,7 +892,7 @@ NotificationModuleStatus NotificationModule_AddErrorNotificationWithCallback(con
     }
 
     static_assert(NOTIFICATION_MODULE_NOTIFICATION_TYPE_ERROR < MAX_NOTIFICATION_TYPES);
-    auto &cur = sDefaultValues[NOTIFICATION_MODULE_NOTIFICATION_TYPE_ERROR];
+    auto &cur = sDefaultContext.defaultValues[NOTIFICATION_MODULE_NOTIFICATION_TYPE_ERROR];
     return NotificationModule_AddErrorNotificationEx(text,
                                                      cur.durationBeforeFadeOutInSeconds,
                                                      cur.shakeDurationOnErrorInSeconds,
@@ -484,6 +903,78 @@ NotificationModuleStatus NotificationModule_AddErrorNotificationWithCallback(con
                                                      cur.keepUntilShown);
 }
 
+// Queues an update if the frame budget is used up or the handle has queued operations, see Dispatcher_TryQueue.
+// `update` has to be sanitized already. Returns true if `outRes` has been set and the update must not be sent to the module.
+static bool QueueUpdate(NotificationModuleHandle handle, bool handleIsValid, const NMDynamicUpdate &update, uint32_t fieldMask, NotificationModuleStatus *outRes) {
+    if (!Dispatcher_IsActive()) {
+        return false;
+    }
+    DispatcherOp op;
+    op.type            = DISPATCHER_OP_TYPE_UPDATE;
+    op.handle          = handle;
+    op.textColor       = update.textColor;
+    op.backgroundColor = update.backgroundColor;
+    op.fieldMask       = fieldMask;
+    if (fieldMask & NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_TEXT) {
+        op.text = update.text;
+    }
+    return Dispatcher_TryQueue(op, handleIsValid, outRes);
+}
+
+// Writes the update into the shared ring or sends it with a single call if the module supports it,
+// otherwise every field is updated on its own. Texts that didn't change are skipped, text only updates are sent
+// as a splice if the module supports it.
+static NotificationModuleStatus CallUpdateDynamicNotification(NotificationModuleHandle handle,
+                                                              NotificationModuleHandle moduleHandle,
+                                                              const NMDynamicUpdate &update,
+                                                              uint32_t fieldMask) {
+    TextShadowUpdate shadow(handle, (fieldMask & NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_TEXT) ? update.text : nullptr);
+    if ((fieldMask & NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_TEXT) && shadow.IsUnchanged()) {
+        fieldMask &= ~NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_TEXT;
+        if (fieldMask == 0) {
+            Stats_RecordCoalesced();
+            Watchdog_Touch(handle);
+            return NOTIFICATION_MODULE_RESULT_SUCCESS;
+        }
+    }
+
+    auto res           = NOTIFICATION_MODULE_RESULT_SUCCESS;
+    uint64_t startInUs = Scheduler_GetTimeInUs();
+    TextSplice splice;
+    if (SharedRing_PushUpdate(moduleHandle, update, fieldMask, false)) {
+        RecordModuleCall(res, startInUs);
+    } else if (fieldMask == NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_TEXT && sNMSpliceDynamicNotificationText != nullptr && shadow.GetSplice(&splice)) {
+        res = sNMSpliceDynamicNotificationText(moduleHandle, splice.offset, splice.removedLength, splice.inserted, splice.insertedLength);
+        RecordModuleCall(res, startInUs);
+    } else if (sNMUpdateDynamicNotification != nullptr) {
+        res = sNMUpdateDynamicNotification(moduleHandle, &update, fieldMask);
+        RecordModuleCall(res, startInUs);
+    } else {
+        if (fieldMask & NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_BACKGROUND_COLOR) {
+            startInUs = Scheduler_GetTimeInUs();
+            res       = sNMUpdateDynamicNotificationBackgroundColor(moduleHandle, update.backgroundColor);
+            RecordModuleCall(res, startInUs);
+        }
+        if (res == NOTIFICATION_MODULE_RESULT_SUCCESS && (fieldMask & NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_TEXT_COLOR)) {
+            startInUs = Scheduler_GetTimeInUs();
+            res       = sNMUpdateDynamicNotificationTextColor(moduleHandle, update.textColor);
+            RecordModuleCall(res, startInUs);
+        }
+        if (res == NOTIFICATION_MODULE_RESULT_SUCCESS && (fieldMask & NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_TEXT)) {
+            startInUs = Scheduler_GetTimeInUs();
+            res       = sNMUpdateDynamicNotificationText(moduleHandle, update.text);
+            RecordModuleCall(res, startInUs);
+        }
+    }
+    if (fieldMask & NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_TEXT) {
+        shadow.Commit(res == NOTIFICATION_MODULE_RESULT_SUCCESS);
+    }
+    if (res == NOTIFICATION_MODULE_RESULT_SUCCESS) {
+        Watchdog_Touch(handle);
+    }
+    return res;
+}
+
 NotificationModuleStatus NotificationModule_UpdateDynamicNotificationText(NotificationModuleHandle handle,
                                                                           const char *text) {
     if (sNotificationModuleVersion == NOTIFICATION_MODULE_API_VERSION_ERROR) {
@@ -496,9 +987,24 @@ NotificationModuleStatus NotificationModule_UpdateDynamicNotificationText(Notifi
     if (handle == 0 || text == nullptr) {
         return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
     }
+    NotificationModuleHandle moduleHandle;
+    bool handleIsValid = HandleTable_Resolve(handle, &moduleHandle);
+
+    SanitizedText sanitizedText(text);
+    if (sanitizedText.c_str() == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED;
+    }
+
+    NotificationModuleStatus res;
+    NMDynamicUpdate update = {sanitizedText.c_str(), {}, {}};
+    if (QueueUpdate(handle, handleIsValid, update, NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_TEXT, &res)) {
+        return res;
+    }
+    if (!handleIsValid) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_HANDLE;
+    }
 
-    return sNMUpdateDynamicNotificationText(handle,
-                                            text);
+    return CallUpdateDynamicNotification(handle, moduleHandle, update, NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_TEXT);
 }
 
 NotificationModuleStatus NotificationModule_UpdateDynamicNotificationBackgroundColor(NotificationModuleHandle handle,
@@ -513,9 +1019,19 @@ NotificationModuleStatus NotificationModule_UpdateDynamicNotificationBackgroundC
     if (handle == 0) {
         return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
     }
+    NotificationModuleHandle moduleHandle;
+    bool handleIsValid = HandleTable_Resolve(handle, &moduleHandle);
 
-    return sNMUpdateDynamicNotificationBackgroundColor(handle,
-                                                       backgroundColor);
+    NotificationModuleStatus res;
+    NMDynamicUpdate update = {nullptr, {}, backgroundColor};
+    if (QueueUpdate(handle, handleIsValid, update, NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_BACKGROUND_COLOR, &res)) {
+        return res;
+    }
+    if (!handleIsValid) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_HANDLE;
+    }
+
+    return CallUpdateDynamicNotification(handle, moduleHandle, update, NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_BACKGROUND_COLOR);
 }
 
 NotificationModuleStatus NotificationModule_UpdateDynamicNotificationTextColor(NotificationModuleHandle handle,
@@ -530,9 +1046,96 @@ NotificationModuleStatus NotificationModule_UpdateDynamicNotificationTextColor(N
     if (handle == 0) {
         return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
     }
+    NotificationModuleHandle moduleHandle;
+    bool handleIsValid = HandleTable_Resolve(handle, &moduleHandle);
+
+    NotificationModuleStatus res;
+    NMDynamicUpdate update = {nullptr, textColor, {}};
+    if (QueueUpdate(handle, handleIsValid, update, NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_TEXT_COLOR, &res)) {
+        return res;
+    }
+    if (!handleIsValid) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_HANDLE;
+    }
 
-    return sNMUpdateDynamicNotificationTextColor(handle,
-                                                 textColor);
+    return CallUpdateDynamicNotification(handle, moduleHandle, update, NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_TEXT_COLOR);
+}
+
+NotificationModuleStatus NotificationModule_UpdateDynamicNotification(NotificationModuleHandle handle,
+                                                                      const NMDynamicUpdate *update,
+                                                                      uint32_t fieldMask) {
+    if (sNotificationModuleVersion == NOTIFICATION_MODULE_API_VERSION_ERROR) {
+        return NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED;
+    }
+
+    if (handle == 0 || update == nullptr || fieldMask == 0 || (fieldMask & ~NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_ALL) != 0) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    if ((fieldMask & NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_TEXT) && update->text == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+
+    if (sNMUpdateDynamicNotification == nullptr) {
+        // Fallback for modules without NMUpdateDynamicNotification, the attributes may be rendered with a mix of old and new values.
+        auto res = NOTIFICATION_MODULE_RESULT_SUCCESS;
+        if (fieldMask & NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_BACKGROUND_COLOR) {
+            res = NotificationModule_UpdateDynamicNotificationBackgroundColor(handle, update->backgroundColor);
+        }
+        if (res == NOTIFICATION_MODULE_RESULT_SUCCESS && (fieldMask & NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_TEXT_COLOR)) {
+            res = NotificationModule_UpdateDynamicNotificationTextColor(handle, update->textColor);
+        }
+        if (res == NOTIFICATION_MODULE_RESULT_SUCCESS && (fieldMask & NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_TEXT)) {
+            res = NotificationModule_UpdateDynamicNotificationText(handle, update->text);
+        }
+        return res;
+    }
+
+    NotificationModuleHandle moduleHandle;
+    bool handleIsValid = HandleTable_Resolve(handle, &moduleHandle);
+
+    NMDynamicUpdate sanitizedUpdate = *update;
+    SanitizedText sanitizedText((fieldMask & NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_TEXT) ? update->text : nullptr);
+    if (fieldMask & NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_TEXT) {
+        if (sanitizedText.c_str() == nullptr) {
+            return NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED;
+        }
+        sanitizedUpdate.text = sanitizedText.c_str();
+    }
+
+    NotificationModuleStatus res;
+    if (QueueUpdate(handle, handleIsValid, sanitizedUpdate, fieldMask, &res)) {
+        return res;
+    }
+    if (!handleIsValid) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_HANDLE;
+    }
+
+    return CallUpdateDynamicNotification(handle, moduleHandle, sanitizedUpdate, fieldMask);
+}
+
+static NotificationModuleStatus CallFinishDynamicNotification(NotificationModuleHandle handle,
+                                                              NotificationModuleHandle moduleHandle,
+                                                              NotificationModuleStatusFinish finishMode,
+                                                              float durationBeforeFadeOutInSeconds,
+                                                              float shakeDurationInSeconds) {
+    Animations_Stop(handle);
+    LiveNotifications_Stop(handle);
+    Watchdog_Untrack(handle);
+    TextShadow_Untrack(handle);
+
+    auto res           = NOTIFICATION_MODULE_RESULT_SUCCESS;
+    uint64_t startInUs = Scheduler_GetTimeInUs();
+    if (!SharedRing_PushFinish(moduleHandle, finishMode, durationBeforeFadeOutInSeconds, shakeDurationInSeconds)) {
+        res = sNMFinishDynamicNotification(moduleHandle,
+                                           finishMode,
+                                           durationBeforeFadeOutInSeconds,
+                                           shakeDurationInSeconds);
+    }
+    RecordModuleCall(res, startInUs);
+    if (res == NOTIFICATION_MODULE_RESULT_SUCCESS || res == NOTIFICATION_MODULE_RESULT_INVALID_HANDLE) {
+        HandleTable_MarkFinished(handle);
+    }
+    return res;
 }
 
 static NotificationModuleStatus NotificationModule_FinishDynamicNotificationEx(NotificationModuleHandle handle,
@@ -550,10 +1153,32 @@ static NotificationModuleStatus NotificationModule_FinishDynamicNotificationEx(N
         return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
     }
 
-    return sNMFinishDynamicNotification(handle,
-                                        finishMode,
-                                        durationBeforeFadeOutInSeconds,
-                                        shakeDurationInSeconds);
+    NotificationModuleHandle moduleHandle;
+    bool handleIsValid = HandleTable_Resolve(handle, &moduleHandle);
+
+    if (Dispatcher_IsActive()) {
+        DispatcherOp op;
+        op.type                           = DISPATCHER_OP_TYPE_FINISH;
+        op.handle                         = handle;
+        op.finishMode                     = finishMode;
+        op.durationBeforeFadeOutInSeconds = durationBeforeFadeOutInSeconds;
+        op.shakeDurationInSeconds         = shakeDurationInSeconds;
+        NotificationModuleStatus res;
+        if (Dispatcher_TryQueue(op, handleIsValid, &res)) {
+            if (res == NOTIFICATION_MODULE_RESULT_SUCCESS) {
+                // Animations, live notifications and the watchdog must not queue any updates after the finish.
+                Animations_Stop(handle);
+                LiveNotifications_Stop(handle);
+                Watchdog_Untrack(handle);
+            }
+            return res;
+        }
+    }
+    if (!handleIsValid) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_HANDLE;
+    }
+
+    return CallFinishDynamicNotification(handle, moduleHandle, finishMode, durationBeforeFadeOutInSeconds, shakeDurationInSeconds);
 }
 
 NotificationModuleStatus NotificationModule_FinishDynamicNotification(NotificationModuleHandle handle,
@@ -571,4 +1196,408 @@ NotificationModuleStatus NotificationModule_FinishDynamicNotificationWithShake(N
                                                           NOTIFICATION_MODULE_STATUS_FINISH_WITH_SHAKE,
                                                           durationBeforeFadeOutInSeconds,
                                                           shakeDuration);
-}
\ No newline at end of file
+}
+NotificationModuleStatus NotificationModule_ExecuteQueuedOp(const DispatcherOp &op) {
+    if (sNotificationModuleVersion == NOTIFICATION_MODULE_API_VERSION_ERROR) {
+        return NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED;
+    }
+    NotificationModuleHandle moduleHandle;
+    switch (op.type) {
+        case DISPATCHER_OP_TYPE_ADD_STATIC:
+        case DISPATCHER_OP_TYPE_ADD_DYNAMIC: {
+            NMNotificationDesc desc             = {};
+            desc.size                           = sizeof(NMNotificationDesc);
+            desc.text                           = op.text.c_str();
+            desc.durationBeforeFadeOutInSeconds = op.durationBeforeFadeOutInSeconds;
+            desc.shakeDurationInSeconds         = op.shakeDurationInSeconds;
+            desc.textColor                      = op.textColor;
+            desc.backgroundColor                = op.backgroundColor;
+            desc.callback                       = op.callback;
+            desc.callbackContext                = op.callbackContext;
+            desc.keepUntilShown                 = op.keepUntilShown;
+            if (op.type == DISPATCHER_OP_TYPE_ADD_DYNAMIC) {
+                desc.type = NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC;
+                return CallAddDynamicNotification(op.handle, desc);
+            }
+            desc.type = op.notificationType;
+            return CallAddStaticNotification(desc);
+        }
+        case DISPATCHER_OP_TYPE_UPDATE: {
+            // The notification might be gone or its creation might have failed in the meantime.
+            if (!HandleTable_Resolve(op.handle, &moduleHandle)) {
+                return NOTIFICATION_MODULE_RESULT_INVALID_HANDLE;
+            }
+            NMDynamicUpdate update = {op.text.c_str(), op.textColor, op.backgroundColor};
+            return CallUpdateDynamicNotification(op.handle, moduleHandle, update, op.fieldMask);
+        }
+        case DISPATCHER_OP_TYPE_FINISH:
+            if (!HandleTable_Resolve(op.handle, &moduleHandle)) {
+                return NOTIFICATION_MODULE_RESULT_INVALID_HANDLE;
+            }
+            return CallFinishDynamicNotification(op.handle, moduleHandle, op.finishMode, op.durationBeforeFadeOutInSeconds, op.shakeDurationInSeconds);
+    }
+    return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+}
+
+NotificationModuleStatus NotificationModule_InternText(const char *text, NotificationModuleTextId *outId) {
+    SanitizedText sanitizedText(text);
+    if (text != nullptr && sanitizedText.c_str() == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED;
+    }
+    return InternTable_Intern(sanitizedText.c_str(), outId);
+}
+
+NotificationModuleStatus NotificationModule_SetMaxTextLength(uint32_t maxLengthInCodePoints) {
+    TextSanitizer_SetMaxLength(maxLengthInCodePoints);
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+static NotificationModuleStatus NotificationModule_AddStaticNotificationInterned(NotificationModuleTextId textId,
+                                                                                 NotificationModuleNotificationType type) {
+    if (sNotificationModuleVersion == NOTIFICATION_MODULE_API_VERSION_ERROR) {
+        return NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED;
+    }
+
+    const char *text;
+    uint32_t textLength;
+    if (!InternTable_Lookup(textId, &text, &textLength)) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+
+    NMNotificationDesc desc;
+    NotificationModule_InitNotificationDesc(type, &desc);
+    desc.text = text;
+    // Queued notifications need a copy of the text, so the shared variant is not used while the dispatcher is active.
+    if (sNMAddStaticNotificationShared == nullptr || Dispatcher_IsActive()) {
+        return AddStaticNotification(desc);
+    }
+    auto res = CheckAddSupported(type);
+    if (res != NOTIFICATION_MODULE_RESULT_SUCCESS) {
+        return res;
+    }
+
+    auto callback        = desc.callback;
+    auto callbackContext = desc.callbackContext;
+    StaticCallbacks_Wrap(callback, callbackContext);
+    uint64_t startInUs = Scheduler_GetTimeInUs();
+    res                = sNMAddStaticNotificationShared(text,
+                                                        textLength,
+                                                        type,
+                                                        desc.durationBeforeFadeOutInSeconds,
+                                                        desc.shakeDurationInSeconds,
+                                                        desc.textColor,
+                                                        desc.backgroundColor,
+                                                        callback,
+                                                        callbackContext,
+                                                        desc.keepUntilShown);
+    RecordModuleCall(res, startInUs);
+    if (res != NOTIFICATION_MODULE_RESULT_SUCCESS) {
+        StaticCallbacks_Release(callback, callbackContext);
+        // Retried like AddStaticNotification does, the queued operation has its own copy of the interned text.
+        DispatcherOp op;
+        InitStaticAddOp(desc, op);
+        op.text = std::string(text, textLength);
+        if (Dispatcher_QueueRetry(op, res)) {
+            res = NOTIFICATION_MODULE_RESULT_SUCCESS;
+        }
+        return res;
+    }
+    if (sNMGetQueueInfo == nullptr) {
+        QueueEstimate_OnStaticAdded(textLength, desc.durationBeforeFadeOutInSeconds, desc.shakeDurationInSeconds);
+    }
+    return res;
+}
+
+NotificationModuleStatus NotificationModule_AddInfoNotificationInterned(NotificationModuleTextId textId) {
+    static_assert(NOTIFICATION_MODULE_NOTIFICATION_TYPE_INFO < MAX_NOTIFICATION_TYPES);
+    return NotificationModule_AddStaticNotificationInterned(textId, NOTIFICATION_MODULE_NOTIFICATION_TYPE_INFO);
+}
+
+NotificationModuleStatus NotificationModule_AddErrorNotificationInterned(NotificationModuleTextId textId) {
+    static_assert(NOTIFICATION_MODULE_NOTIFICATION_TYPE_ERROR < MAX_NOTIFICATION_TYPES);
+    return NotificationModule_AddStaticNotificationInterned(textId, NOTIFICATION_MODULE_NOTIFICATION_TYPE_ERROR);
+}
+
+NotificationModuleStatus NotificationModule_AddDynamicNotificationInterned(NotificationModuleTextId textId,
+                                                                           NotificationModuleHandle *outHandle) {
+    const char *text;
+    uint32_t textLength;
+    if (!InternTable_Lookup(textId, &text, &textLength)) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    // There is no shared variant for creating dynamic notifications, the module copies the initial text.
+    return NotificationModule_AddDynamicNotification(text, outHandle);
+}
+
+NotificationModuleStatus NotificationModule_UpdateDynamicNotificationTextInterned(NotificationModuleHandle handle,
+                                                                                  NotificationModuleTextId textId) {
+    if (sNotificationModuleVersion == NOTIFICATION_MODULE_API_VERSION_ERROR) {
+        return NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED;
+    }
+
+    const char *text;
+    uint32_t textLength;
+    if (!InternTable_Lookup(textId, &text, &textLength)) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+
+    if (sNMUpdateDynamicNotificationTextShared == nullptr || Dispatcher_IsActive()) {
+        return NotificationModule_UpdateDynamicNotificationText(handle, text);
+    }
+
+    if (handle == 0) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    NotificationModuleHandle moduleHandle;
+    if (!HandleTable_Resolve(handle, &moduleHandle)) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_HANDLE;
+    }
+
+    TextShadowUpdate shadow(handle, text);
+    if (shadow.IsUnchanged()) {
+        Stats_RecordCoalesced();
+        Watchdog_Touch(handle);
+        return NOTIFICATION_MODULE_RESULT_SUCCESS;
+    }
+
+    // Only a pointer to the interned text is written into the shared ring.
+    auto res               = NOTIFICATION_MODULE_RESULT_SUCCESS;
+    NMDynamicUpdate update = {text, {}, {}};
+    uint64_t startInUs     = Scheduler_GetTimeInUs();
+    if (!SharedRing_PushUpdate(moduleHandle, update, NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_TEXT, true)) {
+        res = sNMUpdateDynamicNotificationTextShared(moduleHandle,
+                                                     text,
+                                                     textLength);
+    }
+    RecordModuleCall(res, startInUs);
+    shadow.Commit(res == NOTIFICATION_MODULE_RESULT_SUCCESS);
+    if (res == NOTIFICATION_MODULE_RESULT_SUCCESS) {
+        Watchdog_Touch(handle);
+    }
+    return res;
+}
+
+NotificationModuleStatus NotificationModule_RegisterTemplate(const char *format,
+                                                             NotificationModuleNotificationType profile,
+                                                             NotificationModuleTemplateId *outId) {
+    return Templates_Register(format, profile, outId);
+}
+
+NotificationModuleStatus NotificationModule_AddTemplateNotification(NotificationModuleTemplateId templateId,
+                                                                    const NMTemplateArg *args,
+                                                                    uint32_t numArgs) {
+    if (sNotificationModuleVersion == NOTIFICATION_MODULE_API_VERSION_ERROR) {
+        return NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED;
+    }
+
+    char text[NOTIFICATION_TEMPLATE_MAX_TEXT_LENGTH];
+    NotificationModuleNotificationType profile;
+    auto res = Templates_Render(templateId, args, numArgs, text, sizeof(text), &profile);
+    if (res != NOTIFICATION_MODULE_RESULT_SUCCESS) {
+        return res;
+    }
+    if (profile == NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC) {
+        return NOTIFICATION_MODULE_RESULT_UNSUPPORTED_TYPE;
+    }
+
+    NMNotificationDesc desc;
+    NotificationModule_InitNotificationDesc(profile, &desc);
+    desc.text = text;
+    return AddStaticNotification(desc);
+}
+
+NotificationModuleStatus NotificationModule_UpdateDynamicNotificationTextFromTemplate(NotificationModuleHandle handle,
+                                                                                      NotificationModuleTemplateId templateId,
+                                                                                      const NMTemplateArg *args,
+                                                                                      uint32_t numArgs) {
+    if (sNotificationModuleVersion == NOTIFICATION_MODULE_API_VERSION_ERROR) {
+        return NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED;
+    }
+
+    char text[NOTIFICATION_TEMPLATE_MAX_TEXT_LENGTH];
+    auto res = Templates_Render(templateId, args, numArgs, text, sizeof(text), nullptr);
+    if (res != NOTIFICATION_MODULE_RESULT_SUCCESS) {
+        return res;
+    }
+    return NotificationModule_UpdateDynamicNotificationText(handle, text);
+}
+
+NotificationModuleStatus NotificationModule_TagHandle(NotificationModuleHandle handle, NotificationModuleTag tag) {
+    if (handle == 0) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    if (!HandleTable_SetTag(handle, tag)) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_HANDLE;
+    }
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+// Notifications of reserved handles haven't been created yet, their module handle is 0.
+static bool HasReservedHandle(const std::vector<NotificationModuleHandle> &moduleHandles) {
+    return std::find(moduleHandles.begin(), moduleHandles.end(), 0) != moduleHandles.end();
+}
+
+NotificationModuleStatus NotificationModule_FinishAllWithTag(NotificationModuleTag tag, float durationBeforeFadeOutInSeconds) {
+    if (sNotificationModuleVersion == NOTIFICATION_MODULE_API_VERSION_ERROR) {
+        return NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED;
+    }
+    if (sNMFinishDynamicNotification == nullptr || sNotificationModuleVersion < 1) {
+        return NOTIFICATION_MODULE_RESULT_UNSUPPORTED_COMMAND;
+    }
+
+    std::vector<NotificationModuleHandle> handles;
+    std::vector<NotificationModuleHandle> moduleHandles;
+    HandleTable_CollectWithTag(tag, handles, moduleHandles);
+    if (handles.empty()) {
+        return NOTIFICATION_MODULE_RESULT_SUCCESS;
+    }
+
+    auto res = NOTIFICATION_MODULE_RESULT_SUCCESS;
+    if (sNMFinishDynamicNotificationBatch == nullptr || Dispatcher_IsActive() || HasReservedHandle(moduleHandles)) {
+        // One by one, so handles with queued operations are finished after them.
+        for (auto handle : handles) {
+            auto cur = NotificationModule_FinishDynamicNotificationEx(handle, NOTIFICATION_MODULE_STATUS_FINISH, durationBeforeFadeOutInSeconds, 0.0f);
+            // Notifications that are already gone are not an error here.
+            if (cur != NOTIFICATION_MODULE_RESULT_SUCCESS && cur != NOTIFICATION_MODULE_RESULT_INVALID_HANDLE && res == NOTIFICATION_MODULE_RESULT_SUCCESS) {
+                res = cur;
+            }
+        }
+        return res;
+    }
+
+    for (auto handle : handles) {
+        Animations_Stop(handle);
+        LiveNotifications_Stop(handle);
+        Watchdog_Untrack(handle);
+        TextShadow_Untrack(handle);
+    }
+    // Updates in the shared ring have to be applied before the notifications are finished.
+    SharedRing_Sync();
+    uint64_t startInUs = Scheduler_GetTimeInUs();
+    res                = sNMFinishDynamicNotificationBatch(moduleHandles.data(),
+                                                           moduleHandles.size(),
+                                                           NOTIFICATION_MODULE_STATUS_FINISH,
+                                                           durationBeforeFadeOutInSeconds,
+                                                           0.0f);
+    RecordModuleCall(res, startInUs);
+    if (res == NOTIFICATION_MODULE_RESULT_SUCCESS) {
+        for (auto handle : handles) {
+            HandleTable_MarkFinished(handle);
+        }
+    }
+    return res;
+}
+
+NotificationModuleStatus NotificationModule_UpdateColorsWithTag(NotificationModuleTag tag, NMColor textColor, NMColor backgroundColor) {
+    if (sNotificationModuleVersion == NOTIFICATION_MODULE_API_VERSION_ERROR) {
+        return NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED;
+    }
+
+    std::vector<NotificationModuleHandle> handles;
+    std::vector<NotificationModuleHandle> moduleHandles;
+    HandleTable_CollectWithTag(tag, handles, moduleHandles);
+    if (handles.empty()) {
+        return NOTIFICATION_MODULE_RESULT_SUCCESS;
+    }
+
+    NMDynamicUpdate update = {};
+    update.textColor       = textColor;
+    update.backgroundColor = backgroundColor;
+    uint32_t fieldMask     = NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_TEXT_COLOR | NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_BACKGROUND_COLOR;
+
+    auto res = NOTIFICATION_MODULE_RESULT_SUCCESS;
+    if (sNMUpdateDynamicNotificationBatch == nullptr || Dispatcher_IsActive() || HasReservedHandle(moduleHandles)) {
+        // One by one, so handles with queued operations are updated after them.
+        for (auto handle : handles) {
+            auto cur = NotificationModule_UpdateDynamicNotification(handle, &update, fieldMask);
+            if (cur != NOTIFICATION_MODULE_RESULT_SUCCESS && cur != NOTIFICATION_MODULE_RESULT_INVALID_HANDLE && res == NOTIFICATION_MODULE_RESULT_SUCCESS) {
+                res = cur;
+            }
+        }
+        return res;
+    }
+
+    SharedRing_Sync();
+    uint64_t startInUs = Scheduler_GetTimeInUs();
+    res                = sNMUpdateDynamicNotificationBatch(moduleHandles.data(),
+                                                           moduleHandles.size(),
+                                                           &update,
+                                                           fieldMask);
+    RecordModuleCall(res, startInUs);
+    if (res == NOTIFICATION_MODULE_RESULT_SUCCESS) {
+        for (auto handle : handles) {
+            Watchdog_Touch(handle);
+        }
+    }
+    return res;
+}
+
+NotificationModuleStatus NotificationModule_SetDynamicNotificationInactivityTimeout(NotificationModuleHandle handle, float timeoutInSeconds) {
+    if (sNotificationModuleVersion == NOTIFICATION_MODULE_API_VERSION_ERROR) {
+        return NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED;
+    }
+    if (handle == 0) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    // Deferred handles are accepted as well, the watchdog only queues operations after their creation.
+    if (!HandleTable_IsOpen(handle)) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_HANDLE;
+    }
+
+    if (!Watchdog_SetTimeout(handle, timeoutInSeconds)) {
+        // The handle has been created without a timeout.
+        static_assert(NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC < MAX_NOTIFICATION_TYPES);
+        Watchdog_Track(handle, timeoutInSeconds, sDefaultContext.defaultValues[NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC]);
+    }
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+NotificationModuleStatus NotificationModule_GetQueueInfo(NMQueueInfo *outInfo) {
+    if (sNotificationModuleVersion == NOTIFICATION_MODULE_API_VERSION_ERROR) {
+        return NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED;
+    }
+    if (outInfo == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+
+    if (sNMGetQueueInfo != nullptr) {
+        NMQueueInfo info = {};
+        auto res         = sNMGetQueueInfo(&info);
+        if (res != NOTIFICATION_MODULE_RESULT_SUCCESS) {
+            return res;
+        }
+        info.isEstimate = false;
+        *outInfo        = info;
+        return NOTIFICATION_MODULE_RESULT_SUCCESS;
+    }
+
+    bool overlayReady = true;
+    if (sNMIsOverlayReady != nullptr && sNMIsOverlayReady(&overlayReady) != NOTIFICATION_MODULE_RESULT_SUCCESS) {
+        overlayReady = true;
+    }
+    QueueEstimate_Get(overlayReady, outInfo);
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+NotificationModuleStatus NotificationModule_GetThrottleDelay(uint32_t *outDelayInMs) {
+    if (outDelayInMs == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    NMQueueInfo info;
+    auto res = NotificationModule_GetQueueInfo(&info);
+    if (res != NOTIFICATION_MODULE_RESULT_SUCCESS) {
+        return res;
+    }
+
+    // The load is the higher of the memory usage and the number of pending notifications (relative to THROTTLE_PENDING_LIMIT).
+    float load = info.capacityInBytes > 0 ? (float) info.bytesUsed / (float) info.capacityInBytes : 0.0f;
+    load       = std::max(load, (float) info.pending / (float) THROTTLE_PENDING_LIMIT);
+    if (load <= THROTTLE_START_LOAD) {
+        *outDelayInMs = 0;
+    } else if (load >= 1.0f) {
+        *outDelayInMs = THROTTLE_MAX_DELAY_IN_MS;
+    } else {
+        *outDelayInMs = (uint32_t) ((load - THROTTLE_START_LOAD) / (1.0f - THROTTLE_START_LOAD) * THROTTLE_MAX_DELAY_IN_MS);
+    }
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
@@ -0,0 +1,157 @@
+#include "watchdog.h"
+#include "handle_table.h"
+#include "intern_table.h"
+#include "internal.h"
+#include "scheduler.h"
+#include "timer_wheel.h"
+
+#include <deque>
+#include <mutex>
+#include <notifications/notifications.h>
+#include <vector>
+
+// Timeouts are rounded up to 100ms.
+#define WATCHDOG_TICK_IN_US 100000
+
+struct WatchdogEntry {
+    // Must stay the first member, expired nodes are cast back to the entry.
+    TimerWheelNode node;
+    NotificationModuleHandle handle      = 0;
+    uint64_t timeoutInUs                 = 0;
+    NotificationModuleTextId textId      = NOTIFICATION_MODULE_TEXT_ID_INVALID;
+    float durationBeforeFadeOutInSeconds = 0.0f;
+    float shakeDurationInSeconds         = 0.0f;
+};
+
+static std::mutex sWatchdogMutex;
+static TimerWheel sWatchdogWheel(WATCHDOG_TICK_IN_US);
+// Indexed by the handle table slot, a deque keeps the nodes at a stable address.
+static std::deque<WatchdogEntry> sWatchdogEntries;
+static SchedulerTaskId sWatchdogTaskId = 0;
+
+// Has to be called while holding sWatchdogMutex. Returns nullptr if the handle is not tracked.
+static WatchdogEntry *GetEntry(NotificationModuleHandle handle) {
+    uint32_t index = HandleTable_GetSlotIndex(handle);
+    if (index >= sWatchdogEntries.size() || sWatchdogEntries[index].handle != handle) {
+        return nullptr;
+    }
+    return &sWatchdogEntries[index];
+}
+
+static uint32_t WatchdogTask(void *, uint64_t nowInUs) {
+    std::vector<TimerWheelNode *> expiredNodes;
+    std::vector<WatchdogEntry> expired;
+    {
+        std::lock_guard<std::mutex> lock(sWatchdogMutex);
+        sWatchdogWheel.Advance(nowInUs, expiredNodes);
+        for (auto *node : expiredNodes) {
+            auto *entry = (WatchdogEntry *) node;
+            expired.push_back(*entry);
+            entry->handle = 0;
+        }
+        if (sWatchdogWheel.IsEmpty() && expired.empty()) {
+            sWatchdogTaskId = 0;
+            return 0;
+        }
+    }
+
+    for (const auto &entry : expired) {
+        const char *text;
+        uint32_t textLength;
+        if (entry.textId != NOTIFICATION_MODULE_TEXT_ID_INVALID && InternTable_Lookup(entry.textId, &text, &textLength)) {
+            NotificationModule_UpdateDynamicNotificationText(entry.handle, text);
+        }
+        NotificationModule_FinishDynamicNotificationWithShake(entry.handle,
+                                                              entry.durationBeforeFadeOutInSeconds,
+                                                              entry.shakeDurationInSeconds);
+    }
+
+    std::lock_guard<std::mutex> lock(sWatchdogMutex);
+    if (sWatchdogWheel.IsEmpty()) {
+        sWatchdogTaskId = 0;
+        return 0;
+    }
+    uint32_t delay = sWatchdogWheel.GetNextWakeupDelayInUs(Scheduler_GetTimeInUs());
+    return delay > 0 ? delay : 1;
+}
+
+// Has to be called while holding sWatchdogMutex.
+static void ScheduleEntry(WatchdogEntry &entry) {
+    uint64_t now = Scheduler_GetTimeInUs();
+    sWatchdogWheel.Schedule(&entry.node, now + entry.timeoutInUs, now);
+    uint32_t delay = sWatchdogWheel.GetNextWakeupDelayInUs(now);
+    if (sWatchdogTaskId == 0) {
+        sWatchdogTaskId = Scheduler_AddTask(WatchdogTask, nullptr, delay);
+    } else {
+        Scheduler_RunTaskEarlier(sWatchdogTaskId, delay);
+    }
+}
+
+void Watchdog_Track(NotificationModuleHandle handle, float timeoutInSeconds, const NMDefaultValueStore &defaults) {
+    uint32_t index = HandleTable_GetSlotIndex(handle);
+    std::lock_guard<std::mutex> lock(sWatchdogMutex);
+    if (index >= sWatchdogEntries.size()) {
+        sWatchdogEntries.resize(index + 1);
+    }
+    auto &entry = sWatchdogEntries[index];
+    // The slot might still be scheduled for a previous handle that was finished without calling Watchdog_Untrack.
+    sWatchdogWheel.Cancel(&entry.node);
+    entry.handle                         = handle;
+    entry.textId                         = defaults.inactivityTimeoutTextId;
+    entry.durationBeforeFadeOutInSeconds = defaults.durationBeforeFadeOutInSeconds;
+    entry.shakeDurationInSeconds         = defaults.shakeDurationOnErrorInSeconds;
+    // Handles without a timeout are kept as well, so a later Watchdog_SetTimeout still uses the values of their context.
+    if (timeoutInSeconds <= 0.0f) {
+        entry.timeoutInUs = 0;
+        return;
+    }
+    entry.timeoutInUs = (uint64_t) (timeoutInSeconds * 1000000.0f);
+    ScheduleEntry(entry);
+}
+
+bool Watchdog_SetTimeout(NotificationModuleHandle handle, float timeoutInSeconds) {
+    std::lock_guard<std::mutex> lock(sWatchdogMutex);
+    auto *entry = GetEntry(handle);
+    if (entry == nullptr) {
+        return false;
+    }
+    if (timeoutInSeconds <= 0.0f) {
+        sWatchdogWheel.Cancel(&entry->node);
+        entry->timeoutInUs = 0;
+        return true;
+    }
+    entry->timeoutInUs = (uint64_t) (timeoutInSeconds * 1000000.0f);
+    ScheduleEntry(*entry);
+    return true;
+}
+
+void Watchdog_Touch(NotificationModuleHandle handle) {
+    std::lock_guard<std::mutex> lock(sWatchdogMutex);
+    auto *entry = GetEntry(handle);
+    if (entry == nullptr || entry->timeoutInUs == 0) {
+        return;
+    }
+    uint64_t now = Scheduler_GetTimeInUs();
+    // Deadlines only move later here, so the task never has to run earlier than planned.
+    sWatchdogWheel.Schedule(&entry->node, now + entry->timeoutInUs, now);
+}
+
+void Watchdog_Untrack(NotificationModuleHandle handle) {
+    std::lock_guard<std::mutex> lock(sWatchdogMutex);
+    auto *entry = GetEntry(handle);
+    if (entry == nullptr) {
+        return;
+    }
+    sWatchdogWheel.Cancel(&entry->node);
+    entry->handle = 0;
+}
+
+void Watchdog_Reset() {
+    std::lock_guard<std::mutex> lock(sWatchdogMutex);
+    sWatchdogWheel.Clear();
+    for (auto &entry : sWatchdogEntries) {
+        entry.handle = 0;
+    }
+    // The scheduler task is removed by Scheduler_Shutdown.
+    sWatchdogTaskId = 0;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "internal.h"
+#include "notifications/notification_defines.h"
+
+/**
+ * Inactivity watchdog for dynamic notifications. Dynamic notifications that haven't been updated for their timeout are
+ * finished with a shake (and optionally a final message) on the scheduler thread.
+ * All deadlines are kept in a single timer wheel, updating a deadline is O(1).
+ */
+
+/**
+ * Starts watching a new dynamic notification. The final text, fade out delay and shake duration are taken from
+ * `defaults`, the store of the context the notification has been added in. A timeout of 0 disables the watchdog for
+ * this handle until Watchdog_SetTimeout is called.
+ */
+void Watchdog_Track(NotificationModuleHandle handle, float timeoutInSeconds, const NMDefaultValueStore &defaults);
+
+/**
+ * Changes the timeout of a tracked handle and restarts it. A timeout of 0 disables it. Returns false if the handle is unknown.
+ */
+bool Watchdog_SetTimeout(NotificationModuleHandle handle, float timeoutInSeconds);
+
+/**
+ * Restarts the timeout of a handle. Called after every successful update.
+ */
+void Watchdog_Touch(NotificationModuleHandle handle);
+
+/**
+ * Stops watching a handle. Called when a dynamic notification is finished.
+ */
+void Watchdog_Untrack(NotificationModuleHandle handle);
+
+/**
+ * Stops watching all handles. Called by NotificationModule_DeInitLibrary.
+ */
+void Watchdog_Reset();
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// Helpers for the host benchmarks. Results are printed as one line per case.
+
+static inline uint64_t BenchNowInNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Collects the latency of single operations and prints the throughput and the tail latency.
+ */
+class LatencyRecorder {
+public:
+    explicit LatencyRecorder(size_t expectedSamples = 0) {
+        mSamples.reserve(expectedSamples);
+    }
+
+    void Add(uint64_t latencyInNs) {
+        mSamples.push_back(latencyInNs);
+    }
+
+    // `totalInNs` is the wall time of the whole run, the throughput is based on it.
+    void Print(const char *name, uint64_t totalInNs) {
+        if (mSamples.empty()) {
+            printf("%-48s no samples\n", name);
+            return;
+        }
+        std::sort(mSamples.begin(), mSamples.end());
+        printf("%-48s %10.0f ops/s  p50 %8.2f us  p99 %8.2f us  p99.9 %8.2f us  max %8.2f us\n",
+               name,
+               (double) mSamples.size() * 1e9 / (double) totalInNs,
+               Percentile(0.5),
+               Percentile(0.99),
+               Percentile(0.999),
+               (double) mSamples.back() / 1000.0);
+    }
+
+private:
+    double Percentile(double p) const {
+        size_t index = std::min(mSamples.size() - 1, (size_t) (p * (double) mSamples.size()));
+        return (double) mSamples[index] / 1000.0;
+    }
+
+    std::vector<uint64_t> mSamples;
+};
+
+/**
+ * Runs `op` `iterations` times and prints the average time per call.
+ */
+template<typename Op>
+static inline void BenchLoop(const char *name, uint32_t iterations, Op op) {
+    uint64_t start = BenchNowInNs();
+    for (uint32_t i = 0; i < iterations; i++) {
+        op(i);
+    }
+    uint64_t total = BenchNowInNs() - start;
+    printf("%-48s %10.0f ops/s  %8.1f ns/op\n", name, (double) iterations * 1e9 / (double) total, (double) total / (double) iterations);
+}
@@ -0,0 +1,76 @@
+#include "bench.h"
+#include "test.h"
+
+#include <cstring>
+#include <string>
+#include <unistd.h>
+#include <unordered_map>
+
+// Opening a catalog and looking up texts, compared to parsing the text file at startup like plugins do today.
+
+#define NUM_ENTRIES 10000
+#define NUM_LOOKUPS 1000000
+
+static char sTempDir[] = "/tmp/nmcatalogXXXXXX";
+
+// Parses "<id>=<text>" lines into a map, without escapes.
+static std::unordered_map<uint32_t, std::string> ParseTextFile(const std::string &path) {
+    std::unordered_map<uint32_t, std::string> texts;
+    FILE *f = fopen(path.c_str(), "r");
+    CHECK(f != nullptr);
+    char line[256];
+    while (fgets(line, sizeof(line), f) != nullptr) {
+        char *separator = strchr(line, '=');
+        if (separator == nullptr) {
+            continue;
+        }
+        line[strcspn(line, "\n")]        = '\0';
+        texts[strtoul(line, nullptr, 0)] = separator + 1;
+    }
+    fclose(f);
+    return texts;
+}
+
+int main() {
+    printf("bench_catalog\n");
+    CHECK(mkdtemp(sTempDir) != nullptr);
+    std::string sourcePath  = std::string(sTempDir) + "/bench.txt";
+    std::string catalogPath = std::string(sTempDir) + "/bench.nmc";
+
+    FILE *f = fopen(sourcePath.c_str(), "w");
+    CHECK(f != nullptr);
+    for (uint32_t i = 0; i < NUM_ENTRIES; i++) {
+        fprintf(f, "%u=Localized message number %u of the benchmark catalog\n", i * 2, i);
+    }
+    fclose(f);
+    std::string command = "python3 " NM_HOST_TOOLS_DIR "/nmcatalog.py " + sourcePath + " " + catalogPath;
+    CHECK(system(command.c_str()) == 0);
+
+    NotificationModuleCatalogHandle catalog = nullptr;
+    BenchLoop("open catalog (10000 entries)", 100, [&](uint32_t) {
+        if (catalog != nullptr) {
+            NotificationModule_CloseCatalog(catalog);
+        }
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_OpenCatalog(catalogPath.c_str(), &catalog));
+    });
+    std::unordered_map<uint32_t, std::string> texts;
+    BenchLoop("parse text file (10000 entries)", 100, [&](uint32_t) { texts = ParseTextFile(sourcePath); });
+
+    const char *text;
+    uint64_t checksum = 0;
+    BenchLoop("catalog lookup, hit", NUM_LOOKUPS, [&](uint32_t i) {
+        NotificationModule_GetCatalogText(catalog, ((i * 7919) % NUM_ENTRIES) * 2, &text);
+        checksum += (uintptr_t) text;
+    });
+    BenchLoop("catalog lookup, miss", NUM_LOOKUPS, [&](uint32_t i) {
+        checksum += NotificationModule_GetCatalogText(catalog, ((i * 7919) % NUM_ENTRIES) * 2 + 1, &text);
+    });
+    BenchLoop("std::unordered_map lookup, hit", NUM_LOOKUPS, [&](uint32_t i) {
+        checksum += (uintptr_t) texts.find(((i * 7919) % NUM_ENTRIES) * 2)->second.c_str();
+    });
+    printf("(checksum %llx)\n", (unsigned long long) checksum);
+
+    NotificationModule_CloseCatalog(catalog);
+    CHECK(system((std::string("rm -r ") + sTempDir).c_str()) == 0);
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include "bench.h"
+#include "test.h"
+
+#include <cstring>
+#include <ctime>
+
+// A stream of messages of which 90% are dropped as repeats, formatted eagerly with snprintf (and dropped by the
+// caller) and deferred with NotificationModule_AddInfoNotificationDeferred (and dropped by the library).
+
+#define NUM_ROUNDS          1000
+#define MESSAGES_PER_ROUND  32
+#define REPEATS_PER_MESSAGE 10
+
+#define MESSAGE_FORMAT        "Controller %u disconnected (error %08x, retry in %.1f s)"
+#define MESSAGE_ARGS(message) (message) % 4, (message), 0.5f * (float) ((message) % 7)
+
+// Includes the time the scheduler thread spends on formatting and adding the deferred notifications.
+static uint64_t ProcessCpuTimeInNs() {
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+// Each message is sent REPEATS_PER_MESSAGE times in a row, e.g. by several call sites that report the same failure.
+// A round fits into the records of the deferred notifications and is shown before the next one starts. Waiting for
+// it doesn't take any CPU time.
+template<typename Op>
+static void BenchStream(const char *name, Op op) {
+    // The library sees that the overlay is empty again after StandIn_FadeOutAll(), so it doesn't throttle the flushes.
+    StandInConfig config;
+    config.exports = STAND_IN_EXPORT_QUEUE_INFO;
+    InitLibrary(config);
+    char lastText[128];
+    uint64_t start = ProcessCpuTimeInNs();
+    for (uint32_t round = 0; round < NUM_ROUNDS; round++) {
+        for (uint32_t i = 0; i < MESSAGES_PER_ROUND * REPEATS_PER_MESSAGE; i++) {
+            op(round * MESSAGES_PER_ROUND + i / REPEATS_PER_MESSAGE);
+        }
+        // Deferred notifications are added in order, the round is done once its last message is shown.
+        snprintf(lastText, sizeof(lastText), MESSAGE_FORMAT, MESSAGE_ARGS((round + 1) * MESSAGES_PER_ROUND - 1));
+        CHECK(WaitUntil([&lastText]() { return StandIn_FindNotification(lastText, nullptr); }));
+        StandIn_FadeOutAll();
+    }
+    NotificationModule_DeInitLibrary();
+    uint64_t total = ProcessCpuTimeInNs() - start;
+
+    uint32_t count = NUM_ROUNDS * MESSAGES_PER_ROUND * REPEATS_PER_MESSAGE;
+    uint32_t shown = StandIn_GetStats().addCalls;
+    printf("%-48s %10.0f ops/s  %8.1f ns/op (cpu)  %4.1f%% dropped\n",
+           name,
+           (double) count * 1e9 / (double) total,
+           (double) total / (double) count,
+           100.0 * (double) (count - shown) / (double) count);
+}
+
+int main() {
+    printf("bench_deferred\n");
+    char lastText[128] = {};
+    BenchStream("snprintf + AddInfoNotification, drop repeats", [&lastText](uint32_t message) {
+        char text[128];
+        snprintf(text, sizeof(text), MESSAGE_FORMAT, MESSAGE_ARGS(message));
+        if (strcmp(text, lastText) == 0) {
+            return;
+        }
+        strcpy(lastText, text);
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddInfoNotification(text));
+    });
+    BenchStream("AddInfoNotificationDeferred", [](uint32_t message) {
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddInfoNotificationDeferred(MESSAGE_FORMAT, MESSAGE_ARGS(message)));
+    });
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include "bench.h"
+#include "test.h"
+
+// Adding notifications with a description (NotificationModule_AddNotification) and with the scalar argument
+// functions, against a module with NMAddNotification and a module that only has the V2 exports.
+
+#define NUM_BATCHES 2000
+#define BATCH_SIZE  100
+
+static const char *sTexts[] = {"Failed to connect to the server", "Saved"};
+
+// Only the adds are timed, the notifications are faded out between the batches.
+template<typename Op>
+static void BenchAdds(const char *name, Op op) {
+    StandIn_ResetStats();
+    uint64_t total = 0;
+    for (uint32_t batch = 0; batch < NUM_BATCHES; batch++) {
+        uint64_t start = BenchNowInNs();
+        for (uint32_t i = 0; i < BATCH_SIZE; i++) {
+            CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, op(i));
+        }
+        total += BenchNowInNs() - start;
+        StandIn_FadeOutAll();
+    }
+    uint32_t count = NUM_BATCHES * BATCH_SIZE;
+    printf("%-48s %10.0f ops/s  %8.1f ns/op  %4.1f module calls per add\n",
+           name,
+           (double) count * 1e9 / (double) total,
+           (double) total / (double) count,
+           (double) StandIn_GetStats().moduleCalls / (double) count);
+}
+
+static void RunCase(const char *title, uint32_t exports) {
+    printf("%s\n", title);
+    StandInConfig config;
+    config.apiVersion = 2;
+    config.exports    = exports;
+    InitLibrary(config);
+
+    NMColor textColor       = {255, 255, 255, 255};
+    NMColor backgroundColor = {237, 28, 36, 255};
+    BenchAdds("  AddErrorNotificationEx (scalar arguments)", [&](uint32_t i) {
+        return NotificationModule_AddErrorNotificationEx(sTexts[i % 2], 2.0f, 0.5f, textColor, backgroundColor, nullptr, nullptr, true);
+    });
+    NMNotificationDesc desc;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_InitNotificationDesc(NOTIFICATION_MODULE_NOTIFICATION_TYPE_ERROR, &desc));
+    desc.durationBeforeFadeOutInSeconds = 2.0f;
+    desc.shakeDurationInSeconds         = 0.5f;
+    desc.textColor                      = textColor;
+    desc.backgroundColor                = backgroundColor;
+    desc.keepUntilShown                 = true;
+    BenchAdds("  AddNotification (description)", [&desc](uint32_t i) {
+        desc.text = sTexts[i % 2];
+        return NotificationModule_AddNotification(&desc, nullptr);
+    });
+    NotificationModule_DeInitLibrary();
+}
+
+int main() {
+    printf("bench_desc\n");
+    RunCase("module with NMAddNotification", STAND_IN_EXPORT_V2 | STAND_IN_EXPORT_ADD_NOTIFICATION);
+    RunCase("module with the V2 exports only (scalar fallback)", STAND_IN_EXPORT_V2);
+    return 0;
+}
@@ -0,0 +1,52 @@
+#include "bench.h"
+#include "handle_table.h"
+#include "test.h"
+
+// Resolving handles in the client side handle table, and updates on live and stale handles.
+
+#define NUM_HANDLES    256
+#define NUM_OPERATIONS 1000000
+
+int main() {
+    printf("bench_handle_table\n");
+    StandInConfig config;
+    config.fadeOutImmediately = true;
+    InitLibrary(config);
+
+    NotificationModuleHandle live[NUM_HANDLES];
+    NotificationModuleHandle stale[NUM_HANDLES];
+    for (auto &handle : stale) {
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotification("stale", &handle));
+    }
+    for (auto handle : stale) {
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_FinishDynamicNotification(handle, 0.0f));
+    }
+    // Reuses the slots of the stale handles, so misses are caught by the generation.
+    for (auto &handle : live) {
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotification("live", &handle));
+    }
+
+    NotificationModuleHandle moduleHandle;
+    uint64_t checksum = 0;
+    BenchLoop("HandleTable_Resolve, hit", NUM_OPERATIONS, [&](uint32_t i) {
+        checksum += HandleTable_Resolve(live[(i * 7) % NUM_HANDLES], &moduleHandle);
+    });
+    BenchLoop("HandleTable_Resolve, miss (stale generation)", NUM_OPERATIONS, [&](uint32_t i) {
+        checksum += HandleTable_Resolve(stale[(i * 7) % NUM_HANDLES], &moduleHandle);
+    });
+    BenchLoop("HandleTable_Resolve, miss (unknown slot)", NUM_OPERATIONS, [&](uint32_t i) {
+        checksum += HandleTable_Resolve(0x10000 | (NUM_HANDLES + i % 1000), &moduleHandle);
+    });
+
+    const char *texts[] = {"Downloading", "Installing"};
+    BenchLoop("update text, live handle (module call)", NUM_OPERATIONS / 10, [&](uint32_t i) {
+        checksum += NotificationModule_UpdateDynamicNotificationText(live[i % NUM_HANDLES], texts[(i / NUM_HANDLES) % 2]);
+    });
+    BenchLoop("update text, stale handle (rejected locally)", NUM_OPERATIONS / 10, [&](uint32_t i) {
+        checksum += NotificationModule_UpdateDynamicNotificationText(stale[i % NUM_HANDLES], texts[(i / NUM_HANDLES) % 2]);
+    });
+    printf("(checksum %llx, %u module update calls)\n", (unsigned long long) checksum, StandIn_GetStats().updateCalls);
+
+    NotificationModule_DeInitLibrary();
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include "bench.h"
+#include "test.h"
+
+// Adding and updating notifications with fixed texts, passed as strings and as interned text ids, with and without
+// the shared text exports of the module.
+
+#define NUM_BATCHES 2000
+#define BATCH_SIZE  100
+
+static const char *sTexts[] = {"Saved", "Connection failed!"};
+
+// Only the adds are timed, the notifications are faded out between the batches.
+template<typename Op>
+static void BenchAdds(const char *name, Op op) {
+    StandIn_ResetStats();
+    uint64_t total = 0;
+    for (uint32_t batch = 0; batch < NUM_BATCHES; batch++) {
+        uint64_t start = BenchNowInNs();
+        for (uint32_t i = 0; i < BATCH_SIZE; i++) {
+            CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, op(i));
+        }
+        total += BenchNowInNs() - start;
+        StandIn_FadeOutAll();
+    }
+    uint32_t count = NUM_BATCHES * BATCH_SIZE;
+    printf("%-48s %10.0f ops/s  %8.1f ns/op  %5.1f bytes copied by the module per call\n",
+           name,
+           (double) count * 1e9 / (double) total,
+           (double) total / (double) count,
+           (double) StandIn_GetStats().bytesCopied / (double) count);
+}
+
+template<typename Op>
+static void BenchUpdates(const char *name, NotificationModuleHandle handle, Op op) {
+    StandIn_ResetStats();
+    uint32_t count = NUM_BATCHES * BATCH_SIZE;
+    uint64_t start = BenchNowInNs();
+    for (uint32_t i = 0; i < count; i++) {
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, op(handle, i));
+    }
+    uint64_t total = BenchNowInNs() - start;
+    printf("%-48s %10.0f ops/s  %8.1f ns/op  %5.1f bytes copied by the module per call\n",
+           name,
+           (double) count * 1e9 / (double) total,
+           (double) total / (double) count,
+           (double) StandIn_GetStats().bytesCopied / (double) count);
+}
+
+static void RunCase(const char *title, uint32_t exports) {
+    printf("%s\n", title);
+    StandInConfig config;
+    config.exports = exports;
+    InitLibrary(config);
+    NotificationModuleTextId ids[2];
+    for (uint32_t i = 0; i < 2; i++) {
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_InternText(sTexts[i], &ids[i]));
+    }
+
+    BenchAdds("  add info, text", [](uint32_t i) { return NotificationModule_AddInfoNotification(sTexts[i % 2]); });
+    BenchAdds("  add info, interned id", [&ids](uint32_t i) { return NotificationModule_AddInfoNotificationInterned(ids[i % 2]); });
+
+    NotificationModuleHandle handle;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotification("Dynamic", &handle));
+    BenchUpdates("  update text, text", handle, [](NotificationModuleHandle handle, uint32_t i) {
+        return NotificationModule_UpdateDynamicNotificationText(handle, sTexts[i % 2]);
+    });
+    BenchUpdates("  update text, interned id", handle, [&ids](NotificationModuleHandle handle, uint32_t i) {
+        return NotificationModule_UpdateDynamicNotificationTextInterned(handle, ids[i % 2]);
+    });
+    NotificationModule_FinishDynamicNotification(handle, 0.0f);
+    NotificationModule_DeInitLibrary();
+}
+
+int main() {
+    printf("bench_interned\n");
+    NotificationModuleTextId id;
+    BenchLoop("intern an already interned text", 1000000, [&id](uint32_t i) { NotificationModule_InternText(sTexts[i % 2], &id); });
+    RunCase("module with the shared text exports", STAND_IN_EXPORT_SHARED_TEXT);
+    RunCase("module without the shared text exports (copy fallback)", 0);
+    return 0;
+}
@@ -0,0 +1,164 @@
+#include "bench.h"
+#include "test.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+// Progress reported by worker threads, through progress channels and by updating the text directly.
+
+#define NUM_PRODUCERS          4
+#define NUM_PUBLISHES          10000000
+#define NUM_VALUES             4000
+#define PUBLISH_INTERVAL_IN_US 250
+#define SAMPLE_INTERVAL_IN_US  100
+
+// Every producer publishes from its own thread, the time per publish is measured by each of them.
+template<typename Op>
+static void BenchProducers(const char *name, uint32_t iterations, Op op) {
+    std::atomic<uint64_t> totalInNs{0};
+    std::vector<std::thread> threads;
+    uint64_t start = BenchNowInNs();
+    for (uint32_t producer = 0; producer < NUM_PRODUCERS; producer++) {
+        threads.emplace_back([&, producer]() {
+            uint64_t threadStart = BenchNowInNs();
+            for (uint32_t i = 0; i < iterations; i++) {
+                CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, op(producer, i));
+            }
+            totalInNs += BenchNowInNs() - threadStart;
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    uint64_t wallInNs = BenchNowInNs() - start;
+    printf("%-48s %10.0f ops/s  %8.1f ns/op per producer  %u module update calls\n",
+           name,
+           (double) NUM_PRODUCERS * iterations * 1e9 / (double) wallInNs,
+           (double) totalInNs / (double) (NUM_PRODUCERS * iterations),
+           StandIn_GetStats().updateCalls);
+}
+
+static void BenchProducerCost() {
+    printf("producer cost, %u producers\n", NUM_PRODUCERS);
+    InitLibrary();
+    NotificationModuleHandle handles[NUM_PRODUCERS];
+    NotificationModuleProgressChannel channels[NUM_PRODUCERS];
+    for (uint32_t i = 0; i < NUM_PRODUCERS; i++) {
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotification("0%", &handles[i]));
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_OpenProgressChannel(handles[i], NOTIFICATION_MODULE_TEMPLATE_ID_INVALID, &channels[i]));
+    }
+
+    StandIn_ResetStats();
+    BenchProducers("  NotificationModule_PublishProgress", NUM_PUBLISHES, [&channels](uint32_t producer, uint32_t i) {
+        return NotificationModule_PublishProgress(channels[producer], i % 101);
+    });
+    for (auto channel : channels) {
+        NotificationModule_CloseProgressChannel(channel);
+    }
+    // Lets the consumer send the last values and drop the channels before the module calls are counted again.
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    StandIn_ResetStats();
+    BenchProducers("  snprintf + UpdateDynamicNotificationText", NUM_PUBLISHES / 100, [&handles](uint32_t producer, uint32_t i) {
+        char text[16];
+        snprintf(text, sizeof(text), "%u%%", i % 101);
+        return NotificationModule_UpdateDynamicNotificationText(handles[producer], text);
+    });
+
+    for (auto handle : handles) {
+        NotificationModule_FinishDynamicNotification(handle, 0.0f);
+    }
+    NotificationModule_DeInitLibrary();
+}
+
+// Producers publish a new value every PUBLISH_INTERVAL_IN_US, the overlay is sampled every SAMPLE_INTERVAL_IN_US. The
+// latency is the time between publishing a value and the first sample that shows it, the age is the time since the
+// shown value has been replaced by a newer one (0 while it's the latest).
+static void BenchStaleness() {
+    printf("end-to-end, %u producers publishing every %u us\n", NUM_PRODUCERS, PUBLISH_INTERVAL_IN_US);
+    InitLibrary();
+    NotificationModuleHandle handles[NUM_PRODUCERS];
+    NotificationModuleProgressChannel channels[NUM_PRODUCERS];
+    NotificationModuleTemplateId templateIds[NUM_PRODUCERS];
+    char format[16];
+    for (uint32_t i = 0; i < NUM_PRODUCERS; i++) {
+        // The texts name the producer, the handles of the stand-in are not the ones of the library.
+        snprintf(format, sizeof(format), "%u:%%u", i);
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_RegisterTemplate(format, NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC, &templateIds[i]));
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotification("waiting", &handles[i]));
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_OpenProgressChannel(handles[i], templateIds[i], &channels[i]));
+    }
+    StandIn_ResetStats();
+
+    // Written before the value is published, so it's visible to everyone who sees the value in the overlay.
+    std::vector<std::vector<uint64_t>> publishedAt(NUM_PRODUCERS, std::vector<uint64_t>(NUM_VALUES));
+    std::atomic<uint32_t> publishedCounts[NUM_PRODUCERS] = {};
+    std::atomic<uint32_t> running{NUM_PRODUCERS};
+    std::vector<std::thread> threads;
+    uint64_t start = BenchNowInNs();
+    for (uint32_t producer = 0; producer < NUM_PRODUCERS; producer++) {
+        threads.emplace_back([&, producer]() {
+            for (uint32_t value = 0; value < NUM_VALUES; value++) {
+                publishedAt[producer][value] = BenchNowInNs();
+                CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_PublishProgress(channels[producer], value));
+                publishedCounts[producer] = value + 1;
+                std::this_thread::sleep_for(std::chrono::microseconds(PUBLISH_INTERVAL_IN_US));
+            }
+            running--;
+        });
+    }
+
+    LatencyRecorder latencies(NUM_PRODUCERS * NUM_VALUES);
+    LatencyRecorder ages;
+    std::vector<int64_t> lastSeen(NUM_PRODUCERS, -1);
+    uint32_t finalValuesSeen = 0;
+    while (running > 0 || finalValuesSeen < NUM_PRODUCERS) {
+        std::this_thread::sleep_for(std::chrono::microseconds(SAMPLE_INTERVAL_IN_US));
+        // Everything that is looked up below has been published before `now`.
+        auto notifications = StandIn_GetNotifications();
+        uint32_t publishedCountsNow[NUM_PRODUCERS];
+        for (uint32_t i = 0; i < NUM_PRODUCERS; i++) {
+            publishedCountsNow[i] = publishedCounts[i];
+        }
+        uint64_t now    = BenchNowInNs();
+        finalValuesSeen = 0;
+        for (const auto &cur : notifications) {
+            char *end;
+            uint32_t producer = strtoul(cur.text.c_str(), &end, 10);
+            if (*end != ':') {
+                continue;
+            }
+            auto value = (int64_t) strtoul(end + 1, nullptr, 10);
+            CHECK(producer < NUM_PRODUCERS && value < NUM_VALUES && value >= lastSeen[producer]);
+            if (value > lastSeen[producer]) {
+                latencies.Add(now - publishedAt[producer][value]);
+                lastSeen[producer] = value;
+            }
+            ages.Add((uint32_t) value + 1 < publishedCountsNow[producer] ? now - publishedAt[producer][value + 1] : 0);
+            if (value == NUM_VALUES - 1) {
+                finalValuesSeen++;
+            }
+        }
+    }
+    uint64_t total = BenchNowInNs() - start;
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    latencies.Print("  publish until shown", total);
+    ages.Print("  age of the shown value, per sample", total);
+    printf("  %u values published, %u module update calls\n", NUM_PRODUCERS * NUM_VALUES, StandIn_GetStats().updateCalls);
+
+    for (uint32_t i = 0; i < NUM_PRODUCERS; i++) {
+        NotificationModule_CloseProgressChannel(channels[i]);
+        NotificationModule_FinishDynamicNotification(handles[i], 0.0f);
+    }
+    NotificationModule_DeInitLibrary();
+}
+
+int main() {
+    printf("bench_progress_channels\n");
+    BenchProducerCost();
+    BenchStaleness();
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include "bench.h"
+#include "test.h"
+
+// Throughput and tail latency of adding notifications while the stand-in injects failures and slow calls, with the
+// retry policy of the library compared to returning the error and to a retry loop in the caller.
+
+#define NUM_NOTIFICATIONS 5000
+
+enum RetryMode {
+    RETRY_MODE_NONE,
+    RETRY_MODE_CALLER_LOOP,
+    RETRY_MODE_POLICY,
+};
+
+static void RunCase(const char *name, RetryMode mode, float failureRate, float slowCallRate) {
+    StandInConfig config;
+    config.addFailureRate      = failureRate;
+    config.callLatencyInUs     = 2;
+    config.slowCallRate        = slowCallRate;
+    config.slowCallLatencyInUs = 2000;
+    config.capacityInBytes     = 1 << 20;
+    InitLibrary(config);
+    if (mode == RETRY_MODE_POLICY) {
+        NMRetryPolicy policy = {16, 1, 16, 0.5f};
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_SetRetryPolicy(&policy));
+    }
+
+    LatencyRecorder latencies(NUM_NOTIFICATIONS);
+    uint32_t errors = 0;
+    uint64_t start  = BenchNowInNs();
+    for (uint32_t i = 0; i < NUM_NOTIFICATIONS; i++) {
+        uint64_t callStart = BenchNowInNs();
+        auto res           = NotificationModule_AddInfoNotification("Benchmark");
+        // What plugins do without the policy: try again after a short sleep until it works.
+        while (mode == RETRY_MODE_CALLER_LOOP && res != NOTIFICATION_MODULE_RESULT_SUCCESS) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            res = NotificationModule_AddInfoNotification("Benchmark");
+        }
+        latencies.Add(BenchNowInNs() - callStart);
+        if (res != NOTIFICATION_MODULE_RESULT_SUCCESS) {
+            errors++;
+        }
+    }
+    uint64_t callerDone = BenchNowInNs();
+    uint32_t expected   = NUM_NOTIFICATIONS - errors;
+    bool delivered      = WaitUntil([expected] { return StandIn_GetNotifications().size() >= expected; }, 60000);
+    uint64_t end        = BenchNowInNs();
+    uint32_t shown      = StandIn_GetNotifications().size();
+
+    latencies.Print(name, callerDone - start);
+    printf("%-48s errors %u, shown %u/%u%s, all shown after %.1f ms\n", "", errors, shown, NUM_NOTIFICATIONS, delivered ? "" : " (timed out)", (double) (end - start) / 1e6);
+    NotificationModule_DeInitLibrary();
+}
+
+int main() {
+    printf("bench_retry\n");
+    RunCase("no faults", RETRY_MODE_NONE, 0.0f, 0.0f);
+    RunCase("10% failures, errors returned", RETRY_MODE_NONE, 0.1f, 0.0f);
+    RunCase("10% failures, retry loop in caller", RETRY_MODE_CALLER_LOOP, 0.1f, 0.0f);
+    RunCase("10% failures, retry policy", RETRY_MODE_POLICY, 0.1f, 0.0f);
+    RunCase("30% failures, 1% slow calls, retry loop in caller", RETRY_MODE_CALLER_LOOP, 0.3f, 0.01f);
+    RunCase("30% failures, 1% slow calls, retry policy", RETRY_MODE_POLICY, 0.3f, 0.01f);
+    return 0;
+}
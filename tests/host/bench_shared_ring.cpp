@@ -0,0 +1,51 @@
+#include "bench.h"
+#include "test.h"
+
+// Latency of updating a dynamic notification while the overlay renders (and holds the module lock for a part of
+// every frame), with the exported functions compared to the shared ring.
+
+#define NUM_UPDATES    200000
+#define FRAME_IN_US    16667
+#define RENDER_IN_US   2000
+
+static void RunCase(const char *name, uint32_t exports) {
+    StandInConfig config;
+    config.exports = exports;
+    InitLibrary(config);
+    StandIn_StartRenderThread(FRAME_IN_US, RENDER_IN_US);
+
+    NotificationModuleHandle handle;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotification("Downloading", &handle));
+    StandIn_ResetStats();
+
+    LatencyRecorder latencies(NUM_UPDATES);
+    char text[64];
+    uint64_t start = BenchNowInNs();
+    for (uint32_t i = 0; i < NUM_UPDATES; i++) {
+        snprintf(text, sizeof(text), "Downloading file.bin: %u/%u", i, NUM_UPDATES);
+        uint64_t callStart = BenchNowInNs();
+        NotificationModule_UpdateDynamicNotificationText(handle, text);
+        latencies.Add(BenchNowInNs() - callStart);
+    }
+    uint64_t total = BenchNowInNs() - start;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_FinishDynamicNotification(handle, 0.0f));
+    StandIn_StopRenderThread();
+    StandIn_RunFrame();
+
+    auto stats = StandIn_GetStats();
+    latencies.Print(name, total);
+    printf("%-48s module calls %u, ring records %u, ring processed %u times, bytes copied by the module %llu\n",
+           "",
+           stats.moduleCalls,
+           stats.ringRecords,
+           stats.ringProcessCalls,
+           (unsigned long long) stats.bytesCopied);
+    NotificationModule_DeInitLibrary();
+}
+
+int main() {
+    printf("bench_shared_ring\n");
+    RunCase("exported functions", STAND_IN_EXPORT_UPDATE);
+    RunCase("shared ring", STAND_IN_EXPORT_UPDATE | STAND_IN_EXPORT_SHARED_RING);
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include "bench.h"
+#include "test.h"
+
+// Text updates of a progress notification: sent completely, skipped because the text didn't change and sent as a
+// splice of the changed part (NMSpliceDynamicNotificationText).
+
+#define NUM_UPDATES 200000
+
+#define PROGRESS_FORMAT "Herunterladen von „system_update.rpx“: %u%% (%u / 4096 KB)"
+
+template<typename Op>
+static void BenchUpdates(const char *name, uint32_t exports, Op op) {
+    StandInConfig config;
+    config.exports = exports;
+    InitLibrary(config);
+    NotificationModuleHandle handle;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotification("Herunterladen...", &handle));
+    char text[128];
+    StandIn_ResetStats();
+    uint64_t start = BenchNowInNs();
+    for (uint32_t i = 0; i < NUM_UPDATES; i++) {
+        op(text, sizeof(text), i);
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_UpdateDynamicNotificationText(handle, text));
+    }
+    uint64_t total = BenchNowInNs() - start;
+    auto stats     = StandIn_GetStats();
+    printf("%-48s %10.0f ops/s  %8.1f ns/op  %4.2f module calls  %5.1f bytes per update\n",
+           name,
+           (double) NUM_UPDATES * 1e9 / (double) total,
+           (double) total / (double) NUM_UPDATES,
+           (double) stats.moduleCalls / (double) NUM_UPDATES,
+           (double) stats.bytesCopied / (double) NUM_UPDATES);
+    NotificationModule_FinishDynamicNotification(handle, 0.0f);
+    NotificationModule_DeInitLibrary();
+}
+
+// A new value on every update, the text only changes in the numbers.
+static void FormatProgress(char *text, size_t size, uint32_t i) {
+    uint32_t kb = i % 4097;
+    snprintf(text, size, PROGRESS_FORMAT, kb * 100 / 4096, kb);
+}
+
+// The same value is reported repeatedly, e.g. polled from a download that is stalled.
+static void FormatStalledProgress(char *text, size_t size, uint32_t) {
+    snprintf(text, size, PROGRESS_FORMAT, 50, 2048);
+}
+
+int main() {
+    printf("bench_splice\n");
+    BenchUpdates("full text (module without splice)", 0, FormatProgress);
+    BenchUpdates("unchanged text (skipped)", 0, FormatStalledProgress);
+    BenchUpdates("splice", STAND_IN_EXPORT_SPLICE, FormatProgress);
+    BenchUpdates("unchanged text with splice (skipped)", STAND_IN_EXPORT_SPLICE, FormatStalledProgress);
+    return 0;
+}
@@ -0,0 +1,97 @@
+#include "bench.h"
+#include "templates.h"
+#include "test.h"
+
+// Registered templates against snprintf, for rendering only and for adding and updating notifications.
+
+#define NUM_RENDERS 1000000
+#define NUM_BATCHES 2000
+#define BATCH_SIZE  100
+
+static const char *sNames[] = {"Mario Kart 8 Deluxe.wua", "update.rpx", "Splatoon 3 - Side Order (DLC).wua"};
+
+// Only the adds are timed, the notifications are faded out between the batches.
+template<typename Op>
+static void BenchAdds(const char *name, Op op) {
+    uint64_t total = 0;
+    for (uint32_t batch = 0; batch < NUM_BATCHES; batch++) {
+        uint64_t start = BenchNowInNs();
+        for (uint32_t i = 0; i < BATCH_SIZE; i++) {
+            CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, op(batch * BATCH_SIZE + i));
+        }
+        total += BenchNowInNs() - start;
+        StandIn_FadeOutAll();
+    }
+    uint32_t count = NUM_BATCHES * BATCH_SIZE;
+    printf("%-48s %10.0f ops/s  %8.1f ns/op\n", name, (double) count * 1e9 / (double) total, (double) total / (double) count);
+}
+
+int main() {
+    printf("bench_templates\n");
+    InitLibrary();
+
+    NotificationModuleTemplateId downloaded, progress, speed;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_RegisterTemplate("Downloaded %s (%u KB)", NOTIFICATION_MODULE_NOTIFICATION_TYPE_INFO, &downloaded));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_RegisterTemplate("Installing... %u%%", NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC, &progress));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_RegisterTemplate("%s: %.1f MB/s, %d s left", NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC, &speed));
+
+    char text[NOTIFICATION_TEMPLATE_MAX_TEXT_LENGTH];
+    uint64_t checksum = 0;
+    NotificationModuleNotificationType profile;
+    NMTemplateArg args[3];
+
+    printf("rendering only\n");
+    BenchLoop("  snprintf \"Downloaded %s (%u KB)\"", NUM_RENDERS, [&](uint32_t i) {
+        checksum += snprintf(text, sizeof(text), "Downloaded %s (%u KB)", sNames[i % 3], i);
+    });
+    BenchLoop("  template \"Downloaded %s (%u KB)\"", NUM_RENDERS, [&](uint32_t i) {
+        args[0].type      = NOTIFICATION_MODULE_TEMPLATE_ARG_TYPE_STRING;
+        args[0].value.str = sNames[i % 3];
+        args[1].type      = NOTIFICATION_MODULE_TEMPLATE_ARG_TYPE_UINT;
+        args[1].value.u32 = i;
+        checksum += Templates_Render(downloaded, args, 2, text, sizeof(text), &profile);
+    });
+    BenchLoop("  snprintf \"%s: %.1f MB/s, %d s left\"", NUM_RENDERS, [&](uint32_t i) {
+        checksum += snprintf(text, sizeof(text), "%s: %.1f MB/s, %d s left", sNames[i % 3], (float) (i % 1000) * 0.1f, (int32_t) (i % 600));
+    });
+    BenchLoop("  template \"%s: %.1f MB/s, %d s left\"", NUM_RENDERS, [&](uint32_t i) {
+        args[0].type      = NOTIFICATION_MODULE_TEMPLATE_ARG_TYPE_STRING;
+        args[0].value.str = sNames[i % 3];
+        args[1].type      = NOTIFICATION_MODULE_TEMPLATE_ARG_TYPE_FLOAT;
+        args[1].value.f   = (float) (i % 1000) * 0.1f;
+        args[2].type      = NOTIFICATION_MODULE_TEMPLATE_ARG_TYPE_INT;
+        args[2].value.i32 = (int32_t) (i % 600);
+        checksum += Templates_Render(speed, args, 3, text, sizeof(text), &profile);
+    });
+
+    printf("adding static notifications\n");
+    BenchAdds("  snprintf + AddInfoNotification", [&](uint32_t i) {
+        snprintf(text, sizeof(text), "Downloaded %s (%u KB)", sNames[i % 3], i);
+        return NotificationModule_AddInfoNotification(text);
+    });
+    BenchAdds("  AddTemplateNotification", [&](uint32_t i) {
+        args[0].type      = NOTIFICATION_MODULE_TEMPLATE_ARG_TYPE_STRING;
+        args[0].value.str = sNames[i % 3];
+        args[1].type      = NOTIFICATION_MODULE_TEMPLATE_ARG_TYPE_UINT;
+        args[1].value.u32 = i;
+        return NotificationModule_AddTemplateNotification(downloaded, args, 2);
+    });
+
+    printf("updating a dynamic notification\n");
+    NotificationModuleHandle handle;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotification("Installing...", &handle));
+    BenchLoop("  snprintf + UpdateDynamicNotificationText", NUM_RENDERS / 10, [&](uint32_t i) {
+        snprintf(text, sizeof(text), "Installing... %u%%", i % 101);
+        checksum += NotificationModule_UpdateDynamicNotificationText(handle, text);
+    });
+    BenchLoop("  UpdateDynamicNotificationTextFromTemplate", NUM_RENDERS / 10, [&](uint32_t i) {
+        args[0].type      = NOTIFICATION_MODULE_TEMPLATE_ARG_TYPE_UINT;
+        args[0].value.u32 = i % 101;
+        checksum += NotificationModule_UpdateDynamicNotificationTextFromTemplate(handle, progress, args, 1);
+    });
+    NotificationModule_FinishDynamicNotification(handle, 0.0f);
+    printf("(checksum %llx)\n", (unsigned long long) checksum);
+
+    NotificationModule_DeInitLibrary();
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include "bench.h"
+#include "test.h"
+#include "text_sanitizer.h"
+
+#include <cstring>
+#include <string>
+
+// Throughput of SanitizedText for texts that pass through unchanged and for texts that have to be copied.
+
+#define TOTAL_BYTES (256u * 1024 * 1024)
+
+// Checks the text one byte at a time, without the range checks of the sanitizer. A baseline for the
+// word-at-a-time ASCII fast path.
+static bool IsValidUtf8ByteWise(const char *text) {
+    auto cur = (const uint8_t *) text;
+    while (*cur != 0) {
+        uint32_t length = *cur < 0x80 ? 1 : (*cur & 0xE0) == 0xC0 ? 2
+                                    : (*cur & 0xF0) == 0xE0       ? 3
+                                    : (*cur & 0xF8) == 0xF0       ? 4
+                                                                  : 0;
+        if (length == 0) {
+            return false;
+        }
+        for (uint32_t i = 1; i < length; i++) {
+            if ((cur[i] & 0xC0) != 0x80) {
+                return false;
+            }
+        }
+        cur += length;
+    }
+    return true;
+}
+
+// Runs `op` on `text` until TOTAL_BYTES were processed and prints MB/s.
+template<typename Op>
+static void BenchThroughput(const char *name, const std::string &text, Op op) {
+    uint32_t iterations = TOTAL_BYTES / text.size();
+    uint64_t checksum   = 0;
+    uint64_t start      = BenchNowInNs();
+    for (uint32_t i = 0; i < iterations; i++) {
+        const char *cur = text.c_str();
+        // Hides that the text is the same in every iteration, otherwise the check is hoisted out of the loop.
+        asm volatile("" : "+r"(cur));
+        checksum += op(cur);
+    }
+    uint64_t total = BenchNowInNs() - start;
+    printf("%-48s %10.1f MB/s  %8.1f ns/text  (checksum %llx)\n",
+           name,
+           (double) iterations * (double) text.size() * 1e3 / (double) total,
+           (double) total / (double) iterations,
+           (unsigned long long) checksum);
+}
+
+static uint64_t Sanitize(const char *text) {
+    SanitizedText sanitized(text);
+    return (uint8_t) sanitized.c_str()[0];
+}
+
+static std::string Repeat(const char *piece, size_t size) {
+    std::string text;
+    while (text.size() + strlen(piece) <= size) {
+        text += piece;
+    }
+    return text;
+}
+
+int main() {
+    printf("bench_text_sanitizer\n");
+    auto shortAscii = Repeat("Saved!", 48);
+    auto ascii      = Repeat("File saved successfully. ", 4096);
+    auto mixed      = Repeat("Gespeichert: \xC3\xA4\xC3\xB6\xC3\xBC \xE2\x9C\x93 \xF0\x9D\x84\x9E ", 4096);
+    auto invalid    = Repeat("Broken \xFF text \xE2\x9C ", 4096);
+
+    TextSanitizer_SetMaxLength(0);
+    BenchThroughput("ASCII, 48 bytes", shortAscii, Sanitize);
+    BenchThroughput("ASCII, 4 KiB", ascii, Sanitize);
+    BenchThroughput("ASCII, 4 KiB, byte-wise validation", ascii, IsValidUtf8ByteWise);
+    BenchThroughput("mixed UTF-8, 4 KiB", mixed, Sanitize);
+    BenchThroughput("mixed UTF-8, 4 KiB, byte-wise validation", mixed, IsValidUtf8ByteWise);
+    BenchThroughput("invalid UTF-8, 4 KiB (copied)", invalid, Sanitize);
+
+    TextSanitizer_SetMaxLength(64);
+    BenchThroughput("ASCII, 4 KiB, truncated to 64", ascii, Sanitize);
+    BenchThroughput("mixed UTF-8, 4 KiB, truncated to 64", mixed, Sanitize);
+    TextSanitizer_SetMaxLength(0);
+    return 0;
+}
@@ -0,0 +1,66 @@
+#include "bench.h"
+#include "test.h"
+
+// Switching a dynamic notification between two states (text, text color and background color) with the three single
+// attribute updates and with NotificationModule_UpdateDynamicNotification(), with and without the module export.
+
+#define NUM_UPDATES 200000
+
+static const NMDynamicUpdate sStates[] = {
+        {"Downloading...", {255, 255, 255, 255}, {100, 100, 100, 255}},
+        {"Download failed", {255, 255, 255, 255}, {237, 28, 36, 255}},
+};
+
+template<typename Op>
+static void BenchUpdates(const char *name, uint32_t iterations, Op op) {
+    NotificationModuleHandle handle;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotification("Downloading...", &handle));
+    StandIn_ResetStats();
+    uint64_t start = BenchNowInNs();
+    for (uint32_t i = 0; i < iterations; i++) {
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, op(handle, sStates[i % 2]));
+    }
+    uint64_t total = BenchNowInNs() - start;
+    printf("%-48s %10.0f ops/s  %8.1f ns/op  %4.1f module calls per update\n",
+           name,
+           (double) iterations * 1e9 / (double) total,
+           (double) total / (double) iterations,
+           (double) StandIn_GetStats().moduleCalls / (double) iterations);
+    NotificationModule_FinishDynamicNotification(handle, 0.0f);
+}
+
+static NotificationModuleStatus UpdateOneByOne(NotificationModuleHandle handle, const NMDynamicUpdate &state) {
+    NotificationModuleStatus res;
+    if ((res = NotificationModule_UpdateDynamicNotificationText(handle, state.text)) != NOTIFICATION_MODULE_RESULT_SUCCESS) {
+        return res;
+    }
+    if ((res = NotificationModule_UpdateDynamicNotificationTextColor(handle, state.textColor)) != NOTIFICATION_MODULE_RESULT_SUCCESS) {
+        return res;
+    }
+    return NotificationModule_UpdateDynamicNotificationBackgroundColor(handle, state.backgroundColor);
+}
+
+static NotificationModuleStatus UpdateAtOnce(NotificationModuleHandle handle, const NMDynamicUpdate &state) {
+    return NotificationModule_UpdateDynamicNotification(handle, &state, NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_ALL);
+}
+
+static void RunCase(const char *title, uint32_t exports, uint32_t callLatencyInUs) {
+    printf("%s\n", title);
+    StandInConfig config;
+    config.exports         = exports;
+    config.callLatencyInUs = callLatencyInUs;
+    InitLibrary(config);
+    // Every call sleeps with a latency, fewer iterations keep the run short.
+    uint32_t iterations = callLatencyInUs > 0 ? NUM_UPDATES / 200 : NUM_UPDATES;
+    BenchUpdates("  three single attribute updates", iterations, UpdateOneByOne);
+    BenchUpdates("  UpdateDynamicNotification", iterations, UpdateAtOnce);
+    NotificationModule_DeInitLibrary();
+}
+
+int main() {
+    printf("bench_update\n");
+    RunCase("module with NMUpdateDynamicNotification", STAND_IN_EXPORT_UPDATE, 0);
+    RunCase("module without NMUpdateDynamicNotification (fallback)", 0, 0);
+    RunCase("module with NMUpdateDynamicNotification, 20 us per module call", STAND_IN_EXPORT_UPDATE, 20);
+    return 0;
+}
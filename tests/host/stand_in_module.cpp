@@ -0,0 +1,833 @@
+#include "stand_in_module.h"
+#include "shared_ring.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <coreinit/debug.h>
+#include <coreinit/dynload.h>
+#include <coreinit/time.h>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+struct StandInEntry {
+    StandInNotification info;
+    NotificationModuleNotificationFinishedCallback callback = nullptr;
+    void *callbackContext                                   = nullptr;
+    float durationBeforeFadeOutInSeconds                    = 0.0f;
+    float shakeDurationInSeconds                            = 0.0f;
+    // Set once the notification is visible and static or finished, 0 otherwise.
+    uint64_t fadeOutAtInUs = 0;
+};
+
+struct PendingCallback {
+    NotificationModuleNotificationFinishedCallback callback;
+    NotificationModuleHandle handle;
+    void *context;
+};
+
+// Guards everything below except the clock and the ring (which is guarded by sRingConsumerMutex).
+static std::mutex sMutex;
+static StandInConfig sConfig;
+static std::vector<StandInEntry> sEntries;
+static NotificationModuleHandle sNextHandle = 0x100;
+static StandInStats sStats;
+static uint32_t sRandomState = 1;
+
+// Copy of StandInConfig::manualClock, OSGetSystemTime() is called without holding sMutex.
+static std::atomic<bool> sManualClock{false};
+static std::atomic<uint64_t> sManualTimeInUs{1000000};
+
+// Serializes the consumers of the ring, it's never held while finish callbacks are called.
+static std::mutex sRingConsumerMutex;
+static SharedRingHeader *sRing = nullptr;
+
+static std::thread sRenderThread;
+static std::atomic<bool> sRenderThreadStop{false};
+
+static uint64_t NowInUs() {
+    if (sManualClock) {
+        return sManualTimeInUs.load();
+    }
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void BusyWait(uint32_t microseconds) {
+    auto end = std::chrono::steady_clock::now() + std::chrono::microseconds(microseconds);
+    while (std::chrono::steady_clock::now() < end) {
+    }
+}
+
+// xorshift32, returns a value in [0.0, 1.0). Has to be called while holding sMutex.
+static float NextRandom() {
+    sRandomState ^= sRandomState << 13;
+    sRandomState ^= sRandomState >> 17;
+    sRandomState ^= sRandomState << 5;
+    return (float) (sRandomState >> 8) / (float) (1 << 24);
+}
+
+/**
+ * Called at the start of every export. The injected latency is spent without holding sMutex, so calls from
+ * several threads overlap like they would on the console.
+ */
+static void SimulateCall() {
+    uint32_t latencyInUs;
+    {
+        std::lock_guard<std::mutex> lock(sMutex);
+        sStats.moduleCalls++;
+        latencyInUs = sConfig.callLatencyInUs;
+        if (sConfig.slowCallRate > 0.0f && NextRandom() < sConfig.slowCallRate) {
+            latencyInUs = sConfig.slowCallLatencyInUs;
+        }
+    }
+    if (latencyInUs > 0) {
+        BusyWait(latencyInUs);
+    }
+}
+
+static void CallCallbacks(const std::vector<PendingCallback> &callbacks) {
+    for (const auto &cur : callbacks) {
+        cur.callback(cur.handle, cur.context);
+    }
+    if (!callbacks.empty()) {
+        std::lock_guard<std::mutex> lock(sMutex);
+        sStats.callbacksCalled += callbacks.size();
+    }
+}
+
+// Has to be called while holding sMutex.
+static uint32_t GetBytesUsed() {
+    uint32_t bytesUsed = 0;
+    for (const auto &cur : sEntries) {
+        bytesUsed += cur.info.text.size() + 1;
+    }
+    return bytesUsed;
+}
+
+// Has to be called while holding sMutex.
+static StandInEntry *FindEntry(NotificationModuleHandle handle) {
+    for (auto &cur : sEntries) {
+        if (cur.info.handle == handle) {
+            return &cur;
+        }
+    }
+    return nullptr;
+}
+
+// Has to be called while holding sMutex. Returns nullptr for unknown and finished notifications.
+static StandInEntry *FindDynamicEntry(NotificationModuleHandle handle) {
+    auto *entry = FindEntry(handle);
+    if (entry == nullptr || entry->info.finished || entry->info.type != NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC) {
+        sStats.invalidHandles++;
+        return nullptr;
+    }
+    return entry;
+}
+
+// Has to be called while holding sMutex.
+static void StartFadeOut(StandInEntry &entry, uint64_t nowInUs) {
+    entry.fadeOutAtInUs = nowInUs + (uint64_t) ((entry.durationBeforeFadeOutInSeconds + entry.shakeDurationInSeconds) * 1000000.0f) + 1;
+}
+
+// Has to be called while holding sMutex. The callback is added to `callbacks`.
+static void RemoveEntry(std::vector<StandInEntry>::iterator it, std::vector<PendingCallback> &callbacks) {
+    if (it->callback != nullptr) {
+        callbacks.push_back({it->callback, it->info.handle, it->callbackContext});
+    }
+    sEntries.erase(it);
+}
+
+// Has to be called while holding sMutex.
+static bool FinishEntry(NotificationModuleHandle handle,
+                        NotificationModuleStatusFinish finishMode,
+                        float durationBeforeFadeOutInSeconds,
+                        float shakeDurationInSeconds,
+                        std::vector<PendingCallback> &callbacks) {
+    sStats.finishCalls++;
+    auto *entry = FindDynamicEntry(handle);
+    if (entry == nullptr) {
+        return false;
+    }
+    entry->info.finished                  = true;
+    entry->durationBeforeFadeOutInSeconds = durationBeforeFadeOutInSeconds;
+    entry->shakeDurationInSeconds         = finishMode == NOTIFICATION_MODULE_STATUS_FINISH_WITH_SHAKE ? shakeDurationInSeconds : 0.0f;
+    if (sConfig.fadeOutImmediately && durationBeforeFadeOutInSeconds == 0.0f) {
+        RemoveEntry(sEntries.begin() + (entry - sEntries.data()), callbacks);
+        return true;
+    }
+    if (entry->info.visible) {
+        StartFadeOut(*entry, NowInUs());
+    }
+    return true;
+}
+
+// Has to be called while holding sMutex.
+static void ApplyUpdate(StandInEntry &entry, const char *text, uint32_t textLength, NMColor textColor, NMColor backgroundColor, uint32_t fieldMask) {
+    if ((fieldMask & NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_TEXT) != 0) {
+        entry.info.text.assign(text, textLength);
+    }
+    if ((fieldMask & NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_TEXT_COLOR) != 0) {
+        entry.info.textColor = textColor;
+    }
+    if ((fieldMask & NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_BACKGROUND_COLOR) != 0) {
+        entry.info.backgroundColor = backgroundColor;
+    }
+}
+
+static NotificationModuleStatus Add(const char *text,
+                                    uint32_t textLength,
+                                    bool copyText,
+                                    NotificationModuleNotificationType type,
+                                    float durationBeforeFadeOutInSeconds,
+                                    float shakeDurationInSeconds,
+                                    NMColor textColor,
+                                    NMColor backgroundColor,
+                                    NotificationModuleNotificationFinishedCallback callback,
+                                    void *callbackContext,
+                                    bool keepUntilShown,
+                                    NotificationModuleHandle *outHandle) {
+    SimulateCall();
+    if (text == nullptr || type < NOTIFICATION_MODULE_NOTIFICATION_TYPE_INFO || type > NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    std::lock_guard<std::mutex> lock(sMutex);
+    sStats.addCalls++;
+    if (sConfig.addFailureRate > 0.0f && NextRandom() < sConfig.addFailureRate) {
+        sStats.injectedFailures++;
+        return sConfig.addFailureStatus;
+    }
+    if (GetBytesUsed() + textLength + 1 > sConfig.capacityInBytes) {
+        return NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED;
+    }
+    if (copyText) {
+        sStats.bytesCopied += textLength + 1;
+    }
+
+    StandInEntry entry;
+    entry.info.handle                    = sNextHandle++;
+    entry.info.type                      = type;
+    entry.info.text                      = std::string(text, textLength);
+    entry.info.textColor                 = textColor;
+    entry.info.backgroundColor           = backgroundColor;
+    entry.info.keepUntilShown            = keepUntilShown;
+    entry.info.visible                   = sConfig.overlayReady;
+    entry.info.finished                  = false;
+    entry.info.hasCallback               = callback != nullptr;
+    entry.callback                       = callback;
+    entry.callbackContext                = callbackContext;
+    entry.durationBeforeFadeOutInSeconds = durationBeforeFadeOutInSeconds;
+    entry.shakeDurationInSeconds         = type == NOTIFICATION_MODULE_NOTIFICATION_TYPE_ERROR ? shakeDurationInSeconds : 0.0f;
+    if (entry.info.visible && type != NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC) {
+        StartFadeOut(entry, NowInUs());
+    }
+    sEntries.push_back(entry);
+    if (outHandle != nullptr) {
+        *outHandle = entry.info.handle;
+    }
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+static NotificationModuleStatus NMGetVersion(NotificationModuleAPIVersion *outVersion) {
+    if (outVersion == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    std::lock_guard<std::mutex> lock(sMutex);
+    *outVersion = sConfig.apiVersion;
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+static NotificationModuleStatus NMIsOverlayReady(bool *outIsReady) {
+    SimulateCall();
+    if (outIsReady == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    std::lock_guard<std::mutex> lock(sMutex);
+    *outIsReady = sConfig.overlayReady;
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+static NotificationModuleStatus NMAddStaticNotification(const char *text,
+                                                        NotificationModuleNotificationType type,
+                                                        float durationBeforeFadeOutInSeconds,
+                                                        float shakeDurationInSeconds,
+                                                        NMColor textColor,
+                                                        NMColor backgroundColor,
+                                                        NotificationModuleNotificationFinishedCallback callback,
+                                                        void *callbackContext) {
+    if (type == NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC) {
+        return NOTIFICATION_MODULE_RESULT_UNSUPPORTED_TYPE;
+    }
+    return Add(text, text ? strlen(text) : 0, true, type, durationBeforeFadeOutInSeconds, shakeDurationInSeconds, textColor, backgroundColor, callback, callbackContext, false, nullptr);
+}
+
+static NotificationModuleStatus NMAddStaticNotificationV2(const char *text,
+                                                          NotificationModuleNotificationType type,
+                                                          float durationBeforeFadeOutInSeconds,
+                                                          float shakeDurationInSeconds,
+                                                          NMColor textColor,
+                                                          NMColor backgroundColor,
+                                                          NotificationModuleNotificationFinishedCallback callback,
+                                                          void *callbackContext,
+                                                          bool keepUntilShown) {
+    if (type == NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC) {
+        return NOTIFICATION_MODULE_RESULT_UNSUPPORTED_TYPE;
+    }
+    return Add(text, text ? strlen(text) : 0, true, type, durationBeforeFadeOutInSeconds, shakeDurationInSeconds, textColor, backgroundColor, callback, callbackContext, keepUntilShown, nullptr);
+}
+
+static NotificationModuleStatus NMAddStaticNotificationShared(const char *text,
+                                                              uint32_t textLength,
+                                                              NotificationModuleNotificationType type,
+                                                              float durationBeforeFadeOutInSeconds,
+                                                              float shakeDurationInSeconds,
+                                                              NMColor textColor,
+                                                              NMColor backgroundColor,
+                                                              NotificationModuleNotificationFinishedCallback callback,
+                                                              void *callbackContext,
+                                                              bool keepUntilShown) {
+    if (type == NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC) {
+        return NOTIFICATION_MODULE_RESULT_UNSUPPORTED_TYPE;
+    }
+    return Add(text, textLength, false, type, durationBeforeFadeOutInSeconds, shakeDurationInSeconds, textColor, backgroundColor, callback, callbackContext, keepUntilShown, nullptr);
+}
+
+static NotificationModuleStatus NMAddDynamicNotification(const char *text,
+                                                         NMColor textColor,
+                                                         NMColor backgroundColor,
+                                                         NotificationModuleNotificationFinishedCallback callback,
+                                                         void *callbackContext,
+                                                         NotificationModuleHandle *outHandle) {
+    if (outHandle == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    return Add(text, text ? strlen(text) : 0, true, NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC, 0.0f, 0.0f, textColor, backgroundColor, callback, callbackContext, false, outHandle);
+}
+
+static NotificationModuleStatus NMAddDynamicNotificationV2(const char *text,
+                                                           NMColor textColor,
+                                                           NMColor backgroundColor,
+                                                           NotificationModuleNotificationFinishedCallback callback,
+                                                           void *callbackContext,
+                                                           bool keepUntilShown,
+                                                           NotificationModuleHandle *outHandle) {
+    if (outHandle == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    return Add(text, text ? strlen(text) : 0, true, NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC, 0.0f, 0.0f, textColor, backgroundColor, callback, callbackContext, keepUntilShown, outHandle);
+}
+
+static NotificationModuleStatus NMAddNotification(const NMNotificationDesc *desc, NotificationModuleHandle *outHandle) {
+    if (desc == nullptr || desc->size < NM_NOTIFICATION_DESC_SIZE_V1) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    // Only the fields up to desc->size may be read.
+    NMNotificationDesc cur = {};
+    memcpy(&cur, desc, std::min<uint32_t>(desc->size, sizeof(cur)));
+    if (cur.type == NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC && outHandle == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    return Add(cur.text,
+               cur.text ? strlen(cur.text) : 0,
+               true,
+               cur.type,
+               cur.durationBeforeFadeOutInSeconds,
+               cur.shakeDurationInSeconds,
+               cur.textColor,
+               cur.backgroundColor,
+               cur.callback,
+               cur.callbackContext,
+               cur.keepUntilShown,
+               cur.type == NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC ? outHandle : nullptr);
+}
+
+static NotificationModuleStatus UpdateDynamic(NotificationModuleHandle handle,
+                                              const char *text,
+                                              uint32_t textLength,
+                                              bool copyText,
+                                              NMColor textColor,
+                                              NMColor backgroundColor,
+                                              uint32_t fieldMask) {
+    SimulateCall();
+    if ((fieldMask & NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_TEXT) != 0 && text == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    std::lock_guard<std::mutex> lock(sMutex);
+    sStats.updateCalls++;
+    auto *entry = FindDynamicEntry(handle);
+    if (entry == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_HANDLE;
+    }
+    if (copyText && (fieldMask & NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_TEXT) != 0) {
+        sStats.bytesCopied += textLength + 1;
+    }
+    ApplyUpdate(*entry, text, textLength, textColor, backgroundColor, fieldMask);
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+static NotificationModuleStatus NMUpdateDynamicNotificationText(NotificationModuleHandle handle, const char *text) {
+    return UpdateDynamic(handle, text, text ? strlen(text) : 0, true, {}, {}, NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_TEXT);
+}
+
+static NotificationModuleStatus NMUpdateDynamicNotificationTextShared(NotificationModuleHandle handle, const char *text, uint32_t textLength) {
+    return UpdateDynamic(handle, text, textLength, false, {}, {}, NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_TEXT);
+}
+
+static NotificationModuleStatus NMUpdateDynamicNotificationBackgroundColor(NotificationModuleHandle handle, NMColor backgroundColor) {
+    return UpdateDynamic(handle, nullptr, 0, false, {}, backgroundColor, NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_BACKGROUND_COLOR);
+}
+
+static NotificationModuleStatus NMUpdateDynamicNotificationTextColor(NotificationModuleHandle handle, NMColor textColor) {
+    return UpdateDynamic(handle, nullptr, 0, false, textColor, {}, NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_TEXT_COLOR);
+}
+
+static NotificationModuleStatus NMUpdateDynamicNotification(NotificationModuleHandle handle, const NMDynamicUpdate *update, uint32_t fieldMask) {
+    if (update == nullptr || fieldMask == 0 || (fieldMask & ~NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_ALL) != 0) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    return UpdateDynamic(handle, update->text, update->text ? strlen(update->text) : 0, true, update->textColor, update->backgroundColor, fieldMask);
+}
+
+static bool IsContinuationByte(char c) {
+    return ((uint8_t) c & 0xC0) == 0x80;
+}
+
+// True if `text` consists of complete UTF-8 sequences only.
+static bool IsCompleteUtf8(const char *text, uint32_t length) {
+    for (uint32_t i = 0; i < length;) {
+        auto lead         = (uint8_t) text[i];
+        uint32_t sequence = 0;
+        if (lead < 0x80) {
+            sequence = 1;
+        } else if ((lead & 0xE0) == 0xC0) {
+            sequence = 2;
+        } else if ((lead & 0xF0) == 0xE0) {
+            sequence = 3;
+        } else if ((lead & 0xF8) == 0xF0) {
+            sequence = 4;
+        }
+        if (sequence == 0 || sequence > length - i) {
+            return false;
+        }
+        for (uint32_t j = 1; j < sequence; j++) {
+            if (!IsContinuationByte(text[i + j])) {
+                return false;
+            }
+        }
+        i += sequence;
+    }
+    return true;
+}
+
+static NotificationModuleStatus NMSpliceDynamicNotificationText(NotificationModuleHandle handle,
+                                                                uint32_t offset,
+                                                                uint32_t removedLength,
+                                                                const char *inserted,
+                                                                uint32_t insertedLength) {
+    SimulateCall();
+    if (inserted == nullptr && insertedLength > 0) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    std::lock_guard<std::mutex> lock(sMutex);
+    sStats.updateCalls++;
+    auto *entry = FindDynamicEntry(handle);
+    if (entry == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_HANDLE;
+    }
+    auto &text = entry->info.text;
+    if (offset > text.size() || removedLength > text.size() - offset) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    // A real module would have to render a half code point, the library must only splice complete sequences.
+    if (IsContinuationByte(text[offset]) || IsContinuationByte(text[offset + removedLength]) || !IsCompleteUtf8(inserted, insertedLength)) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    text.replace(offset, removedLength, inserted ? inserted : "", insertedLength);
+    sStats.bytesCopied += insertedLength;
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+static NotificationModuleStatus NMFinishDynamicNotification(NotificationModuleHandle handle,
+                                                            NotificationModuleStatusFinish finishMode,
+                                                            float durationBeforeFadeOutInSeconds,
+                                                            float shakeDurationInSeconds) {
+    SimulateCall();
+    std::vector<PendingCallback> callbacks;
+    bool found;
+    {
+        std::lock_guard<std::mutex> lock(sMutex);
+        found = FinishEntry(handle, finishMode, durationBeforeFadeOutInSeconds, shakeDurationInSeconds, callbacks);
+    }
+    CallCallbacks(callbacks);
+    return found ? NOTIFICATION_MODULE_RESULT_SUCCESS : NOTIFICATION_MODULE_RESULT_INVALID_HANDLE;
+}
+
+// Unknown handles of a batch are skipped, like the module does.
+static NotificationModuleStatus NMFinishDynamicNotificationBatch(const NotificationModuleHandle *handles,
+                                                                 uint32_t numHandles,
+                                                                 NotificationModuleStatusFinish finishMode,
+                                                                 float durationBeforeFadeOutInSeconds,
+                                                                 float shakeDurationInSeconds) {
+    SimulateCall();
+    if (handles == nullptr && numHandles > 0) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    std::vector<PendingCallback> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(sMutex);
+        sStats.batchCalls++;
+        for (uint32_t i = 0; i < numHandles; i++) {
+            FinishEntry(handles[i], finishMode, durationBeforeFadeOutInSeconds, shakeDurationInSeconds, callbacks);
+        }
+    }
+    CallCallbacks(callbacks);
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+static NotificationModuleStatus NMUpdateDynamicNotificationBatch(const NotificationModuleHandle *handles,
+                                                                 uint32_t numHandles,
+                                                                 const NMDynamicUpdate *update,
+                                                                 uint32_t fieldMask) {
+    SimulateCall();
+    if ((handles == nullptr && numHandles > 0) || update == nullptr || fieldMask == 0 || (fieldMask & ~NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_ALL) != 0 ||
+        ((fieldMask & NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_TEXT) != 0 && update->text == nullptr)) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    uint32_t textLength = update->text ? strlen(update->text) : 0;
+    std::lock_guard<std::mutex> lock(sMutex);
+    sStats.batchCalls++;
+    for (uint32_t i = 0; i < numHandles; i++) {
+        sStats.updateCalls++;
+        auto *entry = FindDynamicEntry(handles[i]);
+        if (entry == nullptr) {
+            continue;
+        }
+        if ((fieldMask & NOTIFICATION_MODULE_DYNAMIC_UPDATE_FIELD_TEXT) != 0) {
+            sStats.bytesCopied += textLength + 1;
+        }
+        ApplyUpdate(*entry, update->text, textLength, update->textColor, update->backgroundColor, fieldMask);
+    }
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+static NotificationModuleStatus NMDetachDynamicNotificationCallbacks(const NotificationModuleHandle *handles, uint32_t numHandles) {
+    SimulateCall();
+    if (handles == nullptr && numHandles > 0) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    std::lock_guard<std::mutex> lock(sMutex);
+    for (uint32_t i = 0; i < numHandles; i++) {
+        auto *entry = FindEntry(handles[i]);
+        if (entry != nullptr) {
+            entry->callback         = nullptr;
+            entry->info.hasCallback = false;
+        }
+    }
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+static NotificationModuleStatus NMGetQueueInfo(NMQueueInfo *outInfo) {
+    SimulateCall();
+    if (outInfo == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    std::lock_guard<std::mutex> lock(sMutex);
+    *outInfo = {};
+    for (const auto &cur : sEntries) {
+        if (cur.info.visible) {
+            outInfo->visible++;
+        } else {
+            outInfo->pending++;
+        }
+    }
+    outInfo->bytesUsed       = GetBytesUsed();
+    outInfo->capacityInBytes = sConfig.capacityInBytes;
+    outInfo->isEstimate      = false;
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+/**
+ * Consumes all published records of the ring. Has to be called while holding sRingConsumerMutex, finish callbacks
+ * are added to `callbacks`.
+ */
+static void ConsumeRing(std::vector<PendingCallback> &callbacks) {
+    if (sRing == nullptr) {
+        return;
+    }
+    auto *data    = (uint8_t *) sRing + sRing->dataOffset;
+    uint32_t tail = sRing->tail.load(std::memory_order_relaxed);
+    uint32_t head = sRing->head.load(std::memory_order_acquire);
+
+    std::lock_guard<std::mutex> lock(sMutex);
+    sStats.ringProcessCalls++;
+    while (tail != head) {
+        auto *record = (const SharedRingRecord *) (data + (tail & (sRing->capacity - 1)));
+        switch (record->command) {
+            case SHARED_RING_COMMAND_PAD:
+                break;
+            case SHARED_RING_COMMAND_UPDATE: {
+                auto *entry = FindDynamicEntry(record->moduleHandle);
+                if (entry != nullptr) {
+                    const char *text = record->sharedText ? record->sharedText : (const char *) (record + 1);
+                    ApplyUpdate(*entry, text, record->textLength, record->textColor, record->backgroundColor, record->flags);
+                }
+                break;
+            }
+            case SHARED_RING_COMMAND_FINISH:
+                FinishEntry(record->moduleHandle,
+                            (NotificationModuleStatusFinish) record->flags,
+                            record->durationBeforeFadeOutInSeconds,
+                            record->shakeDurationInSeconds,
+                            callbacks);
+                break;
+            default:
+                fprintf(stderr, "stand-in: unknown ring command %u\n", record->command);
+                abort();
+        }
+        sStats.ringRecords++;
+        tail += record->size;
+    }
+    sRing->tail.store(tail, std::memory_order_release);
+}
+
+static NotificationModuleStatus NMAttachSharedRing(SharedRingHeader *header) {
+    if (header == nullptr || header->magic != SHARED_RING_MAGIC || header->version != SHARED_RING_VERSION ||
+        header->capacity == 0 || (header->capacity & (header->capacity - 1)) != 0 || header->dataOffset < sizeof(SharedRingHeader)) {
+        return NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT;
+    }
+    std::lock_guard<std::mutex> lock(sRingConsumerMutex);
+    if (sRing != nullptr) {
+        return NOTIFICATION_MODULE_RESULT_UNSUPPORTED_COMMAND;
+    }
+    sRing = header;
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+static NotificationModuleStatus NMProcessSharedRing() {
+    std::vector<PendingCallback> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(sRingConsumerMutex);
+        ConsumeRing(callbacks);
+    }
+    CallCallbacks(callbacks);
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+static NotificationModuleStatus NMDetachSharedRing() {
+    std::lock_guard<std::mutex> lock(sRingConsumerMutex);
+    if (sRing == nullptr) {
+        return NOTIFICATION_MODULE_RESULT_UNSUPPORTED_COMMAND;
+    }
+    if (sRing->head.load(std::memory_order_acquire) != sRing->tail.load(std::memory_order_relaxed)) {
+        fprintf(stderr, "stand-in: the shared ring was detached while it still had records\n");
+        abort();
+    }
+    sRing = nullptr;
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+struct StandInExportEntry {
+    const char *name;
+    uint32_t requiredExport;
+    void *address;
+};
+
+static const StandInExportEntry sExports[] = {
+        {"NMGetVersion", 0, (void *) NMGetVersion},
+        {"NMAddStaticNotification", 0, (void *) NMAddStaticNotification},
+        {"NMAddDynamicNotification", 0, (void *) NMAddDynamicNotification},
+        {"NMUpdateDynamicNotificationText", 0, (void *) NMUpdateDynamicNotificationText},
+        {"NMUpdateDynamicNotificationBackgroundColor", 0, (void *) NMUpdateDynamicNotificationBackgroundColor},
+        {"NMUpdateDynamicNotificationTextColor", 0, (void *) NMUpdateDynamicNotificationTextColor},
+        {"NMFinishDynamicNotification", 0, (void *) NMFinishDynamicNotification},
+        {"NMIsOverlayReady", STAND_IN_EXPORT_IS_OVERLAY_READY, (void *) NMIsOverlayReady},
+        {"NMAddStaticNotificationV2", STAND_IN_EXPORT_V2, (void *) NMAddStaticNotificationV2},
+        {"NMAddDynamicNotificationV2", STAND_IN_EXPORT_V2, (void *) NMAddDynamicNotificationV2},
+        {"NMAddStaticNotificationShared", STAND_IN_EXPORT_SHARED_TEXT, (void *) NMAddStaticNotificationShared},
+        {"NMUpdateDynamicNotificationTextShared", STAND_IN_EXPORT_SHARED_TEXT, (void *) NMUpdateDynamicNotificationTextShared},
+        {"NMUpdateDynamicNotification", STAND_IN_EXPORT_UPDATE, (void *) NMUpdateDynamicNotification},
+        {"NMSpliceDynamicNotificationText", STAND_IN_EXPORT_SPLICE, (void *) NMSpliceDynamicNotificationText},
+        {"NMFinishDynamicNotificationBatch", STAND_IN_EXPORT_BATCH, (void *) NMFinishDynamicNotificationBatch},
+        {"NMUpdateDynamicNotificationBatch", STAND_IN_EXPORT_BATCH, (void *) NMUpdateDynamicNotificationBatch},
+        {"NMDetachDynamicNotificationCallbacks", STAND_IN_EXPORT_DETACH_CALLBACKS, (void *) NMDetachDynamicNotificationCallbacks},
+        {"NMGetQueueInfo", STAND_IN_EXPORT_QUEUE_INFO, (void *) NMGetQueueInfo},
+        {"NMAddNotification", STAND_IN_EXPORT_ADD_NOTIFICATION, (void *) NMAddNotification},
+        {"NMAttachSharedRing", STAND_IN_EXPORT_SHARED_RING, (void *) NMAttachSharedRing},
+        {"NMProcessSharedRing", STAND_IN_EXPORT_SHARED_RING, (void *) NMProcessSharedRing},
+        {"NMDetachSharedRing", STAND_IN_EXPORT_SHARED_RING, (void *) NMDetachSharedRing},
+};
+
+extern "C" OSDynLoad_Error OSDynLoad_Acquire(const char *name, OSDynLoad_Module *outModule) {
+    std::lock_guard<std::mutex> lock(sMutex);
+    if (!sConfig.moduleLoaded || name == nullptr || strcmp(name, "homebrew_notifications") != 0) {
+        return OS_DYNLOAD_NOT_FOUND;
+    }
+    *outModule = (OSDynLoad_Module) &sConfig;
+    return OS_DYNLOAD_OK;
+}
+
+extern "C" OSDynLoad_Error OSDynLoad_FindExport(OSDynLoad_Module module, OSDynLoad_ExportType exportType, const char *name, void **outAddr) {
+    if (module != (OSDynLoad_Module) &sConfig) {
+        return OS_DYNLOAD_INVALID_HANDLE;
+    }
+    std::lock_guard<std::mutex> lock(sMutex);
+    for (const auto &cur : sExports) {
+        if (exportType == OS_DYNLOAD_EXPORT_FUNC && strcmp(cur.name, name) == 0 && (cur.requiredExport & ~sConfig.exports) == 0) {
+            *outAddr = cur.address;
+            return OS_DYNLOAD_OK;
+        }
+    }
+    return OS_DYNLOAD_NOT_FOUND;
+}
+
+extern "C" void OSDynLoad_Release(OSDynLoad_Module) {
+}
+
+extern "C" OSTime OSGetSystemTime() {
+    return (OSTime) OSMicrosecondsToTicks(NowInUs());
+}
+
+// The library only logs errors and warnings, set STAND_IN_VERBOSE to see them.
+extern "C" void OSReport(const char *fmt, ...) {
+    static bool verbose = getenv("STAND_IN_VERBOSE") != nullptr;
+    if (!verbose) {
+        return;
+    }
+    va_list args;
+    va_start(args, fmt);
+    vfprintf(stderr, fmt, args);
+    va_end(args);
+}
+
+void StandIn_Reset(const StandInConfig &config) {
+    StandIn_StopRenderThread();
+    {
+        std::lock_guard<std::mutex> lock(sRingConsumerMutex);
+        sRing = nullptr;
+    }
+    std::lock_guard<std::mutex> lock(sMutex);
+    sConfig      = config;
+    sEntries     = {};
+    sNextHandle  = 0x100;
+    sStats       = {};
+    sRandomState = config.seed != 0 ? config.seed : 1;
+    sManualClock = config.manualClock;
+    sManualTimeInUs.store(1000000);
+}
+
+void StandIn_SetOverlayReady(bool ready) {
+    std::lock_guard<std::mutex> lock(sMutex);
+    sConfig.overlayReady = ready;
+}
+
+void StandIn_SetFaults(float addFailureRate, uint32_t callLatencyInUs, float slowCallRate, uint32_t slowCallLatencyInUs) {
+    std::lock_guard<std::mutex> lock(sMutex);
+    sConfig.addFailureRate      = addFailureRate;
+    sConfig.callLatencyInUs     = callLatencyInUs;
+    sConfig.slowCallRate        = slowCallRate;
+    sConfig.slowCallLatencyInUs = slowCallLatencyInUs;
+}
+
+void StandIn_AdvanceClock(uint64_t microseconds) {
+    sManualTimeInUs.fetch_add(microseconds);
+}
+
+void StandIn_RunFrame() {
+    std::vector<PendingCallback> callbacks;
+    {
+        std::lock_guard<std::mutex> ringLock(sRingConsumerMutex);
+        ConsumeRing(callbacks);
+    }
+    {
+        std::lock_guard<std::mutex> lock(sMutex);
+        uint64_t now = NowInUs();
+        for (auto it = sEntries.begin(); it != sEntries.end();) {
+            if (!it->info.visible && sConfig.overlayReady) {
+                it->info.visible = true;
+                if (it->info.type != NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC || it->info.finished) {
+                    StartFadeOut(*it, now);
+                }
+            }
+            if (it->fadeOutAtInUs != 0 && it->fadeOutAtInUs <= now) {
+                RemoveEntry(it, callbacks);
+                continue;
+            }
+            ++it;
+        }
+    }
+    CallCallbacks(callbacks);
+}
+
+void StandIn_FadeOutAll() {
+    std::vector<PendingCallback> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(sMutex);
+        for (auto it = sEntries.begin(); it != sEntries.end();) {
+            if (it->info.type != NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC || it->info.finished) {
+                RemoveEntry(it, callbacks);
+                continue;
+            }
+            ++it;
+        }
+    }
+    CallCallbacks(callbacks);
+}
+
+void StandIn_StartRenderThread(uint32_t frameInUs, uint32_t renderInUs) {
+    StandIn_StopRenderThread();
+    sRenderThreadStop = false;
+    sRenderThread     = std::thread([frameInUs, renderInUs] {
+        while (!sRenderThreadStop) {
+            auto frameStart = std::chrono::steady_clock::now();
+            StandIn_RunFrame();
+            if (renderInUs > 0) {
+                // Rendering holds the module lock like the overlay does while it draws the notifications.
+                std::lock_guard<std::mutex> lock(sMutex);
+                BusyWait(renderInUs);
+            }
+            std::this_thread::sleep_until(frameStart + std::chrono::microseconds(frameInUs));
+        }
+    });
+}
+
+void StandIn_StopRenderThread() {
+    if (sRenderThread.joinable()) {
+        sRenderThreadStop = true;
+        sRenderThread.join();
+    }
+}
+
+StandInStats StandIn_GetStats() {
+    std::lock_guard<std::mutex> lock(sMutex);
+    return sStats;
+}
+
+void StandIn_ResetStats() {
+    std::lock_guard<std::mutex> lock(sMutex);
+    sStats = {};
+}
+
+std::vector<StandInNotification> StandIn_GetNotifications() {
+    std::lock_guard<std::mutex> lock(sMutex);
+    std::vector<StandInNotification> result;
+    for (const auto &cur : sEntries) {
+        result.push_back(cur.info);
+    }
+    return result;
+}
+
+bool StandIn_FindNotification(const char *text, StandInNotification *outNotification) {
+    std::lock_guard<std::mutex> lock(sMutex);
+    for (auto it = sEntries.rbegin(); it != sEntries.rend(); ++it) {
+        if (it->info.text == text) {
+            if (outNotification != nullptr) {
+                *outNotification = it->info;
+            }
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <notifications/notification_defines.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Host stand-in for the NotificationModule. It implements the exports the library looks up with
+ * OSDynLoad_FindExport() and the coreinit functions the library uses, so the library sources can be built and
+ * tested on the host.
+ *
+ * The overlay is modelled as a list of notifications. Pending notifications become visible once the overlay is
+ * ready, finished and static notifications fade out when StandIn_RunFrame() is called after their fade out time.
+ * Failures and latency can be injected at configurable rates, the random numbers are reproducible from the seed.
+ */
+
+/**
+ * Optional exports, NMGetVersion, NMAddStaticNotification, NMAddDynamicNotification, NMUpdateDynamicNotification*Color,
+ * NMUpdateDynamicNotificationText and NMFinishDynamicNotification are always available.
+ */
+enum StandInExport : uint32_t {
+    STAND_IN_EXPORT_IS_OVERLAY_READY = 1 << 0,  /* NMIsOverlayReady */
+    STAND_IN_EXPORT_V2               = 1 << 1,  /* NMAddStaticNotificationV2 and NMAddDynamicNotificationV2 (API version 2) */
+    STAND_IN_EXPORT_SHARED_TEXT      = 1 << 2,  /* NMAddStaticNotificationShared and NMUpdateDynamicNotificationTextShared */
+    STAND_IN_EXPORT_UPDATE           = 1 << 3,  /* NMUpdateDynamicNotification */
+    STAND_IN_EXPORT_SPLICE           = 1 << 4,  /* NMSpliceDynamicNotificationText */
+    STAND_IN_EXPORT_BATCH            = 1 << 5,  /* NMFinishDynamicNotificationBatch and NMUpdateDynamicNotificationBatch */
+    STAND_IN_EXPORT_DETACH_CALLBACKS = 1 << 6,  /* NMDetachDynamicNotificationCallbacks */
+    STAND_IN_EXPORT_QUEUE_INFO       = 1 << 7,  /* NMGetQueueInfo */
+    STAND_IN_EXPORT_ADD_NOTIFICATION = 1 << 8,  /* NMAddNotification */
+    STAND_IN_EXPORT_SHARED_RING      = 1 << 9,  /* NMAttachSharedRing, NMProcessSharedRing and NMDetachSharedRing */
+    STAND_IN_EXPORT_ALL              = (1 << 10) - 1,
+};
+
+struct StandInConfig {
+    NotificationModuleAPIVersion apiVersion = 1;
+    uint32_t exports                        = 0; // StandInExport flags
+    bool moduleLoaded                       = true;
+    uint32_t seed                           = 1;
+    // Share (0.0 - 1.0) of the add calls that fail with addFailureStatus without adding anything.
+    float addFailureRate                      = 0.0f;
+    NotificationModuleStatus addFailureStatus = NOTIFICATION_MODULE_RESULT_OVERLAY_NOT_READY;
+    // Every call takes callLatencyInUs, a share of slowCallRate calls takes slowCallLatencyInUs instead.
+    uint32_t callLatencyInUs     = 0;
+    float slowCallRate           = 0.0f;
+    uint32_t slowCallLatencyInUs = 0;
+    // Adding fails with NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED once the texts of all notifications need more.
+    uint32_t capacityInBytes = 0x10000;
+    bool overlayReady        = true;
+    // OSGetSystemTime only moves with StandIn_AdvanceClock().
+    bool manualClock = false;
+    // Notifications finished with a fade out delay of 0 call their finish callback right away (also while the shared
+    // ring is processed) instead of on the next StandIn_RunFrame().
+    bool fadeOutImmediately = false;
+};
+
+struct StandInNotification {
+    NotificationModuleHandle handle;
+    NotificationModuleNotificationType type;
+    std::string text;
+    NMColor textColor;
+    NMColor backgroundColor;
+    bool keepUntilShown;
+    bool visible;
+    bool finished;
+    bool hasCallback;
+};
+
+struct StandInStats {
+    uint32_t addCalls;
+    uint32_t updateCalls;   // Every update export, each handle of a batch counts once
+    uint32_t finishCalls;   // Every finish export, each handle of a batch counts once
+    uint32_t batchCalls;    // NMFinishDynamicNotificationBatch and NMUpdateDynamicNotificationBatch
+    uint32_t moduleCalls;   // All exports except NMGetVersion and the shared ring functions
+    uint32_t injectedFailures;
+    uint32_t invalidHandles; // Calls that returned NOTIFICATION_MODULE_RESULT_INVALID_HANDLE
+    uint32_t ringRecords;    // Records consumed from the shared ring
+    uint32_t ringProcessCalls;
+    uint32_t callbacksCalled;
+    uint64_t bytesCopied; // Text bytes the module had to copy (inline ring texts are read in place and not counted)
+};
+
+/**
+ * Resets the stand-in to `config`, forgetting all notifications without calling their callbacks.
+ * Must not be called while the library is initialized.
+ */
+void StandIn_Reset(const StandInConfig &config = {});
+
+void StandIn_SetOverlayReady(bool ready);
+
+/**
+ * Changes the injected failures and latency, e.g. after the library has been initialized.
+ */
+void StandIn_SetFaults(float addFailureRate, uint32_t callLatencyInUs, float slowCallRate, uint32_t slowCallLatencyInUs);
+
+/**
+ * Moves the clock forward. Only used with StandInConfig::manualClock.
+ */
+void StandIn_AdvanceClock(uint64_t microseconds);
+
+/**
+ * Simulates a frame of the overlay: consumes the shared ring, shows pending notifications if the overlay is ready
+ * and fades out the notifications whose time is up (calling their finish callbacks).
+ */
+void StandIn_RunFrame();
+
+/**
+ * Fades out all finished and static notifications right away, regardless of their fade out time.
+ */
+void StandIn_FadeOutAll();
+
+/**
+ * Runs StandIn_RunFrame() every `frameInUs` on a background thread, each frame blocks the module for `renderInUs`.
+ */
+void StandIn_StartRenderThread(uint32_t frameInUs, uint32_t renderInUs);
+
+void StandIn_StopRenderThread();
+
+StandInStats StandIn_GetStats();
+
+void StandIn_ResetStats();
+
+/**
+ * Returns all notifications that have not faded out yet, in the order they have been added.
+ */
+std::vector<StandInNotification> StandIn_GetNotifications();
+
+/**
+ * Returns the (newest) notification with the given text that has not faded out yet.
+ */
+bool StandIn_FindNotification(const char *text, StandInNotification *outNotification);
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "stand_in_module.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <notifications/notifications.h>
+#include <thread>
+
+// Minimal helpers for the host tests. A failed check aborts the test binary.
+
+#define CHECK(condition)                                                                   \
+    do {                                                                                   \
+        if (!(condition)) {                                                                \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            abort();                                                                       \
+        }                                                                                  \
+    } while (0)
+
+#define CHECK_STATUS(expected, call)                                                                                           \
+    do {                                                                                                                       \
+        NotificationModuleStatus _res = (call);                                                                                \
+        if (_res != (expected)) {                                                                                              \
+            fprintf(stderr, "%s:%d: %s returned %s, expected %s\n", __FILE__, __LINE__, #call, NotificationModule_GetStatusStr(_res), \
+                    NotificationModule_GetStatusStr(expected));                                                                \
+            abort();                                                                                                           \
+        }                                                                                                                      \
+    } while (0)
+
+#define RUN_TEST(test)                \
+    do {                              \
+        printf("  %s\n", #test);      \
+        test();                       \
+    } while (0)
+
+/**
+ * Resets the stand-in to `config` and initializes the library with it.
+ */
+static inline void InitLibrary(const StandInConfig &config = {}) {
+    StandIn_Reset(config);
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_InitLibrary());
+}
+
+/**
+ * Polls `condition` until it's true or `timeoutInMs` (real time) have passed.
+ */
+template<typename Condition>
+static inline bool WaitUntil(Condition condition, uint32_t timeoutInMs = 5000) {
+    auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutInMs);
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() >= end) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    return true;
+}
@@ -0,0 +1,234 @@
+#include "test.h"
+
+#include <cstring>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+// Message catalogs created by tools/nmcatalog.py and read by NotificationModule_OpenCatalog.
+
+static char sTempDir[] = "/tmp/nmcatalogXXXXXX";
+
+static std::string TempPath(const char *name) {
+    return std::string(sTempDir) + "/" + name;
+}
+
+static void WriteFile(const std::string &path, const std::string &content) {
+    FILE *f = fopen(path.c_str(), "wb");
+    CHECK(f != nullptr);
+    CHECK(fwrite(content.data(), 1, content.size(), f) == content.size());
+    fclose(f);
+}
+
+static std::string ReadFile(const std::string &path) {
+    FILE *f = fopen(path.c_str(), "rb");
+    CHECK(f != nullptr);
+    std::string content;
+    char buffer[4096];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), f)) > 0) {
+        content.append(buffer, read);
+    }
+    fclose(f);
+    return content;
+}
+
+static int RunTool(const std::string &arguments) {
+    std::string command = "python3 " NM_HOST_TOOLS_DIR "/nmcatalog.py " + arguments;
+    return system(command.c_str());
+}
+
+// Creates `name`.nmc from the given text file content.
+static std::string CreateCatalog(const char *name, const std::string &source) {
+    auto sourcePath  = TempPath(name) + ".txt";
+    auto catalogPath = TempPath(name) + ".nmc";
+    WriteFile(sourcePath, source);
+    CHECK(RunTool(sourcePath + " " + catalogPath) == 0);
+    return catalogPath;
+}
+
+static void CheckText(NotificationModuleCatalogHandle catalog, uint32_t textId, const char *expected) {
+    const char *text = nullptr;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_GetCatalogText(catalog, textId, &text));
+    CHECK(strcmp(text, expected) == 0);
+}
+
+static void TestRoundTrip() {
+    const char *source = "# Comment\n"
+                         "\n"
+                         "1=File saved successfully!\n"
+                         "0x10=Hex id\n"
+                         "2=Line one\\nLine two\n"
+                         "3=Back\\\\slash\n"
+                         "4=Gespeichert: \xC3\xA4\xC3\xB6\xC3\xBC \xE2\x9C\x93\n"
+                         "5=File saved successfully!\n"
+                         "6=\n"
+                         "0=Zero\n"
+                         "4294967295=Max id\n";
+    auto path = CreateCatalog("roundtrip", source);
+
+    NotificationModuleCatalogHandle catalog;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_OpenCatalog(path.c_str(), &catalog));
+    CheckText(catalog, 0, "Zero");
+    CheckText(catalog, 1, "File saved successfully!");
+    CheckText(catalog, 2, "Line one\nLine two");
+    CheckText(catalog, 3, "Back\\slash");
+    CheckText(catalog, 4, "Gespeichert: \xC3\xA4\xC3\xB6\xC3\xBC \xE2\x9C\x93");
+    CheckText(catalog, 5, "File saved successfully!");
+    CheckText(catalog, 6, "");
+    CheckText(catalog, 16, "Hex id");
+    CheckText(catalog, 0xFFFFFFFF, "Max id");
+
+    const char *text = nullptr;
+    for (uint32_t textId : {7u, 15u, 17u, 0xFFFFFFFEu}) {
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT, NotificationModule_GetCatalogText(catalog, textId, &text));
+    }
+    // Identical texts are stored once.
+    const char *first;
+    const char *second;
+    NotificationModule_GetCatalogText(catalog, 1, &first);
+    NotificationModule_GetCatalogText(catalog, 5, &second);
+    CHECK(first == second);
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_CloseCatalog(catalog));
+
+    // Dumping the catalog gives the entries back, sorted by id and escaped again.
+    CHECK(RunTool("--dump " + path + " > " + TempPath("roundtrip.dump")) == 0);
+    CHECK(ReadFile(TempPath("roundtrip.dump")) == "0=Zero\n"
+                                                  "1=File saved successfully!\n"
+                                                  "2=Line one\\nLine two\n"
+                                                  "3=Back\\\\slash\n"
+                                                  "4=Gespeichert: \xC3\xA4\xC3\xB6\xC3\xBC \xE2\x9C\x93\n"
+                                                  "5=File saved successfully!\n"
+                                                  "6=\n"
+                                                  "16=Hex id\n"
+                                                  "4294967295=Max id\n");
+}
+
+static void TestLargeCatalog() {
+    std::string source;
+    char line[64];
+    // Every third id is used, so there are gaps to look up.
+    for (uint32_t i = 0; i < 10000; i++) {
+        snprintf(line, sizeof(line), "%u=Text number %u\n", i * 3, i);
+        source += line;
+    }
+    auto path = CreateCatalog("large", source);
+
+    NotificationModuleCatalogHandle catalog;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_OpenCatalog(path.c_str(), &catalog));
+    char expected[32];
+    const char *text;
+    for (uint32_t i = 0; i < 30000; i++) {
+        if (i % 3 == 0) {
+            snprintf(expected, sizeof(expected), "Text number %u", i / 3);
+            CheckText(catalog, i, expected);
+        } else {
+            CHECK_STATUS(NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT, NotificationModule_GetCatalogText(catalog, i, &text));
+        }
+    }
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT, NotificationModule_GetCatalogText(catalog, 30000, &text));
+    NotificationModule_CloseCatalog(catalog);
+}
+
+static void TestEmptyCatalog() {
+    auto path = CreateCatalog("empty", "# Nothing\n");
+    NotificationModuleCatalogHandle catalog;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_OpenCatalog(path.c_str(), &catalog));
+    const char *text;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT, NotificationModule_GetCatalogText(catalog, 0, &text));
+    NotificationModule_CloseCatalog(catalog);
+}
+
+static void CheckRejected(const char *name, const std::string &content) {
+    auto path = TempPath(name);
+    WriteFile(path, content);
+    NotificationModuleCatalogHandle catalog = nullptr;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT, NotificationModule_OpenCatalog(path.c_str(), &catalog));
+    CHECK(catalog == nullptr);
+}
+
+static void TestInvalidCatalogsAreRejected() {
+    auto valid = ReadFile(CreateCatalog("valid", "1=One\n2=Two\n3=Three\n"));
+    // Header (16 bytes), index at 16 (3 x 8 bytes), blob at 40.
+    CHECK(valid.size() == 16 + 3 * 8 + 14);
+
+    CheckRejected("empty.nmc", "");
+    CheckRejected("truncated_header.nmc", valid.substr(0, 12));
+    CheckRejected("truncated.nmc", valid.substr(0, valid.size() - 1));
+    CheckRejected("trailing.nmc", valid + "x");
+
+    auto corrupt = valid;
+    corrupt[0]   = 'X';
+    CheckRejected("magic.nmc", corrupt);
+
+    corrupt    = valid;
+    corrupt[7] = 2;
+    CheckRejected("version.nmc", corrupt);
+
+    corrupt    = valid;
+    corrupt[8] = (char) 0x7F;
+    CheckRejected("count.nmc", corrupt);
+
+    // Blob doesn't end with a null terminator.
+    corrupt                     = valid;
+    corrupt[corrupt.size() - 1] = 'e';
+    CheckRejected("unterminated.nmc", corrupt);
+
+    // Offset of the second entry beyond the blob.
+    corrupt     = valid;
+    corrupt[31] = 100;
+    CheckRejected("offset.nmc", corrupt);
+
+    // Id of the second entry smaller than the first one.
+    corrupt     = valid;
+    corrupt[27] = 0;
+    CheckRejected("unsorted.nmc", corrupt);
+
+    NotificationModuleCatalogHandle catalog;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT, NotificationModule_OpenCatalog(TempPath("missing.nmc").c_str(), &catalog));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT, NotificationModule_OpenCatalog(nullptr, &catalog));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT, NotificationModule_OpenCatalog(TempPath("valid.nmc").c_str(), nullptr));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT, NotificationModule_CloseCatalog(nullptr));
+}
+
+static void TestToolRejectsInvalidInput() {
+    WriteFile(TempPath("duplicate.txt"), "1=One\n1=Again\n");
+    CHECK(RunTool(TempPath("duplicate.txt") + " " + TempPath("duplicate.nmc") + " 2> /dev/null") != 0);
+    WriteFile(TempPath("noequals.txt"), "1 One\n");
+    CHECK(RunTool(TempPath("noequals.txt") + " " + TempPath("noequals.nmc") + " 2> /dev/null") != 0);
+}
+
+static void TestAddById() {
+    auto path = CreateCatalog("add", "1=Info from catalog\n2=Error from catalog\n");
+    NotificationModuleCatalogHandle catalog;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_OpenCatalog(path.c_str(), &catalog));
+
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED, NotificationModule_AddInfoNotificationById(catalog, 1));
+    InitLibrary();
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddInfoNotificationById(catalog, 1));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddErrorNotificationById(catalog, 2));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT, NotificationModule_AddInfoNotificationById(catalog, 3));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT, NotificationModule_AddInfoNotificationById(nullptr, 1));
+
+    StandInNotification notification;
+    CHECK(StandIn_FindNotification("Info from catalog", &notification));
+    CHECK(notification.type == NOTIFICATION_MODULE_NOTIFICATION_TYPE_INFO);
+    CHECK(StandIn_FindNotification("Error from catalog", &notification));
+    CHECK(notification.type == NOTIFICATION_MODULE_NOTIFICATION_TYPE_ERROR);
+    CHECK(StandIn_GetNotifications().size() == 2);
+    NotificationModule_DeInitLibrary();
+    NotificationModule_CloseCatalog(catalog);
+}
+
+int main() {
+    printf("test_catalog\n");
+    CHECK(mkdtemp(sTempDir) != nullptr);
+    RUN_TEST(TestRoundTrip);
+    RUN_TEST(TestLargeCatalog);
+    RUN_TEST(TestEmptyCatalog);
+    RUN_TEST(TestInvalidCatalogsAreRejected);
+    RUN_TEST(TestToolRejectsInvalidInput);
+    RUN_TEST(TestAddById);
+    CHECK(system((std::string("rm -r ") + sTempDir).c_str()) == 0);
+    return 0;
+}
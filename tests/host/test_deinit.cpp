@@ -0,0 +1,183 @@
+#include "bench.h"
+#include "handle_table.h"
+#include "test.h"
+
+#include <atomic>
+#include <vector>
+
+// NotificationModule_DeInitLibrary with hundreds of open dynamic notifications.
+
+#define NUM_LIVE     450
+#define NUM_FINISHED 50
+
+static void OnFinished(NotificationModuleHandle, void *context) {
+    ((std::atomic<uint32_t> *) context)->fetch_add(1);
+}
+
+// Adds NUM_LIVE live and NUM_FINISHED finished (still fading out) notifications with callbacks.
+static void AddOpenNotifications(std::atomic<uint32_t> &callbacks, std::vector<NotificationModuleHandle> &outHandles) {
+    for (uint32_t i = 0; i < NUM_LIVE + NUM_FINISHED; i++) {
+        NotificationModuleHandle handle;
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotificationWithCallback("open", &handle, OnFinished, &callbacks));
+        outHandles.push_back(handle);
+    }
+    for (uint32_t i = 0; i < NUM_FINISHED; i++) {
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_FinishDynamicNotification(outHandles[i], 10.0f));
+    }
+    CHECK(HandleTable_GetUsedCount() == NUM_LIVE + NUM_FINISHED);
+}
+
+static uint64_t DeInitAndMeasure() {
+    StandIn_ResetStats();
+    uint64_t start = BenchNowInNs();
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_DeInitLibrary());
+    return BenchNowInNs() - start;
+}
+
+static void CheckAllFinished() {
+    for (const auto &cur : StandIn_GetNotifications()) {
+        CHECK(cur.finished);
+    }
+}
+
+static void TestDeinitWithBatchExports() {
+    StandInConfig config;
+    config.exports = STAND_IN_EXPORT_BATCH | STAND_IN_EXPORT_DETACH_CALLBACKS;
+    InitLibrary(config);
+    std::atomic<uint32_t> callbacks{0};
+    std::vector<NotificationModuleHandle> handles;
+    AddOpenNotifications(callbacks, handles);
+
+    uint64_t durationInNs = DeInitAndMeasure();
+    auto stats            = StandIn_GetStats();
+    // One call to detach the callbacks of all open notifications, one to finish the live ones.
+    CHECK(stats.moduleCalls == 2);
+    CHECK(stats.batchCalls == 1);
+    CHECK(stats.finishCalls == NUM_LIVE);
+    CHECK(stats.invalidHandles == 0);
+    CheckAllFinished();
+    for (const auto &cur : StandIn_GetNotifications()) {
+        CHECK(!cur.hasCallback);
+    }
+
+    StandIn_FadeOutAll();
+    CHECK(StandIn_GetNotifications().empty());
+    CHECK(StandIn_GetStats().callbacksCalled == 0);
+    CHECK(callbacks == 0);
+    printf("    %u open notifications, deinit took %.1f us\n", NUM_LIVE + NUM_FINISHED, (double) durationInNs / 1000.0);
+}
+
+static void TestDeinitWithoutBatchExports() {
+    InitLibrary();
+    std::atomic<uint32_t> callbacks{0};
+    std::vector<NotificationModuleHandle> handles;
+    AddOpenNotifications(callbacks, handles);
+
+    uint64_t durationInNs = DeInitAndMeasure();
+    auto stats            = StandIn_GetStats();
+    CHECK(stats.moduleCalls == NUM_LIVE);
+    CHECK(stats.finishCalls == NUM_LIVE);
+    CHECK(stats.invalidHandles == 0);
+    CheckAllFinished();
+
+    // The module still calls back, but the library doesn't forward it to the callbacks of the application.
+    StandIn_FadeOutAll();
+    CHECK(StandIn_GetStats().callbacksCalled == NUM_LIVE + NUM_FINISHED);
+    CHECK(callbacks == 0);
+    printf("    %u open notifications, deinit took %.1f us\n", NUM_LIVE + NUM_FINISHED, (double) durationInNs / 1000.0);
+}
+
+// Static notifications can't be detached in the module, their callbacks go through the library and are dropped there.
+static void TestStaticCallbacksAfterDeinit() {
+    StandInConfig config;
+    config.exports = STAND_IN_EXPORT_SHARED_TEXT;
+    InitLibrary(config);
+    std::atomic<uint32_t> callbacks{0};
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddInfoNotificationWithCallback("faded out before", OnFinished, &callbacks));
+    StandIn_FadeOutAll();
+    CHECK(callbacks == 1);
+
+    NMColor textColor       = {255, 255, 255, 255};
+    NMColor backgroundColor = {237, 28, 36, 255};
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddInfoNotificationWithCallback("explicit", OnFinished, &callbacks));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddErrorNotificationEx("ex", 2.0f, 0.5f, textColor, backgroundColor, OnFinished, &callbacks, false));
+    // The default finish function, for the copying and the shared (interned) variant.
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_SetDefaultValue(NOTIFICATION_MODULE_NOTIFICATION_TYPE_INFO, NOTIFICATION_MODULE_DEFAULT_OPTION_FINISH_FUNCTION, OnFinished));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_SetDefaultValue(NOTIFICATION_MODULE_NOTIFICATION_TYPE_INFO, NOTIFICATION_MODULE_DEFAULT_OPTION_FINISH_FUNCTION_CONTEXT, (void *) &callbacks));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddInfoNotification("default"));
+    NotificationModuleTextId textId;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_InternText("interned", &textId));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddInfoNotificationInterned(textId));
+    for (const auto &cur : StandIn_GetNotifications()) {
+        CHECK(cur.hasCallback);
+    }
+
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_DeInitLibrary());
+    StandIn_FadeOutAll();
+    CHECK(StandIn_GetStats().callbacksCalled == 5);
+    CHECK(callbacks == 1);
+}
+
+// With a slow module the shutdown time depends on the number of module calls, not on the number of notifications.
+static void TestDeinitTimeIsBounded() {
+    uint64_t durationsInNs[2];
+    for (uint32_t i = 0; i < 2; i++) {
+        StandInConfig config;
+        config.exports = i == 0 ? (uint32_t) (STAND_IN_EXPORT_BATCH | STAND_IN_EXPORT_DETACH_CALLBACKS) : 0;
+        InitLibrary(config);
+        std::atomic<uint32_t> callbacks{0};
+        std::vector<NotificationModuleHandle> handles;
+        AddOpenNotifications(callbacks, handles);
+        StandIn_SetFaults(0.0f, 100, 0.0f, 0);
+        durationsInNs[i] = DeInitAndMeasure();
+        CHECK(StandIn_GetStats().moduleCalls == (i == 0 ? 2 : NUM_LIVE));
+    }
+    // At least 100 us per module call.
+    CHECK(durationsInNs[1] >= NUM_LIVE * 100 * 1000ull);
+    CHECK(durationsInNs[0] < durationsInNs[1] / 10);
+    printf("    100 us per module call: %.1f us batched, %.1f us one by one\n", (double) durationsInNs[0] / 1000.0, (double) durationsInNs[1] / 1000.0);
+}
+
+// Handles and late callbacks from before the deinit don't affect the next init.
+static void TestReinitAfterDeinit() {
+    InitLibrary();
+    std::atomic<uint32_t> oldCallbacks{0};
+    std::vector<NotificationModuleHandle> oldHandles;
+    AddOpenNotifications(oldCallbacks, oldHandles);
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_DeInitLibrary());
+    CHECK(HandleTable_GetUsedCount() == 0);
+
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_InitLibrary());
+    std::atomic<uint32_t> newCallbacks{0};
+    std::vector<NotificationModuleHandle> newHandles;
+    for (uint32_t i = 0; i < 100; i++) {
+        NotificationModuleHandle handle;
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotificationWithCallback("new", &handle, OnFinished, &newCallbacks));
+        newHandles.push_back(handle);
+    }
+    for (auto handle : oldHandles) {
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_INVALID_HANDLE, NotificationModule_UpdateDynamicNotificationText(handle, "old"));
+    }
+
+    // The old notifications fade out and call back into slots that are used by the new ones.
+    StandIn_FadeOutAll();
+    CHECK(oldCallbacks == 0);
+    CHECK(newCallbacks == 0);
+    CHECK(HandleTable_GetUsedCount() == 100);
+    for (auto handle : newHandles) {
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_FinishDynamicNotification(handle, 0.0f));
+    }
+    StandIn_FadeOutAll();
+    CHECK(newCallbacks == 100);
+    NotificationModule_DeInitLibrary();
+}
+
+int main() {
+    printf("test_deinit\n");
+    RUN_TEST(TestDeinitWithBatchExports);
+    RUN_TEST(TestDeinitWithoutBatchExports);
+    RUN_TEST(TestStaticCallbacksAfterDeinit);
+    RUN_TEST(TestDeinitTimeIsBounded);
+    RUN_TEST(TestReinitAfterDeinit);
+    return 0;
+}
@@ -0,0 +1,232 @@
+#include "scheduler.h"
+#include "test.h"
+
+#include <atomic>
+
+// The frame budget, driven by the manual clock so every frame runs exactly once.
+
+#define FRAME_DURATION_IN_US 16667
+
+static uint32_t SetFlagTask(void *context, uint64_t) {
+    ((std::atomic<bool> *) context)->store(true);
+    return 0;
+}
+
+// Advances the manual clock and waits until the scheduler thread has run everything that is due.
+static void AdvanceClock(uint64_t microseconds) {
+    StandIn_AdvanceClock(microseconds);
+    std::atomic<bool> ran{false};
+    CHECK(Scheduler_AddTask(SetFlagTask, &ran, 0) != 0);
+    CHECK(WaitUntil([&ran] { return ran.load(); }));
+}
+
+static NMFrameBudgetInfo GetFrameBudgetInfo() {
+    NMFrameBudgetInfo info;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_GetFrameBudgetInfo(&info));
+    return info;
+}
+
+// Runs frames until the queue is empty, returns the number of frames.
+static uint32_t DrainQueue() {
+    uint32_t frames = 0;
+    while (GetFrameBudgetInfo().queued > 0) {
+        CHECK(frames < 100);
+        AdvanceClock(FRAME_DURATION_IN_US + 1000);
+        frames++;
+    }
+    return frames;
+}
+
+static void OnFinished(NotificationModuleHandle, void *context) {
+    (*(std::atomic<uint32_t> *) context)++;
+}
+
+static void TestBurstIsSpreadOverFrames() {
+    StandInConfig config;
+    config.manualClock = true;
+    InitLibrary(config);
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_SetFrameBudget(4, 0));
+
+    char text[32];
+    for (uint32_t i = 0; i < 20; i++) {
+        snprintf(text, sizeof(text), "burst %u", i);
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddInfoNotification(text));
+    }
+    // The first frame starts with a full budget.
+    CHECK(StandIn_GetStats().addCalls == 4);
+    auto info = GetFrameBudgetInfo();
+    CHECK(info.queued == 16);
+    CHECK(info.deferred == 16);
+
+    // At most one frame worth of calls per frame, the rest in order.
+    uint32_t frames = 0;
+    uint32_t added  = 4;
+    while (added < 20) {
+        CHECK(frames < 100);
+        AdvanceClock(FRAME_DURATION_IN_US + 1000);
+        frames++;
+        uint32_t addCalls = StandIn_GetStats().addCalls;
+        CHECK(addCalls - added <= 4);
+        added = addCalls;
+    }
+    CHECK(frames == 4);
+    CHECK(GetFrameBudgetInfo().queued == 0);
+    auto notifications = StandIn_GetNotifications();
+    CHECK(notifications.size() == 20);
+    for (uint32_t i = 0; i < 20; i++) {
+        snprintf(text, sizeof(text), "burst %u", i);
+        CHECK(notifications[i].text == text);
+    }
+    NotificationModule_DeInitLibrary();
+}
+
+static void TestOperationsOfAHandleStayInOrder() {
+    StandInConfig config;
+    config.manualClock = true;
+    InitLibrary(config);
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_SetFrameBudget(1, 0));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddInfoNotification("uses the budget"));
+
+    // The add is queued, the update and the finish have to wait for it.
+    NotificationModuleHandle handle;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotification("added", &handle));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_UpdateDynamicNotificationText(handle, "updated"));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_FinishDynamicNotification(handle, 0.0f));
+    CHECK(GetFrameBudgetInfo().queued == 3);
+    CHECK(StandIn_GetStats().addCalls == 1);
+
+    CHECK(DrainQueue() == 3);
+    auto stats = StandIn_GetStats();
+    CHECK(stats.addCalls == 2);
+    CHECK(stats.updateCalls == 1);
+    CHECK(stats.finishCalls == 1);
+    CHECK(stats.invalidHandles == 0);
+    StandInNotification notification;
+    CHECK(StandIn_FindNotification("updated", &notification));
+    CHECK(notification.finished);
+    NotificationModule_DeInitLibrary();
+}
+
+static void TestUpdatesAreCoalesced() {
+    StandInConfig config;
+    config.manualClock = true;
+    config.exports     = STAND_IN_EXPORT_UPDATE;
+    InitLibrary(config);
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_SetFrameBudget(1, 0));
+
+    // Uses the budget of the first frame.
+    NotificationModuleHandle handle;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotification("0", &handle));
+    StandIn_ResetStats();
+
+    NMColor backgroundColor = {237, 28, 36, 255};
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_UpdateDynamicNotificationText(handle, "1"));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_UpdateDynamicNotificationText(handle, "2"));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_UpdateDynamicNotificationBackgroundColor(handle, backgroundColor));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_UpdateDynamicNotificationText(handle, "3"));
+    auto info = GetFrameBudgetInfo();
+    CHECK(info.queued == 1);
+    CHECK(info.deferred == 4);
+    CHECK(info.coalesced == 3);
+    CHECK(StandIn_GetStats().updateCalls == 0);
+
+    // A single module call with the latest value of each field.
+    CHECK(DrainQueue() == 1);
+    CHECK(StandIn_GetStats().updateCalls == 1);
+    StandInNotification notification;
+    CHECK(StandIn_FindNotification("3", &notification));
+    CHECK(notification.backgroundColor.r == 237 && notification.backgroundColor.g == 28 && notification.backgroundColor.b == 36);
+
+    NotificationModule_FinishDynamicNotification(handle, 0.0f);
+    NotificationModule_DeInitLibrary();
+}
+
+static void TestReservedHandleAcceptsUpdates() {
+    StandInConfig config;
+    config.manualClock = true;
+    InitLibrary(config);
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_SetFrameBudget(1, 0));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddInfoNotification("uses the budget"));
+
+    // The module hasn't seen the notification yet, the handle is only reserved.
+    NotificationModuleHandle handle;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotification("reserved", &handle));
+    CHECK(!StandIn_FindNotification("reserved", nullptr));
+    NMColor textColor = {0, 255, 0, 255};
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_UpdateDynamicNotificationText(handle, "live"));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_UpdateDynamicNotificationTextColor(handle, textColor));
+    // The add and the (coalesced) update.
+    CHECK(GetFrameBudgetInfo().queued == 2);
+
+    DrainQueue();
+    CHECK(StandIn_GetStats().invalidHandles == 0);
+    StandInNotification notification;
+    CHECK(StandIn_FindNotification("live", &notification));
+    CHECK(notification.textColor.g == 255 && notification.textColor.r == 0);
+    CHECK(!notification.finished);
+
+    NotificationModule_FinishDynamicNotification(handle, 0.0f);
+    DrainQueue();
+    NotificationModule_DeInitLibrary();
+}
+
+static void TestFinishIsQueuedWhenTheQueueIsFull() {
+    StandInConfig config;
+    config.manualClock = true;
+    InitLibrary(config);
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_SetFrameBudget(1, 0));
+    NotificationModuleHandle handle;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotification("uses the budget", &handle));
+
+    char text[32];
+    for (uint32_t i = 0; i < 256; i++) {
+        snprintf(text, sizeof(text), "queued %u", i);
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddInfoNotification(text));
+    }
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED, NotificationModule_AddInfoNotification("doesn't fit"));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED, NotificationModule_UpdateDynamicNotificationText(handle, "doesn't fit"));
+    // Finishing never fails, the notification would stay open forever.
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_FinishDynamicNotification(handle, 0.0f));
+    CHECK(GetFrameBudgetInfo().queued == 257);
+
+    // Without a budget everything is sent at once.
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_SetFrameBudget(0, 0));
+    AdvanceClock(0);
+    CHECK(GetFrameBudgetInfo().queued == 0);
+    auto stats = StandIn_GetStats();
+    CHECK(stats.addCalls == 257);
+    CHECK(stats.finishCalls == 1);
+    NotificationModule_DeInitLibrary();
+}
+
+static void TestDeInitFinishesQueuedAdds() {
+    StandInConfig config;
+    config.manualClock = true;
+    InitLibrary(config);
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_SetFrameBudget(1, 0));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddInfoNotification("uses the budget"));
+
+    std::atomic<uint32_t> staticFinished{0};
+    std::atomic<uint32_t> dynamicFinished{0};
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddInfoNotificationWithCallback("static", OnFinished, &staticFinished));
+    NotificationModuleHandle handle;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotificationWithCallback("dynamic", &handle, OnFinished, &dynamicFinished));
+    CHECK(GetFrameBudgetInfo().queued == 2);
+
+    // The adds are dropped, their owners learn about it through the finish callbacks.
+    NotificationModule_DeInitLibrary();
+    CHECK(staticFinished == 1);
+    CHECK(dynamicFinished == 1);
+    CHECK(StandIn_GetStats().addCalls == 1);
+}
+
+int main() {
+    printf("test_dispatcher\n");
+    RUN_TEST(TestBurstIsSpreadOverFrames);
+    RUN_TEST(TestOperationsOfAHandleStayInOrder);
+    RUN_TEST(TestUpdatesAreCoalesced);
+    RUN_TEST(TestReservedHandleAcceptsUpdates);
+    RUN_TEST(TestFinishIsQueuedWhenTheQueueIsFull);
+    RUN_TEST(TestDeInitFinishesQueuedAdds);
+    return 0;
+}
@@ -0,0 +1,180 @@
+#include "test.h"
+
+#include <atomic>
+#include <string>
+
+// Failure injection of the stand-in and the retry policy of the library (NotificationModule_SetRetryPolicy).
+
+static void OnFinished(NotificationModuleHandle, void *context) {
+    ((std::atomic<uint32_t> *) context)->fetch_add(1);
+}
+
+static void TestInjectedFailureRate() {
+    StandInConfig config;
+    config.addFailureRate = 0.25f;
+    config.seed           = 42;
+    InitLibrary(config);
+
+    uint32_t failures = 0;
+    for (uint32_t i = 0; i < 2000; i++) {
+        auto res = NotificationModule_AddInfoNotification("rate");
+        if (res != NOTIFICATION_MODULE_RESULT_SUCCESS) {
+            CHECK(res == NOTIFICATION_MODULE_RESULT_OVERLAY_NOT_READY);
+            failures++;
+        }
+        StandIn_FadeOutAll();
+    }
+    CHECK(failures == StandIn_GetStats().injectedFailures);
+    CHECK(failures > 400 && failures < 600);
+    NotificationModule_DeInitLibrary();
+}
+
+static void TestInjectedFailuresAreReproducible() {
+    std::string runs[2];
+    for (auto &run : runs) {
+        StandInConfig config;
+        config.addFailureRate = 0.5f;
+        config.seed           = 7;
+        InitLibrary(config);
+        for (uint32_t i = 0; i < 64; i++) {
+            run += NotificationModule_AddInfoNotification("seed") == NOTIFICATION_MODULE_RESULT_SUCCESS ? '1' : '0';
+        }
+        NotificationModule_DeInitLibrary();
+    }
+    CHECK(runs[0] == runs[1]);
+}
+
+static void TestFailuresAreReturnedWithoutPolicy() {
+    StandInConfig config;
+    config.addFailureRate   = 1.0f;
+    config.addFailureStatus = NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED;
+    InitLibrary(config);
+
+    NotificationModuleHandle handle;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED, NotificationModule_AddInfoNotification("direct"));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED, NotificationModule_AddDynamicNotification("direct", &handle));
+    CHECK(StandIn_GetStats().addCalls == 2);
+    NotificationModule_DeInitLibrary();
+}
+
+static void TestRetriedAddsArriveEventually() {
+    StandInConfig config;
+    config.addFailureRate = 0.5f;
+    InitLibrary(config);
+    NMRetryPolicy policy = {20, 1, 4, 0.5f};
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_SetRetryPolicy(&policy));
+
+    for (uint32_t i = 0; i < 200; i++) {
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddInfoNotification("retried"));
+    }
+    CHECK(WaitUntil([] { return StandIn_GetNotifications().size() == 200; }));
+    auto stats = StandIn_GetStats();
+    CHECK(stats.injectedFailures > 0);
+    CHECK(stats.addCalls == 200 + stats.injectedFailures);
+    NotificationModule_DeInitLibrary();
+}
+
+static void TestRetriedDynamicKeepsQueuedOperations() {
+    StandInConfig config;
+    config.addFailureRate = 1.0f;
+    InitLibrary(config);
+    NMRetryPolicy policy = {100, 1, 1, 0.0f};
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_SetRetryPolicy(&policy));
+
+    NotificationModuleHandle handle;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotification("first", &handle));
+    CHECK(handle != 0);
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_UpdateDynamicNotificationText(handle, "second"));
+    CHECK(StandIn_GetNotifications().empty());
+
+    StandIn_SetFaults(0.0f, 0, 0.0f, 0);
+    CHECK(WaitUntil([] { return StandIn_FindNotification("second", nullptr); }));
+    CHECK(StandIn_GetNotifications().size() == 1);
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_FinishDynamicNotification(handle, 0.0f));
+    NotificationModule_DeInitLibrary();
+}
+
+static void TestRetriedInternedAdds() {
+    StandInConfig config;
+    config.exports        = STAND_IN_EXPORT_SHARED_TEXT;
+    config.addFailureRate = 1.0f;
+    InitLibrary(config);
+    NotificationModuleTextId textId;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_InternText("interned", &textId));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_OVERLAY_NOT_READY, NotificationModule_AddInfoNotificationInterned(textId));
+
+    // The shared variant fails like the copying one, the retry is queued with a copy of the text.
+    NMRetryPolicy policy = {100, 1, 1, 0.0f};
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_SetRetryPolicy(&policy));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddErrorNotificationInterned(textId));
+    CHECK(StandIn_GetNotifications().empty());
+
+    StandIn_SetFaults(0.0f, 0, 0.0f, 0);
+    StandInNotification notification;
+    CHECK(WaitUntil([&notification] { return StandIn_FindNotification("interned", &notification); }));
+    CHECK(notification.type == NOTIFICATION_MODULE_NOTIFICATION_TYPE_ERROR);
+    CHECK(StandIn_GetNotifications().size() == 1);
+    NotificationModule_DeInitLibrary();
+}
+
+static void TestExhaustedRetriesCallFinishCallback() {
+    StandInConfig config;
+    config.addFailureRate = 1.0f;
+    InitLibrary(config);
+    NMRetryPolicy policy = {3, 1, 2, 0.0f};
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_SetRetryPolicy(&policy));
+
+    std::atomic<uint32_t> finished{0};
+    NotificationModuleHandle handle;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotificationWithCallback("dropped", &handle, OnFinished, &finished));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddInfoNotificationWithCallback("dropped", OnFinished, &finished));
+    CHECK(WaitUntil([&finished] { return finished == 2; }));
+    CHECK(StandIn_GetStats().addCalls == 6);
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_INVALID_HANDLE, NotificationModule_UpdateDynamicNotificationText(handle, "gone"));
+    NotificationModule_DeInitLibrary();
+}
+
+static void TestSlowCallsDontBreakRetries() {
+    StandInConfig config;
+    config.addFailureRate      = 0.3f;
+    config.callLatencyInUs     = 5;
+    config.slowCallRate        = 0.05f;
+    config.slowCallLatencyInUs = 2000;
+    InitLibrary(config);
+    NMRetryPolicy policy = {30, 1, 2, 0.5f};
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_SetRetryPolicy(&policy));
+
+    NotificationModuleHandle handles[50];
+    for (auto &handle : handles) {
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotification("slow", &handle));
+    }
+    for (auto handle : handles) {
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_UpdateDynamicNotificationText(handle, "done"));
+    }
+    CHECK(WaitUntil([] {
+        auto notifications = StandIn_GetNotifications();
+        if (notifications.size() != 50) {
+            return false;
+        }
+        for (const auto &cur : notifications) {
+            if (cur.text != "done") {
+                return false;
+            }
+        }
+        return true;
+    }));
+    NotificationModule_DeInitLibrary();
+}
+
+int main() {
+    printf("test_fault_injection\n");
+    RUN_TEST(TestInjectedFailureRate);
+    RUN_TEST(TestInjectedFailuresAreReproducible);
+    RUN_TEST(TestFailuresAreReturnedWithoutPolicy);
+    RUN_TEST(TestRetriedAddsArriveEventually);
+    RUN_TEST(TestRetriedDynamicKeepsQueuedOperations);
+    RUN_TEST(TestRetriedInternedAdds);
+    RUN_TEST(TestExhaustedRetriesCallFinishCallback);
+    RUN_TEST(TestSlowCallsDontBreakRetries);
+    return 0;
+}
@@ -0,0 +1,73 @@
+#include "scheduler.h"
+#include "test.h"
+
+#include <atomic>
+
+// Notification groups, driven by the manual clock.
+
+static uint32_t SetFlagTask(void *context, uint64_t) {
+    ((std::atomic<bool> *) context)->store(true);
+    return 0;
+}
+
+// Advances the manual clock and waits until the scheduler thread has run everything that is due.
+static void AdvanceClock(uint64_t microseconds) {
+    StandIn_AdvanceClock(microseconds);
+    std::atomic<bool> ran{false};
+    CHECK(Scheduler_AddTask(SetFlagTask, &ran, 0) != 0);
+    CHECK(WaitUntil([&ran] { return ran.load(); }));
+}
+
+static bool IsFinished(const char *text) {
+    StandInNotification notification;
+    CHECK(StandIn_FindNotification(text, &notification));
+    return notification.finished;
+}
+
+static void TestGroupFadesOutAfterLastMessage() {
+    StandInConfig config;
+    config.manualClock = true;
+    InitLibrary(config);
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_SetDefaultValue(NOTIFICATION_MODULE_NOTIFICATION_TYPE_INFO, NOTIFICATION_MODULE_DEFAULT_OPTION_DURATION_BEFORE_FADE_OUT, 2.0));
+    NotificationModuleGroupHandle group;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_CreateGroup(NOTIFICATION_MODULE_NOTIFICATION_TYPE_INFO, &group));
+
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddNotificationToGroup(group, "Saved"));
+    AdvanceClock(1500000);
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddNotificationToGroup(group, "Saved"));
+    // 3 s after the first message, but only 1.5 s after the second one.
+    AdvanceClock(1500000);
+    CHECK(!IsFinished("Saved (x2)"));
+    AdvanceClock(600000);
+    CHECK(IsFinished("Saved (x2)"));
+
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_DestroyGroup(group));
+    NotificationModule_DeInitLibrary();
+}
+
+// Durations beyond the range of a task delay are clamped instead of wrapping around.
+static void TestLongDurationIsClamped() {
+    StandInConfig config;
+    config.manualClock = true;
+    InitLibrary(config);
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_SetDefaultValue(NOTIFICATION_MODULE_NOTIFICATION_TYPE_INFO, NOTIFICATION_MODULE_DEFAULT_OPTION_DURATION_BEFORE_FADE_OUT, 100000.0));
+    NotificationModuleGroupHandle group;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_CreateGroup(NOTIFICATION_MODULE_NOTIFICATION_TYPE_INFO, &group));
+
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddNotificationToGroup(group, "Long"));
+    AdvanceClock(3600ull * 1000000);
+    CHECK(!IsFinished("Long"));
+    // At most 0xFFFFFFFF us (~71.6 minutes).
+    AdvanceClock(700ull * 1000000);
+    CHECK(IsFinished("Long"));
+
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_DestroyGroup(group));
+    NotificationModule_DeInitLibrary();
+}
+
+int main() {
+    printf("test_groups\n");
+    RUN_TEST(TestGroupFadesOutAfterLastMessage);
+    RUN_TEST(TestLongDurationIsClamped);
+    return 0;
+}
@@ -0,0 +1,214 @@
+#include "handle_table.h"
+#include "test.h"
+
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+// The client side handle table: stale handles are rejected without calling into the module.
+
+#define STRESS_POSITIONS     16
+#define STRESS_NOTIFICATIONS 4000
+#define STRESS_UPDATERS      3
+#define STRESS_FINISHERS     2
+
+static void TestStaleHandlesDontReachModule() {
+    InitLibrary();
+    NotificationModuleHandle handle;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotification("stale", &handle));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_UpdateDynamicNotificationText(handle, "live"));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_FinishDynamicNotification(handle, 0.0f));
+    StandIn_ResetStats();
+
+    // Finished, but still fading out.
+    CHECK(StandIn_GetNotifications().size() == 1);
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_INVALID_HANDLE, NotificationModule_UpdateDynamicNotificationText(handle, "finished"));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_INVALID_HANDLE, NotificationModule_UpdateDynamicNotificationTextColor(handle, {}));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_INVALID_HANDLE, NotificationModule_FinishDynamicNotification(handle, 0.0f));
+
+    // Gone from the overlay.
+    StandIn_FadeOutAll();
+    CHECK(StandIn_GetNotifications().empty());
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_INVALID_HANDLE, NotificationModule_UpdateDynamicNotificationText(handle, "faded out"));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_INVALID_HANDLE, NotificationModule_UpdateDynamicNotificationBackgroundColor(handle, {}));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_INVALID_HANDLE, NotificationModule_FinishDynamicNotification(handle, 0.0f));
+
+    // Values that were never returned by the library.
+    std::mt19937 random(3);
+    for (uint32_t i = 0; i < 1000; i++) {
+        auto garbage = (NotificationModuleHandle) random();
+        if (garbage == 0 || garbage == handle) {
+            continue;
+        }
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_INVALID_HANDLE, NotificationModule_UpdateDynamicNotificationText(garbage, "garbage"));
+    }
+
+    auto stats = StandIn_GetStats();
+    CHECK(stats.updateCalls == 0);
+    CHECK(stats.finishCalls == 0);
+    CHECK(stats.invalidHandles == 0);
+    NotificationModule_DeInitLibrary();
+}
+
+static void TestReusedSlotRejectsOldHandle() {
+    InitLibrary();
+    NotificationModuleHandle oldHandle;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotification("old", &oldHandle));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_FinishDynamicNotification(oldHandle, 0.0f));
+    StandIn_FadeOutAll();
+
+    NotificationModuleHandle newHandle;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotification("new", &newHandle));
+    CHECK(HandleTable_GetSlotIndex(newHandle) == HandleTable_GetSlotIndex(oldHandle));
+    CHECK(newHandle != oldHandle);
+
+    StandIn_ResetStats();
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_INVALID_HANDLE, NotificationModule_UpdateDynamicNotificationText(oldHandle, "from old handle"));
+    CHECK(StandIn_GetStats().updateCalls == 0);
+    CHECK(StandIn_FindNotification("new", nullptr));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_UpdateDynamicNotificationText(newHandle, "from new handle"));
+    CHECK(StandIn_FindNotification("from new handle", nullptr));
+    NotificationModule_DeInitLibrary();
+}
+
+struct StressState {
+    std::atomic<NotificationModuleHandle> positions[STRESS_POSITIONS] = {};
+    std::atomic<bool> done{false};
+    std::atomic<uint32_t> created{0};
+    std::atomic<uint32_t> finished{0};
+    std::atomic<uint32_t> updateSuccesses{0};
+    std::atomic<uint32_t> updateInvalidHandles{0};
+    std::atomic<uint32_t> updatesAfterOwnFinish{0};
+    std::mutex callbackMutex;
+    std::set<NotificationModuleHandle> calledBack;
+};
+
+static void OnStressFinished(NotificationModuleHandle handle, void *context) {
+    auto *state = (StressState *) context;
+    std::lock_guard<std::mutex> lock(state->callbackMutex);
+    // Every notification calls back once, with the handle of the library.
+    CHECK(state->calledBack.insert(handle).second);
+}
+
+static void StressCreator(StressState &state) {
+    uint32_t position = 0;
+    while (state.created < STRESS_NOTIFICATIONS) {
+        position = (position + 1) % STRESS_POSITIONS;
+        if (state.positions[position] != 0) {
+            std::this_thread::yield();
+            continue;
+        }
+        NotificationModuleHandle handle;
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotificationWithCallback("new", &handle, OnStressFinished, &state));
+        state.positions[position] = handle;
+        state.created++;
+    }
+}
+
+static void StressUpdater(StressState &state, uint32_t seed) {
+    std::mt19937 random(seed);
+    char text[32];
+    uint32_t counter = 0;
+    while (!state.done) {
+        NotificationModuleHandle handle = state.positions[random() % STRESS_POSITIONS];
+        if (handle == 0) {
+            continue;
+        }
+        // Texts name the handle they were set through, so updates that end up on another notification are detected.
+        // They are unique across the updaters, the library doesn't send updates that don't change the text.
+        snprintf(text, sizeof(text), "%08x:%u:%u", handle, seed, counter++);
+        auto res = NotificationModule_UpdateDynamicNotificationText(handle, text);
+        if (res == NOTIFICATION_MODULE_RESULT_SUCCESS) {
+            state.updateSuccesses++;
+        } else {
+            CHECK(res == NOTIFICATION_MODULE_RESULT_INVALID_HANDLE);
+            state.updateInvalidHandles++;
+        }
+    }
+}
+
+static void StressFinisher(StressState &state, uint32_t seed) {
+    std::mt19937 random(seed);
+    while (!state.done) {
+        NotificationModuleHandle handle = state.positions[random() % STRESS_POSITIONS].exchange(0);
+        if (handle == 0) {
+            continue;
+        }
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_FinishDynamicNotification(handle, 0.0f));
+        state.finished++;
+        // The slot may already belong to another notification, the old handle must not resolve to it.
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_INVALID_HANDLE, NotificationModule_UpdateDynamicNotificationText(handle, "after finish"));
+        state.updatesAfterOwnFinish++;
+    }
+}
+
+static void TestConcurrentFinishAndUpdate() {
+    StandInConfig config;
+    config.fadeOutImmediately = true;
+    InitLibrary(config);
+
+    StressState state;
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < STRESS_UPDATERS; i++) {
+        threads.emplace_back(StressUpdater, std::ref(state), 100 + i);
+    }
+    for (uint32_t i = 0; i < STRESS_FINISHERS; i++) {
+        threads.emplace_back(StressFinisher, std::ref(state), 200 + i);
+    }
+    StressCreator(state);
+    state.done = true;
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    // No update that passed the library ended up on a different notification.
+    std::set<NotificationModuleHandle> open;
+    for (auto &position : state.positions) {
+        if (position != 0) {
+            open.insert(position);
+        }
+    }
+    auto notifications = StandIn_GetNotifications();
+    CHECK(notifications.size() == open.size());
+    std::set<NotificationModuleHandle> named;
+    for (const auto &cur : notifications) {
+        if (cur.text == "new") {
+            continue;
+        }
+        auto handle = (NotificationModuleHandle) strtoul(cur.text.c_str(), nullptr, 16);
+        CHECK(open.count(handle) == 1);
+        CHECK(named.insert(handle).second);
+    }
+
+    // Every update the module saw either succeeded or raced with a concurrent finish. Everything else, including
+    // every update after the own finish, was rejected by the library.
+    auto stats                 = StandIn_GetStats();
+    uint32_t rejectedByLibrary = state.updateInvalidHandles + state.updatesAfterOwnFinish - stats.invalidHandles;
+    CHECK(stats.updateCalls == state.updateSuccesses + stats.invalidHandles);
+    CHECK(rejectedByLibrary >= state.updatesAfterOwnFinish);
+    printf("    %u updates, %u rejected by the library, %u rejected by the module\n",
+           state.updateSuccesses + state.updateInvalidHandles + state.updatesAfterOwnFinish,
+           rejectedByLibrary,
+           stats.invalidHandles);
+
+    for (auto handle : open) {
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_FinishDynamicNotification(handle, 0.0f));
+    }
+    CHECK(state.calledBack.size() == STRESS_NOTIFICATIONS);
+    CHECK(state.finished + open.size() == STRESS_NOTIFICATIONS);
+    CHECK(HandleTable_GetUsedCount() == 0);
+    NotificationModule_DeInitLibrary();
+}
+
+int main() {
+    printf("test_handle_table\n");
+    RUN_TEST(TestStaleHandlesDontReachModule);
+    RUN_TEST(TestReusedSlotRejectsOldHandle);
+    RUN_TEST(TestConcurrentFinishAndUpdate);
+    return 0;
+}
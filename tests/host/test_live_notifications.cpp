@@ -0,0 +1,55 @@
+#include "scheduler.h"
+#include "test.h"
+
+#include <atomic>
+
+// Live notifications, driven by the manual clock.
+
+static uint32_t SetFlagTask(void *context, uint64_t) {
+    ((std::atomic<bool> *) context)->store(true);
+    return 0;
+}
+
+// Advances the manual clock and waits until the scheduler thread has run everything that is due.
+static void AdvanceClock(uint64_t microseconds) {
+    StandIn_AdvanceClock(microseconds);
+    std::atomic<bool> ran{false};
+    CHECK(Scheduler_AddTask(SetFlagTask, &ran, 0) != 0);
+    CHECK(WaitUntil([&ran] { return ran.load(); }));
+}
+
+// Returns the number of samples taken so far, including this one.
+static double CountSamples(void *context) {
+    return (double) ++*(std::atomic<uint32_t> *) context;
+}
+
+// Samples stay on the grid of the period even if the task runs late, missed periods are skipped.
+static void TestSamplesFollowThePeriod() {
+    StandInConfig config;
+    config.manualClock = true;
+    InitLibrary(config);
+    std::atomic<uint32_t> samples{0};
+    NotificationModuleHandle handle;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddLiveNotification(CountSamples, &samples, 100, "%.0f samples", &handle));
+    CHECK(samples == 1);
+
+    // Late by 2.5 periods: one sample, the next one is due at 400 ms (not at 350 + 100 ms).
+    AdvanceClock(350000);
+    CHECK(samples == 2);
+    AdvanceClock(60000);
+    CHECK(samples == 3);
+    AdvanceClock(80000);
+    CHECK(samples == 3);
+    AdvanceClock(20000);
+    CHECK(samples == 4);
+    CHECK(StandIn_FindNotification("4 samples", nullptr));
+
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_FinishDynamicNotification(handle, 0.0f));
+    NotificationModule_DeInitLibrary();
+}
+
+int main() {
+    printf("test_live_notifications\n");
+    RUN_TEST(TestSamplesFollowThePeriod);
+    return 0;
+}
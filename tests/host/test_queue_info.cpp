@@ -0,0 +1,125 @@
+#include "test.h"
+
+#include <cstring>
+
+// NotificationModule_GetQueueInfo and NotificationModule_GetThrottleDelay, with NMGetQueueInfo and estimated.
+
+static void TestUninitialized() {
+    NMQueueInfo info;
+    uint32_t delay;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED, NotificationModule_GetQueueInfo(&info));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED, NotificationModule_GetThrottleDelay(&delay));
+    InitLibrary();
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT, NotificationModule_GetQueueInfo(nullptr));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT, NotificationModule_GetThrottleDelay(nullptr));
+    NotificationModule_DeInitLibrary();
+}
+
+static void TestReportedByModule() {
+    StandInConfig config;
+    config.exports         = STAND_IN_EXPORT_QUEUE_INFO | STAND_IN_EXPORT_IS_OVERLAY_READY;
+    config.overlayReady    = false;
+    config.capacityInBytes = 4096;
+    InitLibrary(config);
+
+    NotificationModuleHandle handle;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddInfoNotification("first"));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddErrorNotification("second"));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotification("third", &handle));
+
+    NMQueueInfo info;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_GetQueueInfo(&info));
+    CHECK(!info.isEstimate);
+    CHECK(info.pending == 3 && info.visible == 0);
+    CHECK(info.bytesUsed == strlen("first") + strlen("second") + strlen("third") + 3);
+    CHECK(info.capacityInBytes == 4096);
+
+    StandIn_SetOverlayReady(true);
+    StandIn_RunFrame();
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_GetQueueInfo(&info));
+    CHECK(info.pending == 0 && info.visible == 3);
+
+    StandIn_FadeOutAll();
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_GetQueueInfo(&info));
+    CHECK(info.visible == 1 && info.bytesUsed == strlen("third") + 1);
+    NotificationModule_DeInitLibrary();
+}
+
+static void TestThrottleDelayFollowsModule() {
+    StandInConfig config;
+    config.exports         = STAND_IN_EXPORT_QUEUE_INFO | STAND_IN_EXPORT_IS_OVERLAY_READY;
+    config.capacityInBytes = 1000;
+    InitLibrary(config);
+
+    uint32_t delay;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_GetThrottleDelay(&delay));
+    CHECK(delay == 0);
+
+    // 99 bytes each, the delay starts once half of the capacity is used and grows with the load.
+    char text[99];
+    memset(text, 'q', sizeof(text) - 1);
+    text[sizeof(text) - 1] = '\0';
+    uint32_t lastDelay     = 0;
+    for (uint32_t i = 0; i < 10; i++) {
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddInfoNotification(text));
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_GetThrottleDelay(&delay));
+        CHECK(delay >= lastDelay);
+        if (i < 5) {
+            CHECK(delay == 0);
+        }
+        lastDelay = delay;
+    }
+    CHECK(delay > 0 && delay < 1000);
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_ALLOCATION_FAILED, NotificationModule_AddInfoNotification(text));
+
+    StandIn_FadeOutAll();
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_GetThrottleDelay(&delay));
+    CHECK(delay == 0);
+
+    // Pending notifications count as load on their own.
+    StandIn_SetOverlayReady(false);
+    for (uint32_t i = 0; i < 8; i++) {
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddInfoNotification("p"));
+    }
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_GetThrottleDelay(&delay));
+    CHECK(delay == 1000);
+    NotificationModule_DeInitLibrary();
+}
+
+static void TestEstimatedWithoutExport() {
+    StandInConfig config;
+    config.exports     = STAND_IN_EXPORT_IS_OVERLAY_READY;
+    config.manualClock = true;
+    InitLibrary(config);
+
+    NotificationModuleHandle handle;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddInfoNotification("first"));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddErrorNotification("second"));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotification("third", &handle));
+
+    NMQueueInfo info;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_GetQueueInfo(&info));
+    CHECK(info.isEstimate);
+    CHECK(info.visible == 3 && info.pending == 0);
+    CHECK(info.bytesUsed > 0 && info.bytesUsed < info.capacityInBytes);
+
+    StandIn_SetOverlayReady(false);
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_GetQueueInfo(&info));
+    CHECK(info.visible == 0 && info.pending == 3);
+    StandIn_SetOverlayReady(true);
+
+    // Static notifications are assumed to be gone after their fade out time, dynamic ones until they are finished.
+    StandIn_AdvanceClock(60 * 1000000ULL);
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_GetQueueInfo(&info));
+    CHECK(info.visible == 1);
+    NotificationModule_DeInitLibrary();
+}
+
+int main() {
+    printf("test_queue_info\n");
+    RUN_TEST(TestUninitialized);
+    RUN_TEST(TestReportedByModule);
+    RUN_TEST(TestThrottleDelayFollowsModule);
+    RUN_TEST(TestEstimatedWithoutExport);
+    return 0;
+}
@@ -0,0 +1,245 @@
+#include "test.h"
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+// Updates and finishes through the shared ring (source/shared_ring.h), consumed by the stand-in.
+
+#define RING_EXPORTS (STAND_IN_EXPORT_SHARED_RING | STAND_IN_EXPORT_UPDATE | STAND_IN_EXPORT_SHARED_TEXT | STAND_IN_EXPORT_BATCH)
+
+static StandInConfig RingConfig() {
+    StandInConfig config;
+    config.exports = RING_EXPORTS;
+    return config;
+}
+
+static std::string GetText(NotificationModuleHandle handle) {
+    for (const auto &cur : StandIn_GetNotifications()) {
+        if (cur.handle == handle) {
+            return cur.text;
+        }
+    }
+    return "<gone>";
+}
+
+// The library handles are not the module handles, the stand-in is looked up by text.
+static NotificationModuleHandle GetModuleHandle(const char *text) {
+    StandInNotification notification;
+    CHECK(StandIn_FindNotification(text, &notification));
+    return notification.handle;
+}
+
+static void TestUpdatesAreConsumedPerFrame() {
+    InitLibrary(RingConfig());
+    NotificationModuleHandle handle;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotification("ring 0", &handle));
+    auto moduleHandle = GetModuleHandle("ring 0");
+
+    StandIn_ResetStats();
+    char text[32];
+    for (uint32_t i = 1; i <= 10; i++) {
+        snprintf(text, sizeof(text), "ring %u", i);
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_UpdateDynamicNotificationText(handle, text));
+    }
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_UpdateDynamicNotificationTextColor(handle, {1, 2, 3, 4}));
+    // Nothing has been called yet, the module reads the ring on its next frame.
+    CHECK(StandIn_GetStats().moduleCalls == 0);
+    CHECK(GetText(moduleHandle) == "ring 0");
+
+    StandIn_RunFrame();
+    auto stats = StandIn_GetStats();
+    CHECK(stats.ringRecords == 11);
+    CHECK(stats.moduleCalls == 0);
+    // Inline texts are read in place.
+    CHECK(stats.bytesCopied == 0);
+    StandInNotification notification;
+    CHECK(StandIn_FindNotification("ring 10", &notification));
+    CHECK(notification.textColor.r == 1 && notification.textColor.a == 4);
+    NotificationModule_DeInitLibrary();
+}
+
+static void CountFinished(NotificationModuleHandle, void *context) {
+    ((std::atomic<uint32_t> *) context)->fetch_add(1);
+}
+
+static void TestFinishThroughRingCallsCallback() {
+    StandInConfig config = RingConfig();
+    config.manualClock   = true;
+    std::atomic<uint32_t> finished{0};
+    InitLibrary(config);
+    NotificationModuleHandle handle;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotificationWithCallback("finish", &handle, CountFinished, &finished));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_UpdateDynamicNotificationText(handle, "finished"));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_FinishDynamicNotification(handle, 1.0f));
+    CHECK(StandIn_GetStats().finishCalls == 0);
+
+    StandIn_RunFrame();
+    StandInNotification notification;
+    CHECK(StandIn_FindNotification("finished", &notification));
+    CHECK(notification.finished);
+    CHECK(finished == 0);
+    StandIn_AdvanceClock(1100000);
+    StandIn_RunFrame();
+    CHECK(finished == 1);
+    CHECK(StandIn_GetNotifications().empty());
+    NotificationModule_DeInitLibrary();
+}
+
+static void TestFullRingIsProcessedByLibrary() {
+    InitLibrary(RingConfig());
+    NotificationModuleHandle handle;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotification("full", &handle));
+    auto moduleHandle = GetModuleHandle("full");
+
+    // Much more than SHARED_RING_CAPACITY without a single frame.
+    std::string text(200, 'x');
+    for (uint32_t i = 0; i < 1000; i++) {
+        text[0] = 'a' + i % 26;
+        text[1] = 'a' + (i / 26) % 26;
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_UpdateDynamicNotificationText(handle, text.c_str()));
+    }
+    auto stats = StandIn_GetStats();
+    CHECK(stats.ringProcessCalls > 0);
+    StandIn_RunFrame();
+    CHECK(StandIn_GetStats().ringRecords >= 1000);
+    CHECK(GetText(moduleHandle) == text);
+    NotificationModule_DeInitLibrary();
+}
+
+static void TestOrderWithDirectCalls() {
+    InitLibrary(RingConfig());
+    NotificationModuleHandle handle;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotification("order", &handle));
+    auto moduleHandle = GetModuleHandle("order");
+
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_UpdateDynamicNotificationText(handle, "small"));
+    // Doesn't fit into a record, it's sent with the export after the ring has been consumed.
+    std::string large(6000, 'L');
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_UpdateDynamicNotificationText(handle, large.c_str()));
+    CHECK(GetText(moduleHandle) == large);
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_UpdateDynamicNotificationText(handle, "small again"));
+
+    // Batch exports sync the ring first.
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_TagHandle(handle, 7));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_FinishAllWithTag(7, 5.0f));
+    StandInNotification notification;
+    CHECK(StandIn_FindNotification("small again", &notification));
+    CHECK(notification.finished);
+    CHECK(StandIn_GetStats().batchCalls == 1);
+    NotificationModule_DeInitLibrary();
+}
+
+static void TestInternedTextsAreShared() {
+    InitLibrary(RingConfig());
+    NotificationModuleTextId textId;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_InternText("interned", &textId));
+    NotificationModuleHandle handle;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotification("not interned", &handle));
+    StandIn_ResetStats();
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_UpdateDynamicNotificationTextInterned(handle, textId));
+    StandIn_RunFrame();
+    CHECK(StandIn_FindNotification("interned", nullptr));
+    auto stats = StandIn_GetStats();
+    CHECK(stats.ringRecords == 1);
+    CHECK(stats.bytesCopied == 0);
+    NotificationModule_DeInitLibrary();
+}
+
+static NotificationModuleHandle sOtherHandle;
+static std::atomic<NotificationModuleStatus> sCallbackResult;
+
+static void UpdateOtherOnFinish(NotificationModuleHandle, void *) {
+    sCallbackResult = NotificationModule_UpdateDynamicNotificationText(sOtherHandle, "from callback");
+}
+
+// NMProcessSharedRing is called while the library fills the ring, the finish callbacks it calls may use the library.
+static void TestCallbackDuringProcessing() {
+    StandInConfig config      = RingConfig();
+    config.fadeOutImmediately = true;
+    InitLibrary(config);
+    NotificationModuleHandle finishing;
+    NotificationModuleHandle filler;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotificationWithCallback("finishing", &finishing, UpdateOtherOnFinish, nullptr));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotification("other", &sOtherHandle));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotification("filler", &filler));
+    sCallbackResult = NOTIFICATION_MODULE_RESULT_UNKNOWN_ERROR;
+
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_FinishDynamicNotification(finishing, 0.0f));
+    std::string text(500, 'f');
+    for (uint32_t i = 0; i < 100; i++) {
+        text[0] = 'a' + i % 26;
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_UpdateDynamicNotificationText(filler, text.c_str()));
+    }
+    CHECK(sCallbackResult == NOTIFICATION_MODULE_RESULT_SUCCESS);
+    StandIn_RunFrame();
+    CHECK(StandIn_FindNotification("from callback", nullptr));
+    NotificationModule_DeInitLibrary();
+}
+
+static void TestConcurrentProducersWithRenderThread() {
+    InitLibrary(RingConfig());
+    StandIn_StartRenderThread(1000, 100);
+    std::vector<std::thread> threads;
+    NotificationModuleHandle handles[4];
+    for (uint32_t t = 0; t < 4; t++) {
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotification("producer", &handles[t]));
+        threads.emplace_back([t, handle = handles[t]] {
+            char text[32];
+            for (uint32_t i = 0; i <= 5000; i++) {
+                snprintf(text, sizeof(text), "producer %u: %u", t, i);
+                CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_UpdateDynamicNotificationText(handle, text));
+            }
+            CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_FinishDynamicNotification(handle, 10.0f));
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    StandIn_StopRenderThread();
+    StandIn_RunFrame();
+    char text[32];
+    for (uint32_t t = 0; t < 4; t++) {
+        snprintf(text, sizeof(text), "producer %u: 5000", t);
+        StandInNotification notification;
+        CHECK(StandIn_FindNotification(text, &notification));
+        CHECK(notification.finished);
+    }
+    NotificationModule_DeInitLibrary();
+}
+
+// The stand-in aborts if the ring is detached while it still has records.
+static void TestDeinitConsumesRemainingRecords() {
+    InitLibrary(RingConfig());
+    NotificationModuleHandle handle;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotification("before deinit", &handle));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_UpdateDynamicNotificationText(handle, "last update"));
+    NotificationModule_DeInitLibrary();
+    StandInNotification notification;
+    CHECK(StandIn_FindNotification("last update", &notification));
+    CHECK(notification.finished);
+}
+
+static void TestWithoutRingExportsAreCalled() {
+    InitLibrary();
+    NotificationModuleHandle handle;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotification("direct", &handle));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_UpdateDynamicNotificationText(handle, "direct update"));
+    CHECK(StandIn_FindNotification("direct update", nullptr));
+    CHECK(StandIn_GetStats().ringProcessCalls == 0);
+    NotificationModule_DeInitLibrary();
+}
+
+int main() {
+    printf("test_shared_ring\n");
+    RUN_TEST(TestUpdatesAreConsumedPerFrame);
+    RUN_TEST(TestFinishThroughRingCallsCallback);
+    RUN_TEST(TestFullRingIsProcessedByLibrary);
+    RUN_TEST(TestOrderWithDirectCalls);
+    RUN_TEST(TestInternedTextsAreShared);
+    RUN_TEST(TestCallbackDuringProcessing);
+    RUN_TEST(TestConcurrentProducersWithRenderThread);
+    RUN_TEST(TestDeinitConsumesRemainingRecords);
+    RUN_TEST(TestWithoutRingExportsAreCalled);
+    return 0;
+}
@@ -0,0 +1,268 @@
+#include "scheduler.h"
+#include "test.h"
+
+#include <atomic>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+// Stats files written by NotificationModule_StartStatsExport and converted by tools/nmstats2csv.py.
+
+#define NUM_STATUSES     13
+#define NUM_BUCKETS      6
+#define NUM_VALUES       (4 + NUM_STATUSES + NUM_BUCKETS)
+#define HEADER_SIZE      (16 + (NUM_STATUSES + NUM_BUCKETS) * 4)
+#define RECORD_SIZE      (12 + NUM_VALUES * 4)
+#define INTERVAL_IN_MS   100
+// Indices in the status list of the header.
+#define STATUS_SUCCESS   0
+#define STATUS_NOT_READY 7
+#define STATUS_QUOTA     11
+
+static char sTempDir[] = "/tmp/nmstatsXXXXXX";
+
+static std::string TempPath(const char *name) {
+    return std::string(sTempDir) + "/" + name;
+}
+
+static std::string ReadFile(const std::string &path) {
+    FILE *f = fopen(path.c_str(), "rb");
+    CHECK(f != nullptr);
+    std::string content;
+    char buffer[4096];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), f)) > 0) {
+        content.append(buffer, read);
+    }
+    fclose(f);
+    return content;
+}
+
+static uint32_t ReadBE32(const std::string &data, size_t offset) {
+    CHECK(offset + 4 <= data.size());
+    return ((uint32_t) (uint8_t) data[offset] << 24) | ((uint32_t) (uint8_t) data[offset + 1] << 16) |
+           ((uint32_t) (uint8_t) data[offset + 2] << 8) | (uint32_t) (uint8_t) data[offset + 3];
+}
+
+static uint16_t ReadBE16(const std::string &data, size_t offset) {
+    return (uint16_t) (ReadBE32(data, offset) >> 16);
+}
+
+struct StatsRecord {
+    uint64_t timestampInUs;
+    uint32_t values[NUM_VALUES]; // calls, failures, suppressed, coalesced, per status, per latency bucket
+};
+
+// Checks the header at `offset` and reads the records that follow it, up to the next header.
+static std::vector<StatsRecord> ParseExport(const std::string &data, size_t &offset) {
+    CHECK(data.compare(offset, 4, "NMSH") == 0);
+    CHECK(ReadBE16(data, offset + 4) == 1);
+    CHECK(ReadBE16(data, offset + 6) == NUM_STATUSES);
+    CHECK(ReadBE16(data, offset + 8) == NUM_BUCKETS);
+    CHECK(ReadBE16(data, offset + 10) == 0);
+    CHECK(ReadBE32(data, offset + 12) == INTERVAL_IN_MS * 1000);
+    CHECK((int32_t) ReadBE32(data, offset + 16) == NOTIFICATION_MODULE_RESULT_SUCCESS);
+    CHECK((int32_t) ReadBE32(data, offset + 16 + STATUS_NOT_READY * 4) == NOTIFICATION_MODULE_RESULT_OVERLAY_NOT_READY);
+    CHECK((int32_t) ReadBE32(data, offset + 16 + STATUS_QUOTA * 4) == NOTIFICATION_MODULE_RESULT_QUOTA_EXCEEDED);
+    CHECK((int32_t) ReadBE32(data, offset + 16 + (NUM_STATUSES - 1) * 4) == NOTIFICATION_MODULE_RESULT_UNKNOWN_ERROR);
+    CHECK(ReadBE32(data, offset + 16 + NUM_STATUSES * 4) == 10);
+    CHECK(ReadBE32(data, offset + HEADER_SIZE - 4) == 0xFFFFFFFF);
+    offset += HEADER_SIZE;
+
+    std::vector<StatsRecord> records;
+    while (offset < data.size() && data.compare(offset, 4, "NMSR") == 0) {
+        CHECK(offset + RECORD_SIZE <= data.size());
+        StatsRecord record;
+        record.timestampInUs = ((uint64_t) ReadBE32(data, offset + 4) << 32) | ReadBE32(data, offset + 8);
+        for (uint32_t i = 0; i < NUM_VALUES; i++) {
+            record.values[i] = ReadBE32(data, offset + 12 + i * 4);
+        }
+        records.push_back(record);
+        offset += RECORD_SIZE;
+    }
+    return records;
+}
+
+// Runs nmstats2csv.py and returns the rows, the header row included.
+static std::vector<std::vector<std::string>> ConvertToCsv(const std::string &statsPath, bool delta) {
+    auto csvPath        = TempPath(delta ? "delta.csv" : "totals.csv");
+    std::string command = "python3 " NM_HOST_TOOLS_DIR "/nmstats2csv.py " + statsPath + " " + csvPath + (delta ? " --delta" : "");
+    CHECK(system(command.c_str()) == 0);
+    std::vector<std::vector<std::string>> rows;
+    std::istringstream lines(ReadFile(csvPath));
+    std::string line;
+    while (std::getline(lines, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        std::vector<std::string> row;
+        std::istringstream cells(line);
+        std::string cell;
+        while (std::getline(cells, cell, ',')) {
+            row.push_back(cell);
+        }
+        CHECK(row.size() == 2 + NUM_VALUES);
+        rows.push_back(row);
+    }
+    return rows;
+}
+
+static uint32_t SetFlagTask(void *context, uint64_t) {
+    ((std::atomic<bool> *) context)->store(true);
+    return 0;
+}
+
+// Advances the manual clock and waits until the scheduler thread has run everything that is due.
+static void AdvanceClock(uint64_t microseconds) {
+    StandIn_AdvanceClock(microseconds);
+    std::atomic<bool> ran{false};
+    CHECK(Scheduler_AddTask(SetFlagTask, &ran, 0) != 0);
+    CHECK(WaitUntil([&ran] { return ran.load(); }));
+}
+
+static void TestInvalidArguments() {
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED, NotificationModule_StartStatsExport(TempPath("uninitialized.nms").c_str(), INTERVAL_IN_MS));
+    InitLibrary();
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT, NotificationModule_StartStatsExport(nullptr, INTERVAL_IN_MS));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT, NotificationModule_StartStatsExport("", INTERVAL_IN_MS));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT, NotificationModule_StartStatsExport(TempPath("short.nms").c_str(), INTERVAL_IN_MS - 1));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_StopStatsExport());
+    NotificationModule_DeInitLibrary();
+    CHECK(access(TempPath("short.nms").c_str(), F_OK) != 0);
+}
+
+// Successful, failing and suppressed calls end up in the file and in the CSV, one record per interval.
+static void TestExportAndConvert() {
+    StandInConfig config;
+    config.manualClock = true;
+    InitLibrary(config);
+    auto path = TempPath("export.nms");
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_StartStatsExport(path.c_str(), INTERVAL_IN_MS));
+
+    // Record 1: 3 successful adds, 2 adds the module rejects and 1 add that is suppressed by the quota of a context.
+    for (uint32_t i = 0; i < 3; i++) {
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddInfoNotification("success"));
+    }
+    StandIn_SetFaults(1.0f, 0, 0.0f, 0);
+    for (uint32_t i = 0; i < 2; i++) {
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_OVERLAY_NOT_READY, NotificationModule_AddInfoNotification("failure"));
+    }
+    StandIn_SetFaults(0.0f, 0, 0.0f, 0);
+    NMContextQuota quota = {};
+    quota.maxInFlight    = 1;
+    NotificationModuleContextHandle context;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_CreateContext("stats", &quota, &context));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddInfoNotificationInContext(context, "in context"));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_QUOTA_EXCEEDED, NotificationModule_AddInfoNotificationInContext(context, "suppressed"));
+    // Late enough that the record is written before the flag task runs.
+    AdvanceClock(INTERVAL_IN_MS * 1000 + 50000);
+
+    // Record 2 is written by NotificationModule_StopStatsExport.
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddInfoNotification("after the first record"));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_StopStatsExport());
+    // Stopping twice doesn't write anything.
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_StopStatsExport());
+
+    auto data     = ReadFile(path);
+    size_t offset = 0;
+    auto records  = ParseExport(data, offset);
+    CHECK(offset == data.size());
+    CHECK(data.size() == HEADER_SIZE + 3 * RECORD_SIZE);
+    CHECK(records.size() == 3);
+    const uint32_t expected[3][5] = {
+            // calls, failures, suppressed, coalesced, OVERLAY_NOT_READY
+            {0, 0, 0, 0, 0},
+            {6, 2, 1, 0, 2},
+            {7, 2, 1, 0, 2},
+    };
+    for (uint32_t i = 0; i < 3; i++) {
+        const auto &values = records[i].values;
+        CHECK(values[0] == expected[i][0]);
+        CHECK(values[1] == expected[i][1]);
+        CHECK(values[2] == expected[i][2]);
+        CHECK(values[3] == expected[i][3]);
+        CHECK(values[4 + STATUS_SUCCESS] == expected[i][0] - expected[i][1]);
+        CHECK(values[4 + STATUS_NOT_READY] == expected[i][4]);
+        // Quota rejections never reach the module.
+        CHECK(values[4 + STATUS_QUOTA] == 0);
+        // The manual clock doesn't move during the calls, all of them are in the lowest latency bucket.
+        CHECK(values[4 + NUM_STATUSES] == expected[i][0]);
+    }
+    CHECK(records[1].timestampInUs - records[0].timestampInUs >= INTERVAL_IN_MS * 1000);
+    CHECK(records[2].timestampInUs >= records[1].timestampInUs);
+
+    auto totals = ConvertToCsv(path, false);
+    CHECK(totals.size() == 4);
+    CHECK(totals[0][0] == "export" && totals[0][1] == "timestamp_us" && totals[0][2] == "calls" && totals[0][3] == "failures");
+    CHECK(totals[0][4] == "suppressed" && totals[0][5] == "coalesced" && totals[0][6] == "status_SUCCESS");
+    CHECK(totals[0][6 + STATUS_NOT_READY] == "status_OVERLAY_NOT_READY");
+    CHECK(totals[0][6 + NUM_STATUSES] == "latency_lt_10us");
+    CHECK(totals[0][1 + NUM_VALUES] == "latency_ge_100000us");
+    for (uint32_t i = 0; i < 3; i++) {
+        const auto &row = totals[i + 1];
+        CHECK(row[0] == "0");
+        CHECK(row[1] == std::to_string(records[i].timestampInUs));
+        for (uint32_t j = 0; j < NUM_VALUES; j++) {
+            CHECK(row[2 + j] == std::to_string(records[i].values[j]));
+        }
+    }
+
+    auto deltas = ConvertToCsv(path, true);
+    CHECK(deltas.size() == 4);
+    CHECK(deltas[0] == totals[0]);
+    for (uint32_t i = 0; i < 3; i++) {
+        const auto &row = deltas[i + 1];
+        CHECK(row[1] == std::to_string(records[i].timestampInUs));
+        for (uint32_t j = 0; j < NUM_VALUES; j++) {
+            uint32_t delta = i == 0 ? 0 : records[i].values[j] - records[i - 1].values[j];
+            CHECK(row[2 + j] == std::to_string(delta));
+        }
+    }
+    CHECK(deltas[2][2] == "6" && deltas[2][3] == "2" && deltas[2][4] == "1");
+    CHECK(deltas[3][2] == "1" && deltas[3][3] == "0" && deltas[3][4] == "0");
+
+    // Frees the in-flight record of the notification in the context.
+    StandIn_FadeOutAll();
+    NotificationModule_DestroyContext(context);
+    NotificationModule_DeInitLibrary();
+}
+
+// A second export appends its own header to the same file, the counters continue.
+static void TestSeveralExportsInOneFile() {
+    StandInConfig config;
+    config.manualClock = true;
+    InitLibrary(config);
+    auto path = TempPath("appended.nms");
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_StartStatsExport(path.c_str(), INTERVAL_IN_MS));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddInfoNotification("first"));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_StartStatsExport(path.c_str(), INTERVAL_IN_MS));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddInfoNotification("second"));
+    // Stopped and flushed by the deinit.
+    NotificationModule_DeInitLibrary();
+
+    auto data     = ReadFile(path);
+    size_t offset = 0;
+    auto first    = ParseExport(data, offset);
+    auto second   = ParseExport(data, offset);
+    CHECK(offset == data.size());
+    CHECK(first.size() == 2 && second.size() == 2);
+    CHECK(first[0].values[0] == 0 && first[1].values[0] == 1);
+    CHECK(second[0].values[0] == 1 && second[1].values[0] == 2);
+
+    auto deltas = ConvertToCsv(path, true);
+    CHECK(deltas.size() == 5);
+    CHECK(deltas[1][0] == "0" && deltas[2][0] == "0" && deltas[3][0] == "1" && deltas[4][0] == "1");
+    // Deltas start over with every export.
+    CHECK(deltas[2][2] == "1" && deltas[3][2] == "0" && deltas[4][2] == "1");
+}
+
+int main() {
+    printf("test_stats\n");
+    CHECK(mkdtemp(sTempDir) != nullptr);
+    RUN_TEST(TestInvalidArguments);
+    RUN_TEST(TestExportAndConvert);
+    RUN_TEST(TestSeveralExportsInOneFile);
+    CHECK(system((std::string("rm -r ") + sTempDir).c_str()) == 0);
+    return 0;
+}
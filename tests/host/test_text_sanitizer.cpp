@@ -0,0 +1,231 @@
+#include "test.h"
+#include "text_sanitizer.h"
+
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+// SanitizedText against a straightforward reference implementation, with fixed cases and random (fuzzed) input.
+
+#define FUZZ_SEED       0x5EED
+#define FUZZ_ITERATIONS 300000
+
+// Length of the valid UTF-8 sequence at `i`, or 0. Decodes the code point instead of checking byte ranges.
+static uint32_t ReferenceSequenceLength(const std::string &text, size_t i) {
+    auto lead = (uint8_t) text[i];
+    uint32_t length;
+    uint32_t codePoint;
+    uint32_t minCodePoint;
+    if (lead < 0x80) {
+        return 1;
+    } else if ((lead & 0xE0) == 0xC0) {
+        length       = 2;
+        codePoint    = lead & 0x1F;
+        minCodePoint = 0x80;
+    } else if ((lead & 0xF0) == 0xE0) {
+        length       = 3;
+        codePoint    = lead & 0x0F;
+        minCodePoint = 0x800;
+    } else if ((lead & 0xF8) == 0xF0) {
+        length       = 4;
+        codePoint    = lead & 0x07;
+        minCodePoint = 0x10000;
+    } else {
+        return 0;
+    }
+    if (i + length > text.size()) {
+        return 0;
+    }
+    for (uint32_t j = 1; j < length; j++) {
+        auto cur = (uint8_t) text[i + j];
+        if ((cur & 0xC0) != 0x80) {
+            return 0;
+        }
+        codePoint = (codePoint << 6) | (cur & 0x3F);
+    }
+    if (codePoint < minCodePoint || codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF)) {
+        return 0;
+    }
+    return length;
+}
+
+// Every invalid byte becomes U+FFFD, texts with more than `maxCodePoints` code points are cut and end with "...".
+static std::string ReferenceSanitize(const std::string &text, uint32_t maxCodePoints) {
+    std::vector<std::string> codePoints;
+    for (size_t i = 0; i < text.size();) {
+        uint32_t length = ReferenceSequenceLength(text, i);
+        if (length == 0) {
+            codePoints.push_back("\xEF\xBF\xBD");
+            i++;
+        } else {
+            codePoints.push_back(text.substr(i, length));
+            i += length;
+        }
+    }
+    size_t keep   = codePoints.size();
+    bool ellipsis = false;
+    if (maxCodePoints != 0 && codePoints.size() > maxCodePoints) {
+        ellipsis = maxCodePoints > 3;
+        keep     = ellipsis ? maxCodePoints - 3 : maxCodePoints;
+    }
+    std::string result;
+    for (size_t i = 0; i < keep; i++) {
+        result += codePoints[i];
+    }
+    if (ellipsis) {
+        result += "...";
+    }
+    return result;
+}
+
+static void CheckSanitized(const std::string &text, uint32_t maxCodePoints) {
+    TextSanitizer_SetMaxLength(maxCodePoints);
+    SanitizedText sanitized(text.c_str());
+    CHECK(sanitized.c_str() != nullptr);
+    std::string expected = ReferenceSanitize(text, maxCodePoints);
+    if (sanitized.c_str() != expected) {
+        fprintf(stderr, "max %u, input:", maxCodePoints);
+        for (auto c : text) {
+            fprintf(stderr, " %02x", (uint8_t) c);
+        }
+        fprintf(stderr, "\nexpected: %s\nactual:   %s\n", expected.c_str(), sanitized.c_str());
+        CHECK(false);
+    }
+    // Texts that don't need any change are passed through without a copy.
+    CHECK((sanitized.c_str() == text.c_str()) == (expected == text));
+
+    // The result is valid and short enough, sanitizing it again doesn't change it.
+    SanitizedText again(sanitized.c_str());
+    CHECK(again.c_str() == sanitized.c_str());
+}
+
+static void TestFixedCases() {
+    const char *cases[] = {
+            "",
+            "Plain ASCII text that is longer than a word",
+            "H\xC3\xA4llo w\xC3\xB6rld \xE2\x9C\x93 \xF0\x9D\x84\x9E",
+            "\xC0\x80",              // Overlong NUL
+            "\xC1\xBF",              // Overlong
+            "\xE0\x80\x80",          // Overlong
+            "\xE0\x9F\xBF",          // Overlong
+            "\xF0\x80\x80\x80",      // Overlong
+            "\xF0\x8F\xBF\xBF",      // Overlong
+            "\xED\xA0\x80",          // Surrogate U+D800
+            "\xED\xBF\xBF",          // Surrogate U+DFFF
+            "\xED\x9F\xBF",          // U+D7FF, valid
+            "\xEF\xBF\xBF",          // U+FFFF, valid
+            "\xF4\x8F\xBF\xBF",      // U+10FFFF, valid
+            "\xF4\x90\x80\x80",      // Above U+10FFFF
+            "\xF5\x80\x80\x80",      // Invalid lead byte
+            "\xFF\xFE",              // Invalid bytes
+            "\x80 lone continuation",
+            "abc\xC3",               // Truncated at the end
+            "abc\xE2\x9C",           // Truncated at the end
+            "abc\xF0\x9D\x84",       // Truncated at the end
+            "abc\xE2\x9C" "def",     // Truncated in the middle
+            "1234567\xC3\xA4" "89",  // Multi byte sequence across a word boundary
+    };
+    for (const char *text : cases) {
+        for (uint32_t maxCodePoints = 0; maxCodePoints < 16; maxCodePoints++) {
+            CheckSanitized(text, maxCodePoints);
+        }
+    }
+
+    TextSanitizer_SetMaxLength(0);
+    SanitizedText nullText(nullptr);
+    CHECK(nullText.c_str() == nullptr);
+}
+
+static void TestLongTexts() {
+    // Longer than TEXT_SANITIZER_STACK_BUFFER_SIZE, so the result is allocated.
+    std::string text;
+    for (uint32_t i = 0; i < 300; i++) {
+        text += i % 7 == 0 ? "\xFF" : (i % 5 == 0 ? "\xE2\x9C\x93" : "x");
+    }
+    CheckSanitized(text, 0);
+    CheckSanitized(text, 100);
+    CheckSanitized(text, 1000);
+    CheckSanitized(std::string(100000, 'a'), 0);
+    CheckSanitized(std::string(100000, 'a'), 50000);
+    CheckSanitized(std::string(100000, '\x80'), 0);
+}
+
+// Appends a random piece: ASCII runs, valid sequences of every length, invalid bytes or broken sequences.
+static void AppendRandomPiece(std::mt19937 &random, std::string &text) {
+    static const char *validSequences[] = {"\xC2\x80", "\xDF\xBF", "\xE0\xA0\x80", "\xE2\x9C\x93", "\xED\x9F\xBF", "\xEE\x80\x80", "\xEF\xBF\xBD", "\xF0\x90\x80\x80", "\xF0\x9D\x84\x9E", "\xF4\x8F\xBF\xBF"};
+    switch (random() % 6) {
+        case 0:
+        case 1: {
+            uint32_t length = random() % 20;
+            for (uint32_t i = 0; i < length; i++) {
+                text += (char) (0x20 + random() % 0x5F);
+            }
+            break;
+        }
+        case 2:
+            text += validSequences[random() % (sizeof(validSequences) / sizeof(validSequences[0]))];
+            break;
+        case 3: {
+            // A valid sequence with its end cut off.
+            std::string sequence = validSequences[random() % (sizeof(validSequences) / sizeof(validSequences[0]))];
+            text += sequence.substr(0, 1 + random() % (sequence.size() - 1));
+            break;
+        }
+        case 4:
+            // Any byte except NUL.
+            text += (char) (1 + random() % 255);
+            break;
+        case 5:
+            // Lead bytes and continuation bytes in any combination.
+            text += (char) (0x80 + random() % 0x80);
+            break;
+    }
+}
+
+static void TestFuzz() {
+    std::mt19937 random(FUZZ_SEED);
+    std::string text;
+    for (uint32_t i = 0; i < FUZZ_ITERATIONS; i++) {
+        text.clear();
+        uint32_t pieces = random() % 12;
+        for (uint32_t j = 0; j < pieces; j++) {
+            AppendRandomPiece(random, text);
+        }
+        uint32_t maxCodePoints = random() % 3 == 0 ? 0 : random() % 40;
+        CheckSanitized(text, maxCodePoints);
+
+        // The same text at every alignment, the ASCII fast path reads whole words.
+        if (i % 64 == 0) {
+            for (uint32_t offset = 1; offset < 8; offset++) {
+                std::string shifted = std::string(offset, ' ') + text;
+                CheckSanitized(shifted.substr(offset), maxCodePoints);
+                CheckSanitized(shifted, maxCodePoints);
+            }
+        }
+    }
+    TextSanitizer_SetMaxLength(0);
+}
+
+// The sanitizer is applied to the texts that reach the module.
+static void TestTextsReachingModule() {
+    InitLibrary();
+    TextSanitizer_SetMaxLength(0);
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddInfoNotification("bad \xFF byte"));
+    CHECK(StandIn_FindNotification("bad \xEF\xBF\xBD byte", nullptr));
+
+    NotificationModuleHandle handle;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotification("dynamic", &handle));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_UpdateDynamicNotificationText(handle, "cut \xE2\x9C"));
+    CHECK(StandIn_FindNotification("cut \xEF\xBF\xBD\xEF\xBF\xBD", nullptr));
+    NotificationModule_DeInitLibrary();
+}
+
+int main() {
+    printf("test_text_sanitizer\n");
+    RUN_TEST(TestFixedCases);
+    RUN_TEST(TestLongTexts);
+    RUN_TEST(TestFuzz);
+    RUN_TEST(TestTextsReachingModule);
+    return 0;
+}
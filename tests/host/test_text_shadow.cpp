@@ -0,0 +1,102 @@
+#include "test.h"
+
+#include <random>
+#include <string>
+
+// Text updates against a module with NMSpliceDynamicNotificationText. The stand-in rejects splices that cut a UTF-8
+// sequence, so every update has to arrive as a valid splice (or as the full text).
+
+static void CheckUpdate(const char *oldText, const char *newText) {
+    NotificationModuleHandle handle;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotification(oldText, &handle));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_UpdateDynamicNotificationText(handle, newText));
+    CHECK(StandIn_FindNotification(newText, nullptr));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_FinishDynamicNotification(handle, 0.0f));
+    StandIn_FadeOutAll();
+}
+
+static void TestSplicesAtCodePointEdges() {
+    StandInConfig config;
+    config.exports = STAND_IN_EXPORT_SPLICE;
+    InitLibrary(config);
+    // Different code points with the same lead byte (ä C3 A4, ö C3 B6) or the same last byte (ä C3 A4, Ĥ C4 A4).
+    CheckUpdate("Größe: ä", "Größe: ö");
+    CheckUpdate("ä: Größe", "Ĥ: Größe");
+    CheckUpdate("Grüße", "Größe");
+    // 3 and 4 byte sequences that only differ in the last byte (€ E2 82 AC, ₤ E2 82 A4, 🎮 F0 9F 8E AE, 🎯 F0 9F 8E AF).
+    CheckUpdate("1 €", "1 ₤");
+    CheckUpdate("€ 1", "₤ 1");
+    CheckUpdate("🎮 Player 1", "🎯 Player 1");
+    CheckUpdate("Player 1 🎮", "Player 1 🎯");
+    // Inserted or removed next to multibyte sequences.
+    CheckUpdate("日本", "日本語");
+    CheckUpdate("日本語", "日語");
+    CheckUpdate("x日", "日");
+    CheckUpdate("🎮 1%", "🎮 10%");
+    CheckUpdate("1% 🎮", "10% 🎮");
+    CHECK(StandIn_GetStats().invalidHandles == 0);
+    NotificationModule_DeInitLibrary();
+}
+
+// The final text of a long series of random updates matches, and splices copy fewer bytes than full texts.
+static void TestRandomSplices() {
+    static const char *symbols[] = {"a", "b", " ", "ä", "ö", "Ĥ", "€", "₤", "日", "🎮", "🎯"};
+    std::mt19937 random(1234);
+    std::string text = "start";
+
+    StandInConfig config;
+    config.exports = STAND_IN_EXPORT_SPLICE;
+    InitLibrary(config);
+    NotificationModuleHandle handle;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotification(text.c_str(), &handle));
+    StandIn_ResetStats();
+    uint64_t fullBytes = 0;
+    for (uint32_t i = 0; i < 2000; i++) {
+        // Change a few symbols in the middle, so there is a common prefix and suffix most of the time.
+        std::string next = text.substr(0, random() % (text.size() + 1));
+        while (!next.empty() && ((uint8_t) next.back() & 0xC0) == 0x80) {
+            next.pop_back();
+        }
+        if (!next.empty() && (uint8_t) next.back() >= 0xC0) {
+            next.pop_back();
+        }
+        for (uint32_t j = random() % 3; j > 0; j--) {
+            next += symbols[random() % (sizeof(symbols) / sizeof(symbols[0]))];
+        }
+        next += "|" + std::to_string(i % 7);
+        if (next == text) {
+            continue;
+        }
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_UpdateDynamicNotificationText(handle, next.c_str()));
+        text = next;
+        fullBytes += text.size() + 1;
+        StandInNotification notification;
+        CHECK(StandIn_FindNotification(text.c_str(), &notification));
+    }
+    auto stats = StandIn_GetStats();
+    CHECK(stats.invalidHandles == 0);
+    CHECK(stats.bytesCopied < fullBytes);
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_FinishDynamicNotification(handle, 0.0f));
+    NotificationModule_DeInitLibrary();
+}
+
+static void TestUnchangedTextIsSkipped() {
+    InitLibrary();
+    NotificationModuleHandle handle;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_AddDynamicNotification("Größe: 1 KB", &handle));
+    StandIn_ResetStats();
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_UpdateDynamicNotificationText(handle, "Größe: 1 KB"));
+    CHECK(StandIn_GetStats().moduleCalls == 0);
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_UpdateDynamicNotificationText(handle, "Größe: 2 KB"));
+    CHECK(StandIn_GetStats().moduleCalls == 1);
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_FinishDynamicNotification(handle, 0.0f));
+    NotificationModule_DeInitLibrary();
+}
+
+int main() {
+    printf("test_text_shadow\n");
+    RUN_TEST(TestSplicesAtCodePointEdges);
+    RUN_TEST(TestRandomSplices);
+    RUN_TEST(TestUnchangedTextIsSkipped);
+    return 0;
+}
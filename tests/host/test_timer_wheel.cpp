@@ -0,0 +1,358 @@
+#include "scheduler.h"
+#include "test.h"
+#include "timer_wheel.h"
+
+#include <atomic>
+#include <cstring>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+// The timer wheel with explicit times, and NotificationModule_ScheduleNotification with the manual clock of the stand-in.
+
+#define WHEEL_TICK_IN_US 1000
+#define FUZZ_NODES       512
+#define FUZZ_STEPS       4000
+// Tick of the scheduled notifications, see scheduled_notifications.cpp.
+#define SCHEDULE_TICK_IN_US 10000
+
+// Reference model of a node: the tick it has to expire at, or 0 if it's not scheduled.
+struct ModelNode {
+    TimerWheelNode node;
+    uint64_t expireAtTick = 0;
+};
+
+static void TestWheelBasics() {
+    TimerWheel wheel(WHEEL_TICK_IN_US);
+    std::vector<TimerWheelNode *> expired;
+    TimerWheelNode a, b;
+    CHECK(wheel.IsEmpty());
+    CHECK(!TimerWheel::IsScheduled(&a));
+
+    wheel.Schedule(&a, 5000, 0);
+    wheel.Schedule(&b, 5001, 0);
+    CHECK(!wheel.IsEmpty());
+    CHECK(TimerWheel::IsScheduled(&a));
+
+    // Deadlines are rounded up to the next tick.
+    wheel.Advance(4999, expired);
+    CHECK(expired.empty());
+    wheel.Advance(5000, expired);
+    CHECK(expired.size() == 1 && expired[0] == &a);
+    CHECK(!TimerWheel::IsScheduled(&a));
+    expired.clear();
+    wheel.Advance(5999, expired);
+    CHECK(expired.empty());
+    wheel.Advance(6000, expired);
+    CHECK(expired.size() == 1 && expired[0] == &b);
+    CHECK(wheel.IsEmpty());
+
+    // Deadlines in the past expire on the next tick.
+    expired.clear();
+    wheel.Schedule(&a, 1000, 10000);
+    wheel.Advance(10999, expired);
+    CHECK(expired.empty());
+    wheel.Advance(11000, expired);
+    CHECK(expired.size() == 1);
+
+    // Rescheduling moves the node, cancelling removes it, cancelling twice is fine.
+    expired.clear();
+    wheel.Schedule(&a, 20000, 11000);
+    wheel.Schedule(&a, 50000, 11000);
+    wheel.Schedule(&b, 30000, 11000);
+    wheel.Cancel(&b);
+    wheel.Cancel(&b);
+    wheel.Advance(49999, expired);
+    CHECK(expired.empty());
+    wheel.Advance(50000, expired);
+    CHECK(expired.size() == 1 && expired[0] == &a);
+
+    wheel.Schedule(&a, 60000, 50000);
+    wheel.Clear();
+    CHECK(wheel.IsEmpty());
+    CHECK(!TimerWheel::IsScheduled(&a));
+    expired.clear();
+    wheel.Advance(1000000, expired);
+    CHECK(expired.empty());
+}
+
+// Random schedules, reschedules, cancels and advances, from single ticks to beyond the range of the highest level.
+static void TestWheelAgainstModel() {
+    std::mt19937_64 random(37);
+    TimerWheel wheel(WHEEL_TICK_IN_US);
+    std::vector<ModelNode> nodes(FUZZ_NODES);
+    std::vector<TimerWheelNode *> expired;
+    uint64_t nowInUs      = 123456;
+    uint64_t currentTick  = 0;
+    uint32_t scheduled    = 0;
+    uint32_t expiredTotal = 0;
+
+    for (uint32_t step = 0; step < FUZZ_STEPS; step++) {
+        auto &model = nodes[random() % FUZZ_NODES];
+        switch (random() % 4) {
+            case 0:
+            case 1: {
+                // Delays from 0 to 2^26 ticks (the 4 levels cover 2^24 ticks), mostly short ones.
+                uint64_t delay    = (random() % (1ULL << (random() % 27))) * WHEEL_TICK_IN_US + random() % WHEEL_TICK_IN_US;
+                uint64_t deadline = random() % 16 == 0 ? nowInUs - std::min(nowInUs, delay) : nowInUs + delay;
+                if (scheduled == 0) {
+                    currentTick = nowInUs / WHEEL_TICK_IN_US;
+                }
+                if (model.expireAtTick == 0) {
+                    scheduled++;
+                }
+                uint64_t deadlineTick = (deadline + WHEEL_TICK_IN_US - 1) / WHEEL_TICK_IN_US;
+                model.expireAtTick    = std::max(deadlineTick, currentTick + 1);
+                wheel.Schedule(&model.node, deadline, nowInUs);
+                break;
+            }
+            case 2:
+                if (model.expireAtTick != 0) {
+                    scheduled--;
+                }
+                model.expireAtTick = 0;
+                wheel.Cancel(&model.node);
+                break;
+            case 3: {
+                nowInUs += (random() % (1ULL << (random() % 23))) * WHEEL_TICK_IN_US;
+                currentTick = std::max(currentTick, nowInUs / WHEEL_TICK_IN_US);
+                expired.clear();
+                wheel.Advance(nowInUs, expired);
+                std::set<TimerWheelNode *> actual(expired.begin(), expired.end());
+                CHECK(actual.size() == expired.size());
+                for (auto &cur : nodes) {
+                    bool shouldExpire = cur.expireAtTick != 0 && cur.expireAtTick <= currentTick;
+                    CHECK(actual.count(&cur.node) == (shouldExpire ? 1u : 0u));
+                    if (shouldExpire) {
+                        cur.expireAtTick = 0;
+                        scheduled--;
+                        expiredTotal++;
+                    }
+                }
+                break;
+            }
+        }
+        CHECK(wheel.IsEmpty() == (scheduled == 0));
+        // Sleeping for the wakeup delay never oversleeps the earliest deadline.
+        uint64_t earliestTick = UINT64_MAX;
+        for (auto &cur : nodes) {
+            if (cur.expireAtTick != 0) {
+                earliestTick = std::min(earliestTick, cur.expireAtTick);
+            }
+        }
+        if (earliestTick != UINT64_MAX) {
+            CHECK(nowInUs + wheel.GetNextWakeupDelayInUs(nowInUs) <= std::max(earliestTick * WHEEL_TICK_IN_US, nowInUs));
+        }
+    }
+    CHECK(expiredTotal > FUZZ_STEPS / 10);
+    // Long enough for parked nodes beyond the range of the highest level to be cascaded.
+    CHECK(nowInUs / WHEEL_TICK_IN_US > (1 << 24));
+}
+
+// Sleeping for GetNextWakeupDelayInUs never misses a deadline, and a far deadline only needs a few wakeups.
+static void TestWheelWakeups() {
+    TimerWheel wheel(WHEEL_TICK_IN_US);
+    std::vector<TimerWheelNode *> expired;
+    TimerWheelNode near, far;
+    wheel.Schedule(&near, 2500, 0);
+    wheel.Schedule(&far, 10000000, 0);
+
+    uint64_t nowInUs = 0;
+    uint32_t wakeups = 0;
+    while (!wheel.IsEmpty()) {
+        uint32_t delay = wheel.GetNextWakeupDelayInUs(nowInUs);
+        CHECK(delay > 0);
+        nowInUs += delay;
+        wakeups++;
+        expired.clear();
+        wheel.Advance(nowInUs, expired);
+        for (auto *node : expired) {
+            CHECK(nowInUs == (node == &near ? 3000u : 10000000u));
+        }
+    }
+    // One wakeup per cascade of a level on the way down, not one per block of 64 ticks.
+    printf("    %u wakeups for a deadline of 10000 ticks\n", wakeups);
+    CHECK(wakeups <= 5);
+
+    // A scheduled notification an hour from now, with the tick of the scheduled notifications.
+    TimerWheel hourWheel(SCHEDULE_TICK_IN_US);
+    TimerWheelNode hour;
+    uint64_t startInUs = 1234567;
+    hourWheel.Schedule(&hour, startInUs + 3600000000ull, startInUs);
+    nowInUs = startInUs;
+    wakeups = 0;
+    while (!hourWheel.IsEmpty()) {
+        nowInUs += hourWheel.GetNextWakeupDelayInUs(nowInUs);
+        wakeups++;
+        expired.clear();
+        hourWheel.Advance(nowInUs, expired);
+    }
+    printf("    %u wakeups for a deadline in an hour\n", wakeups);
+    CHECK(nowInUs == startInUs + 3600000000ull + (SCHEDULE_TICK_IN_US - startInUs % SCHEDULE_TICK_IN_US));
+    CHECK(wakeups <= 5);
+}
+
+static uint32_t SetFlagTask(void *context, uint64_t) {
+    ((std::atomic<bool> *) context)->store(true);
+    return 0;
+}
+
+// Advances the manual clock and waits until the scheduler thread has run everything that is due.
+static void AdvanceClock(uint64_t microseconds) {
+    StandIn_AdvanceClock(microseconds);
+    // The scheduler thread waits in real time, adding a task wakes it up. Due tasks run in order of their deadline.
+    std::atomic<bool> ran{false};
+    CHECK(Scheduler_AddTask(SetFlagTask, &ran, 0) != 0);
+    CHECK(WaitUntil([&ran] { return ran.load(); }));
+}
+
+static NMNotificationDesc MakeDesc(const char *text) {
+    NMNotificationDesc desc;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_InitNotificationDesc(NOTIFICATION_MODULE_NOTIFICATION_TYPE_INFO, &desc));
+    desc.text = text;
+    return desc;
+}
+
+static void InitWithManualClock() {
+    StandInConfig config;
+    config.manualClock = true;
+    InitLibrary(config);
+}
+
+static void TestScheduledNotificationIsShownAfterDelay() {
+    InitWithManualClock();
+    // The text is copied.
+    char text[] = "Still working...";
+    auto desc   = MakeDesc(text);
+    NMScheduleHandle handle;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_ScheduleNotification(&desc, 5000000, &handle));
+    CHECK(handle != NM_SCHEDULE_HANDLE_INVALID);
+    strcpy(text, "Overwritten");
+
+    AdvanceClock(4990000);
+    CHECK(StandIn_GetNotifications().empty());
+    AdvanceClock(9999);
+    CHECK(StandIn_GetNotifications().empty());
+    AdvanceClock(1);
+    CHECK(StandIn_FindNotification("Still working...", nullptr));
+    CHECK(StandIn_GetNotifications().size() == 1);
+
+    // Shown notifications can't be cancelled anymore.
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_INVALID_HANDLE, NotificationModule_CancelScheduled(handle));
+    NotificationModule_DeInitLibrary();
+}
+
+static void TestCancelledNotificationIsNotShown() {
+    InitWithManualClock();
+    auto desc = MakeDesc("Cancelled");
+    NMScheduleHandle handle;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_ScheduleNotification(&desc, 1000000, &handle));
+    AdvanceClock(500000);
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_CancelScheduled(handle));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_INVALID_HANDLE, NotificationModule_CancelScheduled(handle));
+
+    // The slot is reused, the old handle stays invalid.
+    desc = MakeDesc("Reused");
+    NMScheduleHandle newHandle;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_ScheduleNotification(&desc, 1000000, &newHandle));
+    CHECK(newHandle != handle);
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_INVALID_HANDLE, NotificationModule_CancelScheduled(handle));
+
+    AdvanceClock(2000000);
+    CHECK(!StandIn_FindNotification("Cancelled", nullptr));
+    CHECK(StandIn_FindNotification("Reused", nullptr));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT, NotificationModule_CancelScheduled(NM_SCHEDULE_HANDLE_INVALID));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_INVALID_HANDLE, NotificationModule_CancelScheduled(0x1234FFFF));
+    NotificationModule_DeInitLibrary();
+}
+
+static void TestManyScheduledNotifications() {
+    InitWithManualClock();
+    std::mt19937 random(5);
+    std::map<std::string, uint64_t> expected; // text -> delay
+    char text[16];
+    for (uint32_t i = 0; i < 1000; i++) {
+        snprintf(text, sizeof(text), "n%u", i);
+        uint64_t delay = (random() % 100000) * 1000;
+        auto desc      = MakeDesc(text);
+        NMScheduleHandle handle;
+        CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_ScheduleNotification(&desc, delay, &handle));
+        if (i % 3 == 0) {
+            CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_CancelScheduled(handle));
+        } else {
+            expected[text] = delay;
+        }
+    }
+
+    for (uint64_t elapsed = 0; elapsed <= 100000000; elapsed += 1000000) {
+        if (elapsed > 0) {
+            AdvanceClock(1000000);
+        }
+        std::set<std::string> shown;
+        for (const auto &cur : StandIn_GetNotifications()) {
+            CHECK(shown.insert(cur.text).second);
+        }
+        for (const auto &[cur, delay] : expected) {
+            // Delays are rounded up to the tick.
+            uint64_t dueAt = (delay + SCHEDULE_TICK_IN_US - 1) / SCHEDULE_TICK_IN_US * SCHEDULE_TICK_IN_US;
+            CHECK(shown.count(cur) == (dueAt <= elapsed ? 1u : 0u));
+        }
+    }
+    CHECK(StandIn_GetNotifications().size() == expected.size());
+    NotificationModule_DeInitLibrary();
+}
+
+static void TestScheduleArguments() {
+    auto desc = MakeDesc("Args");
+    NMScheduleHandle handle;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_LIB_UNINITIALIZED, NotificationModule_ScheduleNotification(&desc, 0, &handle));
+
+    InitWithManualClock();
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT, NotificationModule_ScheduleNotification(nullptr, 0, &handle));
+    desc.text = nullptr;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT, NotificationModule_ScheduleNotification(&desc, 0, &handle));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_InitNotificationDesc(NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC, &desc));
+    desc.text = "Dynamic";
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_UNSUPPORTED_TYPE, NotificationModule_ScheduleNotification(&desc, 0, &handle));
+    desc = MakeDesc("Too late");
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT, NotificationModule_ScheduleNotification(&desc, NM_SCHEDULE_MAX_DELAY_IN_US + 1, &handle));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_INVALID_ARGUMENT, NotificationModule_ScheduleNotification(&desc, (uint64_t) -1, &handle));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_ScheduleNotification(&desc, NM_SCHEDULE_MAX_DELAY_IN_US, &handle));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_CancelScheduled(handle));
+
+    // No delay, shown on the next tick. The handle is optional.
+    desc = MakeDesc("Now");
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_ScheduleNotification(&desc, 0, nullptr));
+    AdvanceClock(SCHEDULE_TICK_IN_US);
+    CHECK(StandIn_FindNotification("Now", nullptr));
+    NotificationModule_DeInitLibrary();
+}
+
+static void TestDeinitDropsScheduledNotifications() {
+    InitWithManualClock();
+    auto desc = MakeDesc("Dropped");
+    NMScheduleHandle handle;
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_ScheduleNotification(&desc, 1000000, &handle));
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_DeInitLibrary());
+
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_SUCCESS, NotificationModule_InitLibrary());
+    CHECK_STATUS(NOTIFICATION_MODULE_RESULT_INVALID_HANDLE, NotificationModule_CancelScheduled(handle));
+    AdvanceClock(2000000);
+    CHECK(StandIn_GetNotifications().empty());
+    NotificationModule_DeInitLibrary();
+}
+
+int main() {
+    printf("test_timer_wheel\n");
+    RUN_TEST(TestWheelBasics);
+    RUN_TEST(TestWheelAgainstModel);
+    RUN_TEST(TestWheelWakeups);
+    RUN_TEST(TestScheduledNotificationIsShownAfterDelay);
+    RUN_TEST(TestCancelledNotificationIsNotShown);
+    RUN_TEST(TestManyScheduledNotifications);
+    RUN_TEST(TestScheduleArguments);
+    RUN_TEST(TestDeinitDropsScheduledNotifications);
+    return 0;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <wut.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void OSReport(const char *fmt, ...);
+
+#ifdef __cplusplus
+}
+#endif
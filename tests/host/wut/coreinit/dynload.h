@@ -0,0 +1,30 @@
+#pragma once
+
+#include <wut.h>
+
+typedef void *OSDynLoad_Module;
+
+typedef enum OSDynLoad_Error {
+    OS_DYNLOAD_OK             = 0,
+    OS_DYNLOAD_INVALID_HANDLE = 0xBAD10001,
+    OS_DYNLOAD_NOT_FOUND      = 0xBAD10010,
+} OSDynLoad_Error;
+
+typedef enum OSDynLoad_ExportType {
+    OS_DYNLOAD_EXPORT_FUNC = 0,
+    OS_DYNLOAD_EXPORT_DATA = 1,
+} OSDynLoad_ExportType;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+OSDynLoad_Error OSDynLoad_Acquire(const char *name, OSDynLoad_Module *outModule);
+
+OSDynLoad_Error OSDynLoad_FindExport(OSDynLoad_Module module, OSDynLoad_ExportType exportType, const char *name, void **outAddr);
+
+void OSDynLoad_Release(OSDynLoad_Module module);
+
+#ifdef __cplusplus
+}
+#endif
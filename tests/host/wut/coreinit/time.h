@@ -0,0 +1,22 @@
+#pragma once
+
+#include <wut.h>
+
+typedef int64_t OSTime;
+
+// The system timer of the Wii U runs at 62.15625 MHz, the host stand-in uses 62 MHz.
+#define OSTicksToMicroseconds(val) ((val) / 62)
+#define OSMicrosecondsToTicks(val) ((val) * 62)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Implemented by the stand-in module, see StandIn_AdvanceClock().
+ */
+OSTime OSGetSystemTime();
+
+#ifdef __cplusplus
+}
+#endif
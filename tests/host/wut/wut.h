@@ -0,0 +1,10 @@
+#pragma once
+
+// Minimal replacement of the wut headers the library uses, so it can be built for the host.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define WUT_CHECK_SIZE(type, size)
+#define WUT_CHECK_OFFSET(type, offset, field)
+#define WUT_PACKED __attribute__((__packed__))
@@ -77,6 +77,15 @@ for std in "${CPP_FULL_CHECK_VERSIONS[@]}"; do
     run_check "TEST_FAIL_CALLBACK" "src_fail_cpp" "$std" "CXX"
     run_check "TEST_FAIL_CONTEXT"  "src_fail_cpp" "$std" "CXX"
     run_check "TEST_FAIL_BOOL"     "src_fail_cpp" "$std" "CXX"
+    run_check "TEST_FAIL_STRING"   "src_fail_cpp" "$std" "CXX"
+done
+
+# The format strings of notification_format.h are checked with consteval (C++20 and newer).
+CPP_FORMAT_CHECK_VERSIONS=("gnu++20" "gnu++23")
+
+for std in "${CPP_FORMAT_CHECK_VERSIONS[@]}"; do
+    run_check "TEST_FAIL_FORMAT_TYPE"  "src_fail_cpp" "$std" "CXX"
+    run_check "TEST_FAIL_FORMAT_COUNT" "src_fail_cpp" "$std" "CXX"
 done
 
 # ---------------------------------------------------------
@@ -87,13 +96,14 @@ C_FULL_CHECK_VERSIONS=("gnu11" "gnu17" "gnu18" "gnu2x")
 # C99 only supports built-in compatibility checks (Scalar only: float, bool)
 C_SCALAR_CHECK_VERSIONS=("gnu99")
 
-# 1. Full Checks (Color, Callback, Context) - C11+ Only
+# 1. Full Checks (Color, Callback, Context, String) - C11+ Only
 for std in "${C_FULL_CHECK_VERSIONS[@]}"; do
     run_check "TEST_FAIL_COLOR"    "src_fail_c" "$std" "C"
     run_check "TEST_FAIL_CALLBACK" "src_fail_c" "$std" "C"
     run_check "TEST_FAIL_CONTEXT"  "src_fail_c" "$std" "C"
 	run_check "TEST_FAIL_DURATION" "src_fail_c" "$std" "C"
     run_check "TEST_FAIL_BOOL"     "src_fail_c" "$std" "C"
+    run_check "TEST_FAIL_STRING"   "src_fail_c" "$std" "C"
 done
 
 # 2. Scalar Checks (Float, Bool) - C99+
@@ -47,6 +47,31 @@ int main(int argc, char **argv) {
         (void*) &ctx_data
     );
 
+    // Test 5: Inactivity timeout
+    NotificationModule_SetDefaultValue(
+        NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC,
+        NOTIFICATION_MODULE_DEFAULT_OPTION_INACTIVITY_TIMEOUT,
+        duration
+    );
+
+    // Test 6: Inactivity timeout text
+    NotificationModule_SetDefaultValue(
+        NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC,
+        NOTIFICATION_MODULE_DEFAULT_OPTION_INACTIVITY_TIMEOUT_TEXT,
+        "Timed out"
+    );
+
+    // Test 7: Context default value
+    NotificationModuleContextHandle context = NULL;
+    NotificationModule_CreateContext("CI Test", NULL, &context);
+    NotificationModule_SetContextDefaultValue(
+        context,
+        NOTIFICATION_MODULE_NOTIFICATION_TYPE_INFO,
+        NOTIFICATION_MODULE_DEFAULT_OPTION_BACKGROUND_COLOR,
+        color
+    );
+    NotificationModule_DestroyContext(context);
+
     NotificationModule_AddInfoNotification("C Compatibility Test");
 
     NotificationModule_DeInitLibrary();
@@ -1,5 +1,8 @@
 #include <coreinit/thread.h>
 #include <notifications/notifications.h>
+#if __cplusplus >= 202002L
+#include <notifications/notification_format.h>
+#endif
 
 // Dummy callback for testing
 void my_callback(NotificationModuleHandle h, void* ctx) {
@@ -58,9 +61,39 @@ int main(int argc, char **argv) {
         keep
     );
 
+    // Inactivity timeout
+    NotificationModule_SetDefaultValue(
+        NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC,
+        NOTIFICATION_MODULE_DEFAULT_OPTION_INACTIVITY_TIMEOUT,
+        duration
+    );
+
+    // Inactivity timeout text
+    NotificationModule_SetDefaultValue(
+        NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC,
+        NOTIFICATION_MODULE_DEFAULT_OPTION_INACTIVITY_TIMEOUT_TEXT,
+        "Timed out"
+    );
+
+    // Context default value
+    NotificationModuleContextHandle context = nullptr;
+    NotificationModule_CreateContext("CI Test", nullptr, &context);
+    NotificationModule_SetContextDefaultValue(
+        context,
+        NOTIFICATION_MODULE_NOTIFICATION_TYPE_INFO,
+        NOTIFICATION_MODULE_DEFAULT_OPTION_BACKGROUND_COLOR,
+        color
+    );
+    NotificationModule_DestroyContext(context);
+
     // 3. Test API usage
     NotificationModule_AddInfoNotification("CI Test: Build Successful!");
 
+#if __cplusplus >= 202002L
+    // Compile time checked format strings
+    NotificationModule_AddInfoNotificationFormatted("CI Test: %s %d/%u (%.1f%%) %x", "Build", -1, 2u, duration, 255);
+#endif
+
     // Deinit
     NotificationModule_DeInitLibrary();
     
@@ -75,6 +75,17 @@ int main(int argc, char **argv) {
         );
     #endif
 
+    // ---------------------------------------------------------
+    // TEST CASE: FAIL_STRING
+    // ---------------------------------------------------------
+    #ifdef TEST_FAIL_STRING
+        NotificationModule_SetDefaultValue(
+            NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC,
+            NOTIFICATION_MODULE_DEFAULT_OPTION_INACTIVITY_TIMEOUT_TEXT,
+            ARG("Timed out", 2.5f)
+        );
+    #endif
+
     NotificationModule_DeInitLibrary();
     return 0;
 }
\ No newline at end of file
@@ -1,4 +1,7 @@
 #include <notifications/notifications.h>
+#if __cplusplus >= 202002L
+#include <notifications/notification_format.h>
+#endif
 
 // Helper macros to switch between Valid and Invalid data
 #ifdef MAKE_VALID
@@ -75,6 +78,38 @@ int main(int argc, char **argv) {
         );
     #endif
 
+    // ---------------------------------------------------------
+    // TEST CASE: FAIL_STRING (Inactivity Timeout Text)
+    // ---------------------------------------------------------
+    #ifdef TEST_FAIL_STRING
+        NotificationModule_SetDefaultValue(
+            NOTIFICATION_MODULE_NOTIFICATION_TYPE_DYNAMIC,
+            NOTIFICATION_MODULE_DEFAULT_OPTION_INACTIVITY_TIMEOUT_TEXT,
+            ARG("Timed out", 2.5f) // Invalid: float
+        );
+    #endif
+
+    // ---------------------------------------------------------
+    // TEST CASE: FAIL_FORMAT_TYPE (C++20 format string, placeholder type)
+    // ---------------------------------------------------------
+    #ifdef TEST_FAIL_FORMAT_TYPE
+        NotificationModule_AddInfoNotificationFormatted(
+            "Copied %d files",
+            ARG(12, "12") // Invalid: string for %d
+        );
+    #endif
+
+    // ---------------------------------------------------------
+    // TEST CASE: FAIL_FORMAT_COUNT (C++20 format string, argument count)
+    // ---------------------------------------------------------
+    #ifdef TEST_FAIL_FORMAT_COUNT
+        #ifdef MAKE_VALID
+            NotificationModule_AddInfoNotificationFormatted("Copied %u of %u files", 1u, 2u);
+        #else
+            NotificationModule_AddInfoNotificationFormatted("Copied %u of %u files", 1u); // Invalid: missing argument
+        #endif
+    #endif
+
     NotificationModule_DeInitLibrary();
     return 0;
 }
\ No newline at end of file
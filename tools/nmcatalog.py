@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+"""
+Creates a binary message catalog for NotificationModule_OpenCatalog().
+
+Input is a UTF-8 text file with one entry per line:
+
+    <id>=<text>
+
+Empty lines and lines starting with '#' are ignored. `\\n` and `\\\\` can be used
+inside texts. Ids are decimal (or hex with 0x prefix) and have to be unique.
+
+Catalog layout (all values big endian):
+    header:  magic "NMCT", u32 version (1), u32 count, u32 blobSize
+    index:   count x (u32 id, u32 offset into blob), sorted by id
+    blob:    zero terminated texts
+"""
+
+import argparse
+import struct
+import sys
+
+CATALOG_MAGIC = b"NMCT"
+CATALOG_VERSION = 1
+
+
+def unescape(text):
+    res = []
+    i = 0
+    while i < len(text):
+        c = text[i]
+        if c == "\\" and i + 1 < len(text):
+            n = text[i + 1]
+            if n == "n":
+                res.append("\n")
+                i += 2
+                continue
+            if n == "\\":
+                res.append("\\")
+                i += 2
+                continue
+        res.append(c)
+        i += 1
+    return "".join(res)
+
+
+def parse(path):
+    entries = {}
+    with open(path, "r", encoding="utf-8") as f:
+        for lineNumber, line in enumerate(f, 1):
+            line = line.rstrip("\r\n")
+            if not line.strip() or line.lstrip().startswith("#"):
+                continue
+            if "=" not in line:
+                sys.exit("%s:%d: expected <id>=<text>" % (path, lineNumber))
+            key, text = line.split("=", 1)
+            textId = int(key.strip(), 0)
+            if textId < 0 or textId > 0xFFFFFFFF:
+                sys.exit("%s:%d: id out of range" % (path, lineNumber))
+            if textId in entries:
+                sys.exit("%s:%d: duplicate id %d" % (path, lineNumber, textId))
+            entries[textId] = unescape(text)
+    return entries
+
+
+def build(entries):
+    index = bytearray()
+    blob = bytearray()
+    offsets = {}
+    for textId in sorted(entries):
+        data = entries[textId].encode("utf-8")
+        if b"\0" in data:
+            sys.exit("text for id %d contains a NUL character" % textId)
+        # identical texts share the same blob entry
+        if data not in offsets:
+            offsets[data] = len(blob)
+            blob += data + b"\0"
+        index += struct.pack(">II", textId, offsets[data])
+    header = CATALOG_MAGIC + struct.pack(">III", CATALOG_VERSION, len(entries), len(blob))
+    return header + index + blob
+
+
+def dump(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:4] != CATALOG_MAGIC:
+        sys.exit("%s is not a catalog" % path)
+    version, count, blobSize = struct.unpack_from(">III", data, 4)
+    blobStart = 16 + count * 8
+    for i in range(count):
+        textId, offset = struct.unpack_from(">II", data, 16 + i * 8)
+        end = data.index(b"\0", blobStart + offset)
+        text = data[blobStart + offset:end].decode("utf-8")
+        print("%d=%s" % (textId, text.replace("\\", "\\\\").replace("\n", "\\n")))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Create or dump libnotifications message catalogs.")
+    parser.add_argument("input", help="text file (or catalog when using --dump)")
+    parser.add_argument("output", nargs="?", help="catalog file that will be created")
+    parser.add_argument("--dump", action="store_true", help="print the content of a catalog")
+    args = parser.parse_args()
+
+    if args.dump:
+        dump(args.input)
+        return
+    if not args.output:
+        parser.error("output is required")
+    with open(args.output, "wb") as f:
+        f.write(build(parse(args.input)))
+
+
+if __name__ == "__main__":
+    main()
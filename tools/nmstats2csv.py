@@ -0,0 +1,134 @@
+#!/usr/bin/env python3
+"""
+Converts a statistics file written by NotificationModule_StartStatsExport() to CSV.
+
+File layout (all values big endian). Every export starts with a header, so a file
+can contain several exports (e.g. one per application start):
+    header:  magic "NMSH", u16 version (1), u16 numStatus, u16 numBuckets,
+             u16 reserved, u32 intervalInUs,
+             numStatus x i32 status code, numBuckets x u32 bucket upper bound in us
+    record:  magic "NMSR", u64 timestampInUs, u32 calls, u32 failures,
+             u32 suppressed, u32 coalesced,
+             numStatus x u32 calls per status, numBuckets x u32 calls per latency bucket
+
+All counters are cumulative since the library has been initialized. Use --delta
+to get the change since the previous record of the same export instead.
+"""
+
+import argparse
+import csv
+import struct
+import sys
+
+HEADER_MAGIC = b"NMSH"
+RECORD_MAGIC = b"NMSR"
+STATS_VERSION = 1
+
+STATUS_NAMES = {
+    0: "SUCCESS",
+    -0x1: "MODULE_NOT_FOUND",
+    -0x2: "MODULE_MISSING_EXPORT",
+    -0x3: "UNSUPPORTED_VERSION",
+    -0x4: "INVALID_ARGUMENT",
+    -0x5: "LIB_UNINITIALIZED",
+    -0x6: "UNSUPPORTED_COMMAND",
+    -0x10: "OVERLAY_NOT_READY",
+    -0x11: "UNSUPPORTED_TYPE",
+    -0x12: "ALLOCATION_FAILED",
+    -0x13: "INVALID_HANDLE",
+    -0x14: "QUOTA_EXCEEDED",
+    -0x1000: "UNKNOWN_ERROR",
+}
+
+
+def bucket_name(lower, upper):
+    if upper == 0xFFFFFFFF:
+        return "latency_ge_%dus" % lower
+    return "latency_lt_%dus" % upper
+
+
+def read_exports(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    exports = []
+    offset = 0
+    while offset < len(data):
+        magic = data[offset:offset + 4]
+        if magic == HEADER_MAGIC:
+            if offset + 16 > len(data):
+                break
+            version, numStatus, numBuckets, _, intervalInUs = struct.unpack_from(">HHHHI", data, offset + 4)
+            if version != STATS_VERSION:
+                sys.exit("%s: unsupported version %d at offset %d" % (path, version, offset))
+            offset += 16
+            if offset + (numStatus + numBuckets) * 4 > len(data):
+                break
+            statusCodes = struct.unpack_from(">%di" % numStatus, data, offset)
+            offset += numStatus * 4
+            bucketLimits = struct.unpack_from(">%dI" % numBuckets, data, offset)
+            offset += numBuckets * 4
+            exports.append({"intervalInUs": intervalInUs, "statusCodes": statusCodes, "bucketLimits": bucketLimits, "records": []})
+        elif magic == RECORD_MAGIC:
+            if not exports:
+                sys.exit("%s: record without header at offset %d" % (path, offset))
+            cur = exports[-1]
+            numValues = 4 + len(cur["statusCodes"]) + len(cur["bucketLimits"])
+            size = 12 + numValues * 4
+            if offset + size > len(data):
+                break
+            timestamp, = struct.unpack_from(">Q", data, offset + 4)
+            values = struct.unpack_from(">%dI" % numValues, data, offset + 12)
+            cur["records"].append((timestamp, values))
+            offset += size
+        else:
+            sys.exit("%s: unexpected data at offset %d" % (path, offset))
+    if offset < len(data):
+        # The last chunk may be incomplete if the application has been killed while writing.
+        print("%s: ignoring %d trailing bytes" % (path, len(data) - offset), file=sys.stderr)
+    return exports
+
+
+def columns(export):
+    res = ["calls", "failures", "suppressed", "coalesced"]
+    res += ["status_%s" % STATUS_NAMES.get(code, str(code)) for code in export["statusCodes"]]
+    lower = 0
+    for upper in export["bucketLimits"]:
+        res.append(bucket_name(lower, upper))
+        lower = upper
+    return res
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert libnotifications statistics files to CSV.")
+    parser.add_argument("input", help="statistics file")
+    parser.add_argument("output", nargs="?", help="CSV file that will be created (default: stdout)")
+    parser.add_argument("--delta", action="store_true", help="write the change since the previous record instead of the totals")
+    args = parser.parse_args()
+
+    exports = read_exports(args.input)
+    header = None
+    out = open(args.output, "w", newline="") if args.output else sys.stdout
+    try:
+        writer = csv.writer(out)
+        for exportIndex, export in enumerate(exports):
+            names = columns(export)
+            if header is None:
+                header = names
+                writer.writerow(["export", "timestamp_us"] + header)
+            elif names != header:
+                sys.exit("%s: export %d has different columns" % (args.input, exportIndex))
+            previous = None
+            for timestamp, values in export["records"]:
+                row = values
+                if args.delta:
+                    # The counters are 32 bit and may wrap around.
+                    row = [(v - p) & 0xFFFFFFFF for v, p in zip(values, previous)] if previous else [0] * len(values)
+                    previous = values
+                writer.writerow([exportIndex, timestamp] + list(row))
+    finally:
+        if out is not sys.stdout:
+            out.close()
+
+
+if __name__ == "__main__":
+    main()